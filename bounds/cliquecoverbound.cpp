@@ -0,0 +1,203 @@
+#include "cliquecoverbound.h"
+
+#include <algorithm>
+#include <set>
+#include <tuple>
+#include <unordered_map>
+
+namespace {
+
+/* Start or end of a presence of POI a, or of a conflict between POIs a and b */
+struct BoundEvent {
+  double pos;
+  bool conflict;
+  int delta;
+  int a;
+  int b;
+};
+
+}
+
+CliqueCoverBound::CliqueCoverBound(const ExpandedConflictGraph &g, int k):
+  graph(g), k(k), cliqueCount(0)
+{
+}
+
+const std::vector<double> &
+CliqueCoverBound::getCoordinates() const
+{
+  return this->coordinates;
+}
+
+const std::vector<size_t> &
+CliqueCoverBound::getCoverSizes() const
+{
+  return this->coverSizes;
+}
+
+size_t
+CliqueCoverBound::getCliqueCount() const
+{
+  return this->cliqueCount;
+}
+
+const std::vector<int> &
+CliqueCoverBound::getVertexPois() const
+{
+  return this->vertexPois;
+}
+
+const std::vector<std::vector<CliqueCoverBound::Membership>> &
+CliqueCoverBound::getMemberships() const
+{
+  return this->memberships;
+}
+
+void
+CliqueCoverBound::run()
+{
+  const ExpandedConflictGraph &g = this->graph;
+
+  std::unordered_map<POI *, int> pois;
+  std::vector<BoundEvent> events;
+  this->vertexPois.assign(boost::num_vertices(g), -1);
+
+  auto vs = boost::vertices(g);
+  for (auto vit = vs.first; vit != vs.second; ++vit) {
+    int poi = pois.insert({g[*vit].poi, (int)pois.size()}).first->second;
+    this->vertexPois[*vit] = poi;
+
+    double start = bg::get<0>(g[*vit].interval.first);
+    double end = bg::get<0>(g[*vit].interval.second);
+    if (start < end) {
+      events.push_back({start, false, 1, poi, -1});
+      events.push_back({end, false, -1, poi, -1});
+    }
+  }
+
+  /* Every conflict is attached to all pairs of affected vertices, only count it once */
+  std::set<std::tuple<int, int, double, double>> conflicts;
+  auto es = boost::edges(g);
+  for (auto eit = es.first; eit != es.second; ++eit) {
+    if (!g[*eit].conflict_edge) {
+      continue;
+    }
+    int a = this->vertexPois[boost::source(*eit, g)];
+    int b = this->vertexPois[boost::target(*eit, g)];
+    if (a > b) {
+      std::swap(a, b);
+    }
+    for (const Interval &interval : g[*eit].intervals) {
+      double start = bg::get<0>(interval.first);
+      double end = bg::get<0>(interval.second);
+      if ((start < end) && conflicts.insert(std::make_tuple(a, b, start, end)).second) {
+        events.push_back({start, true, 1, a, b});
+        events.push_back({end, true, -1, a, b});
+      }
+    }
+  }
+
+  std::sort(events.begin(), events.end(), [](const BoundEvent &e1, const BoundEvent &e2) {
+    return e1.pos < e2.pos;
+  });
+
+  std::vector<int> coverage(pois.size(), 0);
+  // number of currently active conflicts between two POIs
+  std::vector<std::unordered_map<int, int>> conflicting(pois.size());
+
+  // POIs that can currently be displayed, and their position in active
+  std::vector<int> active;
+  std::vector<size_t> position(pois.size(), 0);
+  std::vector<int> order;
+  std::vector<int> degree(pois.size(), 0);
+  std::vector<std::vector<int>> cliques;
+
+  this->coordinates.clear();
+  this->coverSizes.clear();
+  this->cliqueCount = 0;
+  this->memberships.assign(pois.size(), std::vector<Membership>());
+  this->bound = 0;
+
+  for (size_t i = 0; i < events.size(); ) {
+    double pos = events[i].pos;
+    for (; (i < events.size()) && (events[i].pos == pos); ++i) {
+      const BoundEvent &event = events[i];
+      if (event.conflict) {
+        int &count1 = conflicting[event.a][event.b];
+        int &count2 = conflicting[event.b][event.a];
+        count1 += event.delta;
+        count2 += event.delta;
+        if (count1 == 0) {
+          conflicting[event.a].erase(event.b);
+          conflicting[event.b].erase(event.a);
+        }
+      } else {
+        coverage[event.a] += event.delta;
+        if ((event.delta > 0) && (coverage[event.a] == 1)) {
+          position[event.a] = active.size();
+          active.push_back(event.a);
+        } else if (coverage[event.a] == 0) {
+          int last = active.back();
+          active[position[event.a]] = last;
+          position[last] = position[event.a];
+          active.pop_back();
+        }
+      }
+    }
+
+    this->coordinates.push_back(pos);
+    if (i == events.size()) {
+      break;
+    }
+    size_t segment = this->coverSizes.size();
+    double length = events[i].pos - pos;
+
+    order = active;
+    for (int poi : order) {
+      degree[poi] = 0;
+      for (const auto &entry : conflicting[poi]) {
+        if (coverage[entry.first] > 0) {
+          degree[poi]++;
+        }
+      }
+    }
+    std::sort(order.begin(), order.end(), [&degree](int p1, int p2) {
+      return degree[p1] > degree[p2] || (degree[p1] == degree[p2] && p1 < p2);
+    });
+
+    /* Greedy clique cover: put every POI into the first clique it is adjacent to entirely */
+    cliques.clear();
+    for (int poi : order) {
+      size_t clique = 0;
+      if (degree[poi] > 0) {
+        for (; clique < cliques.size(); ++clique) {
+          bool adjacent = true;
+          for (int member : cliques[clique]) {
+            if (conflicting[poi].find(member) == conflicting[poi].end()) {
+              adjacent = false;
+              break;
+            }
+          }
+          if (adjacent) {
+            break;
+          }
+        }
+      } else {
+        clique = cliques.size();
+      }
+      if (clique == cliques.size()) {
+        cliques.push_back(std::vector<int>());
+      }
+      cliques[clique].push_back(poi);
+      this->memberships[poi].push_back({segment, this->cliqueCount + clique});
+    }
+    this->cliqueCount += cliques.size();
+    this->coverSizes.push_back(cliques.size());
+
+    if ((this->k > 0) && (cliques.size() > (size_t)this->k)) {
+      this->bound += length * this->k;
+    } else {
+      this->bound += length * cliques.size();
+    }
+  }
+}
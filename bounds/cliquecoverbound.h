@@ -0,0 +1,55 @@
+#ifndef CLIQUECOVERBOUND_H
+#define CLIQUECOVERBOUND_H
+
+#include "upperbound.h"
+#include "conflicts/conflictgraph.h"
+
+#include <vector>
+
+/**
+ * Splits the trajectory into the elementary segments between all presence and conflict
+ * end points. Within a segment, the labels that are displayed form an independent set of the
+ * POIs that can be displayed there, with respect to the conflicts active in the segment. Thus,
+ * the number of labels displayed in a segment is at most the size of any clique cover of these
+ * POIs, and at most k. The bound is the sum over all segments of the segment length times the
+ * smaller of the two. The clique covers are computed greedily.
+ *
+ * The argument only uses that two selected presences must not share a point in time with one of
+ * their conflicts, so the bound holds for AM1, AM2 and AM3 alike. Computing it on the graph of
+ * the respective model still gives the tighter bound, since fewer POIs can be displayed per
+ * segment (e.g., presences shorter than MINIMUM_SELECTION_LENGTH have no vertex).
+ */
+class CliqueCoverBound : public UpperBound {
+public:
+  CliqueCoverBound(const ExpandedConflictGraph &g, int k = -1);
+  void run();
+
+  /* The cover computed by run(), used by LagrangianBound to start from this bound.
+   * Segment s spans from getCoordinates()[s] to getCoordinates()[s + 1]. Cliques are
+   * numbered over all segments. */
+  struct Membership {
+    size_t segment;
+    size_t clique;
+  };
+
+  const std::vector<double> &getCoordinates() const;
+  // the number of cliques in the cover of each segment
+  const std::vector<size_t> &getCoverSizes() const;
+  size_t getCliqueCount() const;
+  // dense POI index of every vertex
+  const std::vector<int> &getVertexPois() const;
+  // per POI, the cliques it belongs to, ordered by segment
+  const std::vector<std::vector<Membership>> &getMemberships() const;
+
+private:
+  const ExpandedConflictGraph &graph;
+  int k;
+
+  std::vector<double> coordinates;
+  std::vector<size_t> coverSizes;
+  size_t cliqueCount;
+  std::vector<int> vertexPois;
+  std::vector<std::vector<Membership>> memberships;
+};
+
+#endif // CLIQUECOVERBOUND_H
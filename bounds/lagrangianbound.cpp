@@ -0,0 +1,295 @@
+#include "lagrangianbound.h"
+
+#include <algorithm>
+#include <map>
+#include <tuple>
+
+LagrangianBound::LagrangianBound(const ExpandedConflictGraph &g, int k, double lowerBound, int iterations):
+  graph(g), k(k), lowerBound(lowerBound), iterations(iterations)
+{
+}
+
+double
+LagrangianBound::getLowerBound() const
+{
+  return this->lowerBound;
+}
+
+void
+LagrangianBound::setup()
+{
+  const ExpandedConflictGraph &g = this->graph;
+  size_t n = boost::num_vertices(g);
+
+  CliqueCoverBound cover(g, this->k);
+  cover.run();
+
+  const std::vector<double> &coordinates = cover.getCoordinates();
+  size_t segments = cover.getCoverSizes().size();
+  this->segmentLengths.resize(segments);
+  this->kConstrained.assign(segments, false);
+  for (size_t s = 0; s < segments; ++s) {
+    this->segmentLengths[s] = coordinates[s + 1] - coordinates[s];
+    this->kConstrained[s] = (this->k > 0) && (cover.getCoverSizes()[s] > (size_t)this->k);
+  }
+  this->vertexPois = cover.getVertexPois();
+  this->memberships = cover.getMemberships();
+
+  /* Start at the clique cover bound: a segment contributes either by its cliques or,
+   * if there are more than k of them, by its k-restriction */
+  this->cliqueMultipliers.assign(cover.getCliqueCount(), 0);
+  this->kMultipliers.assign(segments, 0);
+  for (const std::vector<CliqueCoverBound::Membership> &poiMemberships : this->memberships) {
+    for (const CliqueCoverBound::Membership &membership : poiMemberships) {
+      if (this->kConstrained[membership.segment]) {
+        this->kMultipliers[membership.segment] = this->segmentLengths[membership.segment];
+      } else {
+        this->cliqueMultipliers[membership.clique] = this->segmentLengths[membership.segment];
+      }
+    }
+  }
+  this->prefix.resize(this->memberships.size());
+  this->cliqueGradient.resize(this->cliqueMultipliers.size());
+  this->kGradient.resize(segments);
+
+  this->firstSegment.resize(n);
+  this->lastSegment.resize(n);
+  this->firstMembership.resize(n);
+  this->lastMembership.resize(n);
+  auto bySegment = [](const CliqueCoverBound::Membership &membership, size_t segment) {
+    return membership.segment < segment;
+  };
+
+  /* Vertices of the same presence form a clique and are kept in the subproblems */
+  std::map<std::tuple<POI *, double, double>, size_t> presenceIds;
+  this->presences.clear();
+  auto vs = boost::vertices(g);
+  for (auto vit = vs.first; vit != vs.second; ++vit) {
+    const Interval &visibility = g[*vit].origVisibility;
+    auto key = std::make_tuple(g[*vit].poi, bg::get<0>(visibility.first), bg::get<0>(visibility.second));
+    auto it = presenceIds.insert({key, this->presences.size()}).first;
+    if (it->second == this->presences.size()) {
+      this->presences.push_back(std::vector<vertex_t>());
+    }
+    this->presences[it->second].push_back(*vit);
+
+    // all interval end points are segment boundaries
+    double start = bg::get<0>(g[*vit].interval.first);
+    double end = bg::get<0>(g[*vit].interval.second);
+    this->firstSegment[*vit] = std::lower_bound(coordinates.begin(), coordinates.end(), start) - coordinates.begin();
+    this->lastSegment[*vit] = std::max(this->firstSegment[*vit], (size_t)(std::lower_bound(coordinates.begin(), coordinates.end(), end) - coordinates.begin()));
+
+    const std::vector<CliqueCoverBound::Membership> &poiMemberships = this->memberships[this->vertexPois[*vit]];
+    this->firstMembership[*vit] = std::lower_bound(poiMemberships.begin(), poiMemberships.end(), this->firstSegment[*vit], bySegment) - poiMemberships.begin();
+    this->lastMembership[*vit] = std::lower_bound(poiMemberships.begin(), poiMemberships.end(), this->lastSegment[*vit], bySegment) - poiMemberships.begin();
+  }
+
+  this->conflicts.clear();
+  this->incident.assign(n, std::vector<size_t>());
+  auto es = boost::edges(g);
+  for (auto eit = es.first; eit != es.second; ++eit) {
+    if (g[*eit].conflict_edge) {
+      vertex_t u = boost::source(*eit, g);
+      vertex_t v = boost::target(*eit, g);
+      this->incident[u].push_back(this->conflicts.size());
+      this->incident[v].push_back(this->conflicts.size());
+      this->conflicts.push_back({u, v});
+    }
+  }
+  this->edgeMultipliers.assign(this->conflicts.size(), 0);
+  this->edgeGradient.resize(this->conflicts.size());
+
+  this->reduced.assign(n, 0);
+  this->selected.assign(n, false);
+}
+
+void
+LagrangianBound::run()
+{
+  this->setup();
+
+  double best = std::numeric_limits<double>::infinity();
+  double mu = 2;
+  int stall = 0;
+
+  for (int iteration = 0; iteration < this->iterations; ++iteration) {
+    double value = this->solveRelaxation();
+    if (value < best - 1e-9) {
+      best = value;
+      stall = 0;
+    } else if (++stall >= 20) {
+      mu /= 2;
+      stall = 0;
+    }
+
+    this->lowerBound = std::max(this->lowerBound, this->repair());
+    if ((best - this->lowerBound <= 1e-6 * std::max(1.0, best)) || (mu < 1e-4)) {
+      break;
+    }
+
+    double norm = this->computeSubgradient();
+    if (norm == 0) {
+      break;
+    }
+
+    double step = mu * std::max(value - this->lowerBound, 0.0) / norm;
+    for (size_t c = 0; c < this->cliqueMultipliers.size(); ++c) {
+      this->cliqueMultipliers[c] = std::max(0.0, this->cliqueMultipliers[c] - step * this->cliqueGradient[c]);
+    }
+    for (size_t s = 0; s < this->kMultipliers.size(); ++s) {
+      if (this->kConstrained[s]) {
+        this->kMultipliers[s] = std::max(0.0, this->kMultipliers[s] - step * this->kGradient[s]);
+      }
+    }
+    for (size_t e = 0; e < this->edgeMultipliers.size(); ++e) {
+      this->edgeMultipliers[e] = std::max(0.0, this->edgeMultipliers[e] - step * this->edgeGradient[e]);
+    }
+  }
+
+  this->bound = best;
+}
+
+double
+LagrangianBound::solveRelaxation()
+{
+  const ExpandedConflictGraph &g = this->graph;
+
+  double value = 0;
+  for (double multiplier : this->cliqueMultipliers) {
+    value += multiplier;
+  }
+  for (size_t s = 0; s < this->kMultipliers.size(); ++s) {
+    if (this->kConstrained[s]) {
+      value += this->k * this->kMultipliers[s];
+    }
+  }
+  for (double multiplier : this->edgeMultipliers) {
+    value += multiplier;
+  }
+
+  for (size_t poi = 0; poi < this->memberships.size(); ++poi) {
+    const std::vector<CliqueCoverBound::Membership> &poiMemberships = this->memberships[poi];
+    std::vector<double> &sums = this->prefix[poi];
+    sums.resize(poiMemberships.size() + 1);
+    sums[0] = 0;
+    for (size_t i = 0; i < poiMemberships.size(); ++i) {
+      sums[i + 1] = sums[i] + this->cliqueMultipliers[poiMemberships[i].clique] + this->kMultipliers[poiMemberships[i].segment];
+    }
+  }
+
+  auto vs = boost::vertices(g);
+  for (auto vit = vs.first; vit != vs.second; ++vit) {
+    const std::vector<double> &sums = this->prefix[this->vertexPois[*vit]];
+    this->reduced[*vit] = g[*vit].weight - (sums[this->lastMembership[*vit]] - sums[this->firstMembership[*vit]]);
+    this->selected[*vit] = false;
+  }
+  for (size_t e = 0; e < this->conflicts.size(); ++e) {
+    this->reduced[this->conflicts[e].first] -= this->edgeMultipliers[e];
+    this->reduced[this->conflicts[e].second] -= this->edgeMultipliers[e];
+  }
+
+  for (const std::vector<vertex_t> &presence : this->presences) {
+    vertex_t best = presence.front();
+    for (vertex_t v : presence) {
+      if (this->reduced[v] > this->reduced[best]) {
+        best = v;
+      }
+    }
+    if (this->reduced[best] > 0) {
+      this->selected[best] = true;
+      value += this->reduced[best];
+    }
+  }
+
+  return value;
+}
+
+double
+LagrangianBound::computeSubgradient()
+{
+  std::fill(this->cliqueGradient.begin(), this->cliqueGradient.end(), 1.0);
+  for (size_t s = 0; s < this->kGradient.size(); ++s) {
+    this->kGradient[s] = this->kConstrained[s] ? this->k : 0;
+  }
+  std::fill(this->edgeGradient.begin(), this->edgeGradient.end(), 1.0);
+
+  auto vs = boost::vertices(this->graph);
+  for (auto vit = vs.first; vit != vs.second; ++vit) {
+    if (!this->selected[*vit]) {
+      continue;
+    }
+    const std::vector<CliqueCoverBound::Membership> &poiMemberships = this->memberships[this->vertexPois[*vit]];
+    for (size_t i = this->firstMembership[*vit]; i < this->lastMembership[*vit]; ++i) {
+      this->cliqueGradient[poiMemberships[i].clique] -= 1;
+      this->kGradient[poiMemberships[i].segment] -= 1;
+    }
+    for (size_t e : this->incident[*vit]) {
+      this->edgeGradient[e] -= 1;
+    }
+  }
+
+  /* Multipliers that are zero and would only grow negative do not contribute */
+  double norm = 0;
+  for (size_t c = 0; c < this->cliqueGradient.size(); ++c) {
+    if ((this->cliqueGradient[c] < 0) || (this->cliqueMultipliers[c] > 0)) {
+      norm += this->cliqueGradient[c] * this->cliqueGradient[c];
+    }
+  }
+  for (size_t s = 0; s < this->kGradient.size(); ++s) {
+    if (this->kConstrained[s] && ((this->kGradient[s] < 0) || (this->kMultipliers[s] > 0))) {
+      norm += this->kGradient[s] * this->kGradient[s];
+    }
+  }
+  for (size_t e = 0; e < this->edgeGradient.size(); ++e) {
+    if ((this->edgeGradient[e] < 0) || (this->edgeMultipliers[e] > 0)) {
+      norm += this->edgeGradient[e] * this->edgeGradient[e];
+    }
+  }
+  return norm;
+}
+
+double
+LagrangianBound::repair()
+{
+  const ExpandedConflictGraph &g = this->graph;
+
+  std::vector<vertex_t> candidates;
+  auto vs = boost::vertices(g);
+  for (auto vit = vs.first; vit != vs.second; ++vit) {
+    if (this->selected[*vit]) {
+      candidates.push_back(*vit);
+    }
+  }
+  std::sort(candidates.begin(), candidates.end(), [&g](vertex_t v1, vertex_t v2) {
+    return g[v1].weight > g[v2].weight;
+  });
+
+  // at most one vertex per presence is selected, so only conflicts and k need to be checked
+  ExpandedConflictGraph::VertexSet accepted(boost::num_vertices(g));
+  std::vector<int> load(this->segmentLengths.size(), 0);
+  double value = 0;
+  for (vertex_t v : candidates) {
+    bool valid = true;
+    for (size_t e : this->incident[v]) {
+      vertex_t other = (this->conflicts[e].first == v) ? this->conflicts[e].second : this->conflicts[e].first;
+      if (accepted.test(other)) {
+        valid = false;
+        break;
+      }
+    }
+    for (size_t s = this->firstSegment[v]; valid && (this->k > 0) && (s < this->lastSegment[v]); ++s) {
+      valid = load[s] < this->k;
+    }
+    if (!valid) {
+      continue;
+    }
+
+    accepted.set(v);
+    value += g[v].weight;
+    for (size_t s = this->firstSegment[v]; s < this->lastSegment[v]; ++s) {
+      load[s]++;
+    }
+  }
+
+  return value;
+}
@@ -0,0 +1,74 @@
+#ifndef LAGRANGIANBOUND_H
+#define LAGRANGIANBOUND_H
+
+#include "upperbound.h"
+#include "cliquecoverbound.h"
+#include "conflicts/conflictgraph.h"
+
+#include <vector>
+
+/**
+ * Lagrangian relaxation of the maximum weight independent set on an ExpandedConflictGraph.
+ *
+ * Three kinds of constraints are moved into the objective with a multiplier each: the cliques
+ * of the segment-wise cover of CliqueCoverBound (at most one of their vertices covers the
+ * segment), the k-restriction per segment, and the conflict edges. The edges between the
+ * vertices of one presence are kept, so the relaxed problem decomposes into the labels, and for
+ * every presence of a label it selects the vertex of the largest reduced weight, if positive.
+ * Along the segments of a label, the multipliers are kept as prefix sums, so a reduced weight
+ * costs O(1) to evaluate.
+ *
+ * The multipliers start such that the relaxation equals the clique cover bound and are
+ * improved by subgradient steps (Polyak step sizes towards the best known lower bound).
+ * The smallest relaxed value is reported, so the bound is never worse than CliqueCoverBound.
+ */
+class LagrangianBound : public UpperBound {
+public:
+  /**
+   * lowerBound is the value of a known solution, e.g., of one of the heuristics. It only
+   * steers the step size, and selections found while iterating are used if they are better.
+   */
+  LagrangianBound(const ExpandedConflictGraph &g, int k = -1, double lowerBound = 0, int iterations = 300);
+  void run();
+
+  double getLowerBound() const;
+
+private:
+  typedef ExpandedConflictGraph::vertex_t vertex_t;
+
+  void setup();
+  // Selects the best vertex per presence w.r.t. the current multipliers and returns the
+  // value of the relaxation
+  double solveRelaxation();
+  // Turns the selection of the relaxation into a valid selection and returns its weight
+  double repair();
+  // Returns the squared norm of the projected subgradient
+  double computeSubgradient();
+
+  const ExpandedConflictGraph &graph;
+  int k;
+  double lowerBound;
+  int iterations;
+
+  std::vector<std::vector<vertex_t>> presences;
+  std::vector<std::pair<vertex_t, vertex_t>> conflicts;
+  std::vector<std::vector<size_t>> incident; // conflict edges per vertex
+
+  std::vector<double> segmentLengths;
+  std::vector<char> kConstrained; // segments whose cover is larger than k
+  std::vector<int> vertexPois;
+  std::vector<std::vector<CliqueCoverBound::Membership>> memberships;
+  // per vertex, the segments and the range of memberships of its POI it covers
+  std::vector<size_t> firstSegment, lastSegment;
+  std::vector<size_t> firstMembership, lastMembership;
+  // per POI, prefix sums of the clique and k multipliers along its memberships
+  std::vector<std::vector<double>> prefix;
+
+  std::vector<double> cliqueMultipliers, kMultipliers, edgeMultipliers;
+  std::vector<double> cliqueGradient, kGradient, edgeGradient;
+
+  std::vector<double> reduced;
+  std::vector<char> selected;
+};
+
+#endif // LAGRANGIANBOUND_H
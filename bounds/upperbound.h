@@ -0,0 +1,25 @@
+#ifndef UPPERBOUND_H
+#define UPPERBOUND_H
+
+#include <limits>
+
+/**
+ * Base class for cheap upper bounds on the total display time of any valid selection.
+ * In contrast to the bound of the ILP, they only look at the interval and conflict
+ * structure of an ExpandedConflictGraph, and thus are available for every instance.
+ */
+class UpperBound {
+public:
+  virtual ~UpperBound() {}
+
+  virtual void run() = 0;
+
+  double getBound() const {
+    return this->bound;
+  }
+
+protected:
+  double bound = std::numeric_limits<double>::infinity();
+};
+
+#endif // UPPERBOUND_H
@@ -4,7 +4,14 @@
 
 #include "../ilp/adapter.h"
 #include "../heuristics/greedyheuristic.h"
+#include "../heuristics/parallelgreedyheuristic.h"
 #include "../heuristics/intervalgraphheuristic.h"
+#include "../heuristics/plsheuristic.h"
+#include "../heuristics/localsearch.h"
+#include "../heuristics/branchandreduce.h"
+#include "../heuristics/portfolio.h"
+#include "../bounds/cliquecoverbound.h"
+#include "../bounds/lagrangianbound.h"
 #include "conflicts/conflictgraph.h"
 
 #include "checks/resultconsistencychecker.h"
@@ -19,13 +26,358 @@
 #include <string>
 #include <fstream>
 #include <ios>
+#include <memory>
 
-CLIRunner::CLIRunner(Map *map, int seed, int iterations, const char *graphOutFile, const char *outputFile, const char *ilpOutputFile, const char *intervalOutputFile, bool fixseed, int k):
-    map(map), seed(seed), iterations(iterations), graphOutFile(graphOutFile), outputFile(outputFile), ilpOutputFile(ilpOutputFile), intervalOutputFile(intervalOutputFile), fixseed(fixseed), k(k)
+CLIRunner::CLIRunner(Map *map, int seed, int iterations, const char *graphOutFile, const char *outputFile, const char *ilpOutputFile, const char *intervalOutputFile, bool fixseed, int k, std::vector<int> kSweep, bool kSweepAll, double plsTimeLimit, double lsTimeLimit, bool exact, SolverBudgets budgets, double portfolioTimeLimit):
+    map(map), seed(seed), iterations(iterations), graphOutFile(graphOutFile), outputFile(outputFile), ilpOutputFile(ilpOutputFile), intervalOutputFile(intervalOutputFile), fixseed(fixseed), k(k), kSweep(kSweep), kSweepAll(kSweepAll), plsTimeLimit(plsTimeLimit), lsTimeLimit(lsTimeLimit), exact(exact), budgets(budgets), portfolioTimeLimit(portfolioTimeLimit)
 {
     this->rng = std::mt19937(seed);
 }
 
+/* The best selection for one model so far, which its ILP starts from (see ILP_WARM_START) */
+struct WarmStart {
+  WarmStart() : selection(nullptr), score(-1) {}
+  ~WarmStart() {
+    delete this->selection;
+  }
+
+  /* Keeps a copy of candidate if it is better than the current one */
+  void offer(SelectionIntervals *candidate, double candidateScore) {
+    if ((candidate == nullptr) || (candidateScore <= this->score)) {
+      return;
+    }
+    delete this->selection;
+    this->selection = new SelectionIntervals(*candidate);
+    this->score = candidateScore;
+  }
+
+  SelectionIntervals *selection;
+  double score;
+
+private:
+  WarmStart(const WarmStart &);
+  WarmStart &operator=(const WarmStart &);
+};
+
+/* Sets the deadline of h, if there is a budget */
+static void applyBudget(Heuristic &h, double budget)
+{
+  if (budget > 0) {
+    h.setTimeBudget(budget);
+  }
+}
+
+/* Computes both upper bounds on g. Everything stays at -1 if the graph was too large. */
+static void computeUpperBounds(const ExpandedConflictGraph *g, int k, double lowerBound, double &cliqueBound, double &cliqueTime, double &lagrangianBound, double &lagrangianTime)
+{
+  cliqueBound = cliqueTime = lagrangianBound = lagrangianTime = -1;
+  if (g == nullptr) {
+    return;
+  }
+
+  Clock clock;
+  clock.start();
+  CliqueCoverBound cliqueCover(*g, k);
+  cliqueCover.run();
+  cliqueTime = clock.stop();
+  cliqueBound = cliqueCover.getBound();
+
+  clock.start();
+  LagrangianBound lagrangian(*g, k, std::max(lowerBound, 0.0));
+  lagrangian.run();
+  lagrangianTime = clock.stop();
+  lagrangianBound = lagrangian.getBound();
+}
+
+/* Improves selection by local search on g, and writes the result to <intervalOutputFile>-seed<seed>-selection-LS-<name>.csv.
+ * The search also stops after budget seconds, if positive, the budget of the heuristic that found the selection.
+ * Everything stays at -1 if the graph was too large or there is no selection. */
+static void improveSelection(SelectionIntervals *selection, const ExpandedConflictGraph *g, ConflictIntervals &conflicts, Heuristic::ModelType mtype, int k, double timeLimit, double budget, const char *intervalOutputFile, const char *name, int cur_seed, double &score, double &time, WarmStart &start)
+{
+  score = time = -1;
+  if ((g == nullptr) || (selection == nullptr) || (timeLimit <= 0)) {
+    return;
+  }
+
+  Clock clock;
+  clock.start();
+  LocalSearch ls(selection, *g, conflicts, mtype, k, timeLimit);
+  applyBudget(ls, budget);
+  ls.run();
+  time = clock.stop();
+
+  Evaluator eval(ls.getLabelIntervals(), name);
+  score = eval.getTotalDisplayTime();
+  start.offer(ls.getLabelIntervals(), score);
+
+  if (intervalOutputFile != nullptr) {
+    ostringstream selection_filename;
+    selection_filename << intervalOutputFile << "-seed" << cur_seed << "-selection-LS-" << name << ".csv";
+    ls.getLabelIntervals()->write(selection_filename.str().c_str());
+  }
+}
+
+/* Runs the parallel greedy heuristic on g with num_threads threads, and writes the result to
+ * <intervalOutputFile>-seed<seed>-selection-PGH-<name>.csv. Everything stays at -1 if the graph was too large. */
+static void runParallelGreedy(const ExpandedConflictGraph *g, int k, double budget, const char *intervalOutputFile, const char *name, int cur_seed, double &score, double &time, WarmStart &start)
+{
+  score = time = -1;
+  if (g == nullptr) {
+    return;
+  }
+
+  Clock clock;
+  ParallelGreedyHeuristic pgh(*g, k);
+  applyBudget(pgh, budget);
+  clock.start();
+  pgh.run();
+  time = clock.stop();
+
+  Evaluator pghEval(pgh.getLabelIntervals(), name);
+  score = pghEval.getTotalDisplayTime();
+  start.offer(pgh.getLabelIntervals(), score);
+
+  if (intervalOutputFile != nullptr) {
+    ostringstream selection_filename;
+    selection_filename << intervalOutputFile << "-seed" << cur_seed << "-selection-PGH-" << name << ".csv";
+    pgh.getLabelIntervals()->write(selection_filename.str().c_str());
+  }
+}
+
+/* Solves g with the branch and reduce solver, and writes the result to <intervalOutputFile>-seed<seed>-selection-EXACT-<name>.csv.
+ * Everything stays at -1 if the graph was too large. */
+static void solveExactly(const ExpandedConflictGraph *g, int k, const char *intervalOutputFile, const char *name, int cur_seed, double &score, double &bound, double &time, WarmStart &start)
+{
+  score = bound = time = -1;
+  if (g == nullptr) {
+    return;
+  }
+
+  Clock clock;
+  clock.start();
+  BranchAndReduce br(*g, k, TIME_LIMIT, EXACT_MAX_COMPONENT_SIZE);
+  br.run();
+  time = clock.stop();
+  score = br.getScore();
+  bound = br.getBound();
+  start.offer(br.getLabelIntervals(), score);
+
+  if (intervalOutputFile != nullptr) {
+    ostringstream selection_filename;
+    selection_filename << intervalOutputFile << "-seed" << cur_seed << "-selection-EXACT-" << name << ".csv";
+    br.getLabelIntervals()->write(selection_filename.str().c_str());
+  }
+}
+
+/* Solves the ILP for the model, unless chain (see ILPAdapter::setChained()) has solved it already,
+ * and writes the result to <intervalOutputFile>-seed<seed>-selection-ILP-<name>.csv. The score is
+ * -2 if there is no solution. */
+static void runILP(Map *map, Camera *camera, ILPAdapter *chain, Heuristic::ModelType mtype, int k, double budget, const char *ilpOutputFile, const char *intervalOutputFile, const char *name, int cur_seed, WarmStart &start, double &score, double &bound, double &gap, double &time)
+{
+  const char *ilp_filename;
+  string buf;
+  if (ilpOutputFile != nullptr) {
+    ostringstream ilp_filename_stream;
+    ilp_filename_stream << ilpOutputFile << "-" << name << ".mps";
+    buf = ilp_filename_stream.str();
+    ilp_filename = buf.c_str();
+  } else {
+    ilp_filename = nullptr;
+  }
+
+  ILPAdapter own(map, camera->getVisibilityIntervals(), camera->getConflictIntervals(), mtype, k, ilp_filename);
+  ILPAdapter *ilp = chain;
+  double tmp_time;
+  if (ilp == nullptr) {
+    ilp = &own;
+    if (ILP_WARM_START) {
+      own.setStart(start.selection);
+    }
+    applyBudget(own, budget);
+    Clock ilp_clock;
+    ilp_clock.start();
+    own.run();
+    tmp_time = ilp_clock.stop();
+  } else {
+    tmp_time = chain->getTime(mtype);
+  }
+  bound = ilp->getBound(mtype);
+  gap = ilp->getGap(mtype);
+
+  SelectionIntervals *selection = ilp->getLabelIntervals(mtype);
+  if (selection == nullptr) {
+    score = -2;
+    return;
+  }
+
+  string title = string("ILP ") + name;
+  Evaluator ilpEval(selection, title.c_str());
+  score = ilpEval.getTotalDisplayTime();
+  ilpEval.print();
+  time = tmp_time;
+
+  if (intervalOutputFile != nullptr) {
+    ostringstream selection_filename;
+    selection_filename << intervalOutputFile << "-seed" << cur_seed << "-selection-ILP-" << name << ".csv";
+    selection->write(selection_filename.str().c_str());
+  }
+
+#ifdef CONSISTENCY_CHECKS
+  std::cout << "Running consistency checks...\n";
+  ResultConsistencyChecker rcc(selection, camera, map, k);
+  rcc.check();
+#endif
+}
+
+/* Runs the greedy heuristic, the interval graph heuristic and the ILP (and the phased local search
+ * and the branch and reduce solver, if enabled) at the same time on the model, within timeLimit
+ * seconds and num_threads threads, and writes the best result to
+ * <intervalOutputFile>-seed<seed>-selection-PORTFOLIO-<name>.csv. The interval graph heuristic
+ * runs on g1, the AM1 graph. Everything stays at -1 if the graph was too large. */
+static void runPortfolio(Map *map, Camera *camera, const ExpandedConflictGraph *g, const ExpandedConflictGraph *g1, Heuristic::ModelType mtype, int k, double timeLimit, double plsTimeLimit, bool exact, double knownBound, const char *intervalOutputFile, const char *name, int cur_seed, double &score, double &bound, std::string &winner, double &winnerTime, double &time)
+{
+  score = bound = winnerTime = time = -1;
+  winner = "-1";
+  if ((g == nullptr) || (g1 == nullptr)) {
+    return;
+  }
+
+  IGHeuristic::Mode igMode = IGHeuristic::AM1;
+  if (mtype == Heuristic::AM2) {
+    igMode = IGHeuristic::AM2;
+  } else if (mtype == Heuristic::AM3) {
+    igMode = IGHeuristic::AM3;
+  }
+
+  // the heuristics take a thread each, the ILP gets the rest
+  int threads = std::max(num_threads, 1);
+  GreedyHeuristic gh(*g, k);
+  IGHeuristic igh(*g1, igMode, k);
+  ILPAdapter ilp(map, camera->getVisibilityIntervals(), camera->getConflictIntervals(), mtype, k);
+  ilp.setThreads(std::max(threads - 2, 1));
+  BranchAndReduce br(*g, k, timeLimit, EXACT_MAX_COMPONENT_SIZE);
+
+  Portfolio portfolio(timeLimit, threads);
+  portfolio.add("GREEDY", &gh);
+  portfolio.add("INTGRAPH", &igh);
+  portfolio.add("ILP", &ilp, std::max(threads - 2, 1), [&ilp]() {
+    return ilp.getLabelIntervals() != nullptr ? ilp.getBound() : -1;
+  });
+  if (exact) {
+    portfolio.add("EXACT", &br, 1, [&br]() {
+      return br.getBound();
+    });
+  }
+  // the phased local search copies the graph, so only set it up if needed
+  std::unique_ptr<PLSHeuristic> pls;
+  if (plsTimeLimit > 0) {
+    pls.reset(new PLSHeuristic(*g, k, plsTimeLimit, cur_seed, 1));
+    portfolio.add("PLS", pls.get());
+  }
+  portfolio.setBound(knownBound);
+  portfolio.run();
+
+  time = portfolio.getTime();
+  bound = portfolio.getBound();
+  if (portfolio.getLabelIntervals() != nullptr) {
+    score = portfolio.getScore();
+    winner = portfolio.getWinner();
+    winnerTime = portfolio.getWinnerTime();
+
+#ifdef CONSISTENCY_CHECKS
+    std::cout << "Running consistency checks...\n";
+    ResultConsistencyChecker rcc(portfolio.getLabelIntervals(), camera, map, k);
+    rcc.check();
+#endif
+
+    if (intervalOutputFile != nullptr) {
+      ostringstream selection_filename;
+      selection_filename << intervalOutputFile << "-seed" << cur_seed << "-selection-PORTFOLIO-" << name << ".csv";
+      portfolio.getLabelIntervals()->write(selection_filename.str().c_str());
+    }
+  }
+}
+
+/* Solves the ILP for the model once for every k (see ILPAdapter::setKSweep()), and writes a row
+ * for each of them to kSweepFile, as well as the result to
+ * <intervalOutputFile>-seed<seed>-selection-<name>-k<k>.csv. The score is -2 if there is no
+ * solution. */
+static void runILPKSweep(Map *map, Camera *camera, Heuristic::ModelType mtype, const std::vector<int> &ks, double budget, const char *intervalOutputFile, const char *name, int cur_seed, WarmStart &start, std::ofstream &kSweepFile)
+{
+  if (ks.empty()) {
+    return;
+  }
+
+  ILPAdapter ilp(map, camera->getVisibilityIntervals(), camera->getConflictIntervals(), mtype);
+  ilp.setKSweep(ks);
+  if (ILP_WARM_START) {
+    ilp.setStart(start.selection);
+  }
+  applyBudget(ilp, ks.size() * budget);
+  ilp.run();
+
+  for (int k : ks) {
+    double score = -2;
+    SelectionIntervals *selection = ilp.getLabelIntervalsForK(k);
+    if (selection != nullptr) {
+      string title = string(name) + " k=" + std::to_string(k);
+      Evaluator ilpEval(selection, title.c_str());
+      score = ilpEval.getTotalDisplayTime();
+
+#ifdef CONSISTENCY_CHECKS
+      std::cout << "Running consistency checks...\n";
+      ResultConsistencyChecker rcc(selection, camera, map, k);
+      rcc.check();
+#endif
+
+      if (intervalOutputFile != nullptr) {
+        ostringstream selection_filename;
+        selection_filename << intervalOutputFile << "-seed" << cur_seed << "-selection-" << name << "-k" << k << ".csv";
+        selection->write(selection_filename.str().c_str());
+      }
+    }
+
+    kSweepFile << "2," << cur_seed << "," << name << "," << k << ",-1";
+    kSweepFile << "," << score << "," << ilp.getTimeForK(k) << "," << ilp.getBoundForK(k) << "\n";
+  }
+  kSweepFile.flush();
+}
+
+bool CLIRunner::sweepK() const
+{
+  return this->kSweepAll || !this->kSweep.empty();
+}
+
+std::vector<int> CLIRunner::sweptKs(int rounds) const
+{
+  if (!this->kSweepAll) {
+    return this->kSweep;
+  }
+  std::vector<int> ks;
+  for (int k = 1; k <= rounds; k++) {
+    ks.push_back(k);
+  }
+  return ks;
+}
+
+void CLIRunner::writeKSweep(const IGHeuristic &igh, const char *name, int cur_seed)
+{
+  for (int k : this->sweptKs(igh.getRounds())) {
+    int rounds = ((k < 1) || (k > igh.getRounds())) ? igh.getRounds() : k;
+    this->kSweepFile << "2," << cur_seed << "," << name << "," << k << "," << rounds;
+    this->kSweepFile << "," << igh.getScoreForK(k) << "," << igh.getTimeForK(k) << ",-1\n";
+
+    if (this->intervalOutputFile != nullptr) {
+      ostringstream selection_filename;
+      selection_filename << this->intervalOutputFile << "-seed" << cur_seed << "-selection-" << name << "-k" << k << ".csv";
+      SelectionIntervals *selection = igh.getLabelIntervalsForK(k);
+      selection->write(selection_filename.str().c_str());
+      delete selection;
+    }
+  }
+  this->kSweepFile.flush();
+}
+
 void CLIRunner::run()
 {
   std::cout << "Running CLI";
@@ -41,8 +393,18 @@ void CLIRunner::run()
   outfile.open(this->outputFile, std::ios::out );
   outfile << "FILE-VERSION," << "K," << "SEED";
   outfile << "," << "ILP AM1 SCORE" << "," << "ILP AM2 SCORE" << "," << "ILP AM3 SCORE" << "," << "ILP AM1 BOUND" << "," << "ILP AM2 BOUND" << "," << "ILP AM3 BOUND" << "," << "ILP AM1 GAP " << "," << "ILP AM2 GAP " << "," << "ILP AM3 GAP " << "," << "ILP AM1 TIME" << "," << "ILP AM2 TIME" << "," << "ILP AM3 TIME";
+  outfile << "," << "EXACT AM1 SCORE" << "," << "EXACT AM2 SCORE" << "," << "EXACT AM3 SCORE" << "," << "EXACT AM1 BOUND" << "," << "EXACT AM2 BOUND" << "," << "EXACT AM3 BOUND" << "," << "EXACT AM1 TIME" << "," << "EXACT AM2 TIME" << "," << "EXACT AM3 TIME";
   outfile  << "," << "GREEDY AM1 SCORE" << "," << "GREEDY AM1 COMPOUND SCORE" << "," << "GREEDY AM2 SCORE" << "," << "GREEDY AM3 SCORE" << "," << "GREEDY AM1 TIME" << "," << "GREEDY AM1 COMPOUND TIME" << "," << "GREEDY AM2 TIME" << "," << "GREEDY AM3 TIME";
+  outfile  << "," << "PARALLEL GREEDY AM1 SCORE" << "," << "PARALLEL GREEDY AM1 COMPOUND SCORE" << "," << "PARALLEL GREEDY AM2 SCORE" << "," << "PARALLEL GREEDY AM3 SCORE" << "," << "PARALLEL GREEDY AM1 TIME" << "," << "PARALLEL GREEDY AM1 COMPOUND TIME" << "," << "PARALLEL GREEDY AM2 TIME" << "," << "PARALLEL GREEDY AM3 TIME";
   outfile  << "," << "INTGRAPH AM1 SCORE" << "," << "INTGRAPH AM2 SCORE" << "," << "INTGRAPH AM3 SCORE" << "," << "INTGRAPH AM1 TIME" << "," << "INTGRAPH AM2 TIME" << "," << "INTGRAPH AM3 TIME";
+  outfile  << "," << "LS GREEDY AM1 SCORE" << "," << "LS GREEDY AM2 SCORE" << "," << "LS GREEDY AM3 SCORE" << "," << "LS INTGRAPH AM1 SCORE" << "," << "LS INTGRAPH AM2 SCORE" << "," << "LS INTGRAPH AM3 SCORE";
+  outfile  << "," << "LS GREEDY AM1 TIME" << "," << "LS GREEDY AM2 TIME" << "," << "LS GREEDY AM3 TIME" << "," << "LS INTGRAPH AM1 TIME" << "," << "LS INTGRAPH AM2 TIME" << "," << "LS INTGRAPH AM3 TIME";
+  outfile  << "," << "PLS AM1 SCORE" << "," << "PLS AM2 SCORE" << "," << "PLS AM3 SCORE" << "," << "PLS AM1 TIME" << "," << "PLS AM2 TIME" << "," << "PLS AM3 TIME";
+  outfile  << "," << "CLIQUE AM1 BOUND" << "," << "CLIQUE AM2 BOUND" << "," << "CLIQUE AM3 BOUND" << "," << "CLIQUE AM1 TIME" << "," << "CLIQUE AM2 TIME" << "," << "CLIQUE AM3 TIME";
+  outfile  << "," << "LAGRANGIAN AM1 BOUND" << "," << "LAGRANGIAN AM2 BOUND" << "," << "LAGRANGIAN AM3 BOUND" << "," << "LAGRANGIAN AM1 TIME" << "," << "LAGRANGIAN AM2 TIME" << "," << "LAGRANGIAN AM3 TIME";
+  outfile  << "," << "PORTFOLIO AM1 SCORE" << "," << "PORTFOLIO AM2 SCORE" << "," << "PORTFOLIO AM3 SCORE" << "," << "PORTFOLIO AM1 BOUND" << "," << "PORTFOLIO AM2 BOUND" << "," << "PORTFOLIO AM3 BOUND";
+  outfile  << "," << "PORTFOLIO AM1 WINNER" << "," << "PORTFOLIO AM2 WINNER" << "," << "PORTFOLIO AM3 WINNER" << "," << "PORTFOLIO AM1 WIN TIME" << "," << "PORTFOLIO AM2 WIN TIME" << "," << "PORTFOLIO AM3 WIN TIME";
+  outfile  << "," << "PORTFOLIO AM1 TIME" << "," << "PORTFOLIO AM2 TIME" << "," << "PORTFOLIO AM3 TIME";
   outfile << ", ROTATIONAL CONFLICT TIME" << ", ZOOMING CONFLICT TIME" << ", PATH CREATION TIME" << ", INTERPOLATION TIME" << ", GRAPH AM1 TIME" << ", GRAPH AM2 TIME" << ", GRAPH AM3 TIME";
 
   outfile << ", NUMBER OF CONFLICTS" << ", NUMBER OF VISIBILITIES " << ", TRAJECTORY LENGTH" << ", TRAJECTORY SIZE" << ", VISIBILITIES LENGTH" << ", CONFLICTS LENGTH" ;
@@ -50,6 +412,13 @@ void CLIRunner::run()
 
   outfile << "\n";
 
+  if (this->sweepK()) {
+    ostringstream ksweep_filename;
+    ksweep_filename << this->outputFile << "-ksweep.csv";
+    this->kSweepFile.open(ksweep_filename.str().c_str(), std::ios::out);
+    this->kSweepFile << "FILE-VERSION,SEED,SOLVER,K,ROUNDS,SCORE,TIME,BOUND\n";
+  }
+
   for (int i = 0 ; i < iterations ; i++) {
     int cur_seed = uni(this->rng);
     if (fixseed) {
@@ -58,7 +427,7 @@ void CLIRunner::run()
     Router router(this->map, cur_seed);
 
     // Write instance to outfile first, in case of a crash...
-    outfile << "6," << this->k << "," << cur_seed;
+    outfile << "12," << this->k << "," << cur_seed;
     outfile << std::flush;
 
     std::vector<std::pair<edge_t, bool>> route = router.get_random_route();
@@ -184,24 +553,53 @@ void CLIRunner::run()
 
 
 
+    // the best result of each model, which its ILP starts from
+    WarmStart start_am1, start_am2, start_am3;
+
     std::cout << "Running AM1 ig heuristic..." << std::endl;
     double igh_am1_score = -1;
     double igh_am1_time = -1;
+    int igh_am1_rounds = 0;
+    double ls_igh_am1_score = -1;
+    double ls_igh_am1_time = -1;
     if (ecg_am1 != nullptr) {
       Clock igh_clock;
 
-      IGHeuristic ighAM1(*ecg_am1,IGHeuristic::AM1, this->k);
+      IGHeuristic ighAM1(*ecg_am1,IGHeuristic::AM1, this->sweepK() ? -1 : this->k);
+      applyBudget(ighAM1, this->budgets.ig);
       igh_clock.start();
       ighAM1.run();
       igh_am1_time = igh_clock.stop();
+      igh_am1_rounds = ighAM1.getRounds();
 
-      Evaluator ighAM1Eval(ighAM1.getLabelIntervals(), "Interval Graph AM1");
-      igh_am1_score = ighAM1Eval.getTotalDisplayTime();
+      if (this->sweepK()) {
+        // The run was unbounded, the result for this->k is one of its prefixes
+        igh_am1_score = ighAM1.getScoreForK(this->k);
+        igh_am1_time = ighAM1.getTimeForK(this->k);
+        this->writeKSweep(ighAM1, "IGH-AM1", cur_seed);
+      } else {
+        Evaluator ighAM1Eval(ighAM1.getLabelIntervals(), "Interval Graph AM1");
+        igh_am1_score = ighAM1Eval.getTotalDisplayTime();
+      }
+
+      if (igh_am1_score > start_am1.score) {
+        SelectionIntervals *selection = ighAM1.getLabelIntervalsForK(this->k);
+        start_am1.offer(selection, igh_am1_score);
+        delete selection;
+      }
 
       if (this->intervalOutputFile != nullptr) {
         ostringstream selection_filename;
         selection_filename << this->intervalOutputFile << "-seed" << cur_seed << "-selection-IGH-AM1.csv";
-        ighAM1.getLabelIntervals()->write(selection_filename.str().c_str());
+        SelectionIntervals *selection = ighAM1.getLabelIntervalsForK(this->k);
+        selection->write(selection_filename.str().c_str());
+        delete selection;
+      }
+
+      if (this->lsTimeLimit > 0) {
+        SelectionIntervals *selection = ighAM1.getLabelIntervalsForK(this->k);
+        improveSelection(selection, ecg_am1, camera->getConflictIntervals(), Heuristic::AM1, this->k, this->lsTimeLimit, this->budgets.ig, this->intervalOutputFile, "IGH-AM1", cur_seed, ls_igh_am1_score, ls_igh_am1_time, start_am1);
+        delete selection;
       }
     }
 #ifndef NDEBUG
@@ -213,21 +611,47 @@ void CLIRunner::run()
     std::cout << "Running AM2 ig heuristic..." << std::endl;
     double igh_am2_score = -1;
     double igh_am2_time = -1;
+    int igh_am2_rounds = 0;
+    double ls_igh_am2_score = -1;
+    double ls_igh_am2_time = -1;
     if (ecg_am1 != nullptr) {
       Clock igh_clock;
 
-      IGHeuristic ighAM2(*ecg_am1,IGHeuristic::AM2, this->k);
+      IGHeuristic ighAM2(*ecg_am1,IGHeuristic::AM2, this->sweepK() ? -1 : this->k);
+      applyBudget(ighAM2, this->budgets.ig);
          igh_clock.start();
       ighAM2.run();
       igh_am2_time = igh_clock.stop();
+      igh_am2_rounds = ighAM2.getRounds();
 
-      Evaluator ighAM2Eval(ighAM2.getLabelIntervals(), "Interval Graph AM2");
-      igh_am2_score = ighAM2Eval.getTotalDisplayTime();
+      if (this->sweepK()) {
+        // The run was unbounded, the result for this->k is one of its prefixes
+        igh_am2_score = ighAM2.getScoreForK(this->k);
+        igh_am2_time = ighAM2.getTimeForK(this->k);
+        this->writeKSweep(ighAM2, "IGH-AM2", cur_seed);
+      } else {
+        Evaluator ighAM2Eval(ighAM2.getLabelIntervals(), "Interval Graph AM2");
+        igh_am2_score = ighAM2Eval.getTotalDisplayTime();
+      }
+
+      if (igh_am2_score > start_am2.score) {
+        SelectionIntervals *selection = ighAM2.getLabelIntervalsForK(this->k);
+        start_am2.offer(selection, igh_am2_score);
+        delete selection;
+      }
 
       if (this->intervalOutputFile != nullptr) {
         ostringstream selection_filename;
         selection_filename << this->intervalOutputFile << "-seed" << cur_seed << "-selection-IGH-AM2.csv";
-        ighAM2.getLabelIntervals()->write(selection_filename.str().c_str());
+        SelectionIntervals *selection = ighAM2.getLabelIntervalsForK(this->k);
+        selection->write(selection_filename.str().c_str());
+        delete selection;
+      }
+
+      if (this->lsTimeLimit > 0) {
+        SelectionIntervals *selection = ighAM2.getLabelIntervalsForK(this->k);
+        improveSelection(selection, ecg_am2, camera->getConflictIntervals(), Heuristic::AM2, this->k, this->lsTimeLimit, this->budgets.ig, this->intervalOutputFile, "IGH-AM2", cur_seed, ls_igh_am2_score, ls_igh_am2_time, start_am2);
+        delete selection;
       }
     }
 #ifndef NDEBUG
@@ -238,21 +662,47 @@ void CLIRunner::run()
     std::cout << "Running AM3 ig heuristic..." << std::endl;
     double igh_am3_score = -1;
     double igh_am3_time = -1;
+    int igh_am3_rounds = 0;
+    double ls_igh_am3_score = -1;
+    double ls_igh_am3_time = -1;
     if (ecg_am1 != nullptr) {
       Clock igh_clock;
 
-      IGHeuristic ighAM3(*ecg_am1,IGHeuristic::AM3, this->k);
+      IGHeuristic ighAM3(*ecg_am1,IGHeuristic::AM3, this->sweepK() ? -1 : this->k);
+      applyBudget(ighAM3, this->budgets.ig);
       igh_clock.start();
       ighAM3.run();
       igh_am3_time = igh_clock.stop();
+      igh_am3_rounds = ighAM3.getRounds();
+
+      if (this->sweepK()) {
+        // The run was unbounded, the result for this->k is one of its prefixes
+        igh_am3_score = ighAM3.getScoreForK(this->k);
+        igh_am3_time = ighAM3.getTimeForK(this->k);
+        this->writeKSweep(ighAM3, "IGH-AM3", cur_seed);
+      } else {
+        Evaluator ighAM3Eval(ighAM3.getLabelIntervals(), "Interval Graph AM3");
+        igh_am3_score = ighAM3Eval.getTotalDisplayTime();
+      }
 
-      Evaluator ighAM3Eval(ighAM3.getLabelIntervals(), "Interval Graph AM3");
-      igh_am3_score = ighAM3Eval.getTotalDisplayTime();
+      if (igh_am3_score > start_am3.score) {
+        SelectionIntervals *selection = ighAM3.getLabelIntervalsForK(this->k);
+        start_am3.offer(selection, igh_am3_score);
+        delete selection;
+      }
 
       if (this->intervalOutputFile != nullptr) {
         ostringstream selection_filename;
         selection_filename << this->intervalOutputFile << "-seed" << cur_seed << "-selection-IGH-AM3.csv";
-        ighAM3.getLabelIntervals()->write(selection_filename.str().c_str());
+        SelectionIntervals *selection = ighAM3.getLabelIntervalsForK(this->k);
+        selection->write(selection_filename.str().c_str());
+        delete selection;
+      }
+
+      if (this->lsTimeLimit > 0) {
+        SelectionIntervals *selection = ighAM3.getLabelIntervalsForK(this->k);
+        improveSelection(selection, ecg_am3, camera->getConflictIntervals(), Heuristic::AM3, this->k, this->lsTimeLimit, this->budgets.ig, this->intervalOutputFile, "IGH-AM3", cur_seed, ls_igh_am3_score, ls_igh_am3_time, start_am3);
+        delete selection;
       }
     }
 #ifndef NDEBUG
@@ -266,16 +716,20 @@ void CLIRunner::run()
     std::cout << "Running AM1 greedy heuristic..."<<std::endl;
     double gh_am1_score = -1;
     double gh_am1_time = -1;
+    double ls_gh_am1_score = -1;
+    double ls_gh_am1_time = -1;
     if (ecg_am1 != nullptr) {
       Clock gh_clock;
 
       GreedyHeuristic ghAM1(*ecg_am1, this->k);
+      applyBudget(ghAM1, this->budgets.greedy);
        gh_clock.start();
       ghAM1.run();
       gh_am1_time = gh_clock.stop();
 
       Evaluator ghAM1Eval(ghAM1.getLabelIntervals(), "Greedy AM1");
       gh_am1_score = ghAM1Eval.getTotalDisplayTime();
+      start_am1.offer(ghAM1.getLabelIntervals(), gh_am1_score);
 
 #ifdef CONSISTENCY_CHECKS
       std::cout << "Running consistency checks...\n";
@@ -288,6 +742,8 @@ void CLIRunner::run()
         selection_filename << this->intervalOutputFile << "-seed" << cur_seed << "-selection-GH-AM1.csv";
         ghAM1.getLabelIntervals()->write(selection_filename.str().c_str());
       }
+
+      improveSelection(ghAM1.getLabelIntervals(), ecg_am1, camera->getConflictIntervals(), Heuristic::AM1, this->k, this->lsTimeLimit, this->budgets.greedy, this->intervalOutputFile, "GH-AM1", cur_seed, ls_gh_am1_score, ls_gh_am1_time, start_am1);
     }
 
 #ifndef NDEBUG
@@ -303,12 +759,14 @@ void CLIRunner::run()
       Clock gh_clock;
 
       GreedyHeuristic ghAM1(*ecg_am1_comp, this->k);
+      applyBudget(ghAM1, this->budgets.greedy);
       gh_clock.start();
       ghAM1.run();
       gh_am1_comp_time = gh_clock.stop();
 
       Evaluator ghAM1Eval(ghAM1.getLabelIntervals(), "Greedy AM1 Compound");
       gh_am1_comp_score = ghAM1Eval.getTotalDisplayTime();
+      start_am1.offer(ghAM1.getLabelIntervals(), gh_am1_comp_score);
 
     #ifdef CONSISTENCY_CHECKS
       std::cout << "Running consistency checks...\n";
@@ -326,17 +784,21 @@ void CLIRunner::run()
 
     double gh_am2_score = -1;
     double gh_am2_time = -1;
+    double ls_gh_am2_score = -1;
+    double ls_gh_am2_time = -1;
     std::cout << "Running AM2 greedy heuristic...\n";
     if (ecg_am2 != nullptr) {
       Clock gh_clock;
 
       GreedyHeuristic ghAM2(*ecg_am2, this->k);
+      applyBudget(ghAM2, this->budgets.greedy);
       gh_clock.start();
       ghAM2.run();
       gh_am2_time = gh_clock.stop();
 
       Evaluator ghAM2Eval(ghAM2.getLabelIntervals(), "Greedy AM2");
       gh_am2_score = ghAM2Eval.getTotalDisplayTime();
+      start_am2.offer(ghAM2.getLabelIntervals(), gh_am2_score);
 
 #ifdef CONSISTENCY_CHECKS
       std::cout << "Running consistency checks...\n";
@@ -350,6 +812,8 @@ void CLIRunner::run()
         selection_filename << this->intervalOutputFile << "-seed" << cur_seed << "-selection-GH-AM2.csv";
         ghAM2.getLabelIntervals()->write(selection_filename.str().c_str());
       }
+
+      improveSelection(ghAM2.getLabelIntervals(), ecg_am2, camera->getConflictIntervals(), Heuristic::AM2, this->k, this->lsTimeLimit, this->budgets.greedy, this->intervalOutputFile, "GH-AM2", cur_seed, ls_gh_am2_score, ls_gh_am2_time, start_am2);
     }
 
 #ifndef NDEBUG
@@ -361,17 +825,21 @@ void CLIRunner::run()
 
     double gh_am3_score = -1;
     double gh_am3_time = -1;
+    double ls_gh_am3_score = -1;
+    double ls_gh_am3_time = -1;
     std::cout << "Running AM3 greedy heuristic...\n";
     if (ecg_am3 != nullptr) {
       Clock gh_clock;
 
       GreedyHeuristic ghAM3(*ecg_am3, this->k);
+      applyBudget(ghAM3, this->budgets.greedy);
       gh_clock.start();
       ghAM3.run();
       gh_am3_time = gh_clock.stop();
 
       Evaluator ghAM3Eval(ghAM3.getLabelIntervals(), "Greedy AM3");
       gh_am3_score = ghAM3Eval.getTotalDisplayTime();
+      start_am3.offer(ghAM3.getLabelIntervals(), gh_am3_score);
 
 #ifdef CONSISTENCY_CHECKS
       std::cout << "Running consistency checks...\n";
@@ -385,6 +853,8 @@ void CLIRunner::run()
         selection_filename << this->intervalOutputFile << "-seed" << cur_seed << "-selection-GH-AM3.csv";
         ghAM3.getLabelIntervals()->write(selection_filename.str().c_str());
       }
+
+      improveSelection(ghAM3.getLabelIntervals(), ecg_am3, camera->getConflictIntervals(), Heuristic::AM3, this->k, this->lsTimeLimit, this->budgets.greedy, this->intervalOutputFile, "GH-AM3", cur_seed, ls_gh_am3_score, ls_gh_am3_time, start_am3);
     }
 
 #ifndef NDEBUG
@@ -394,6 +864,147 @@ void CLIRunner::run()
 
     camera->getVisibilityIntervals().write("/tmp/visibilities-after-greedy-heuristics.csv");
 
+    /* The same greedy choices, but in parallel rounds */
+    double pgh_am1_score, pgh_am1_time, pgh_am1_comp_score, pgh_am1_comp_time;
+    double pgh_am2_score, pgh_am2_time, pgh_am3_score, pgh_am3_time;
+    std::cout << "Running parallel greedy heuristics...\n";
+    runParallelGreedy(ecg_am1, this->k, this->budgets.greedy, this->intervalOutputFile, "AM1", cur_seed, pgh_am1_score, pgh_am1_time, start_am1);
+    runParallelGreedy(ecg_am1_comp, this->k, this->budgets.greedy, this->intervalOutputFile, "AM1-comp", cur_seed, pgh_am1_comp_score, pgh_am1_comp_time, start_am1);
+    runParallelGreedy(ecg_am2, this->k, this->budgets.greedy, this->intervalOutputFile, "AM2", cur_seed, pgh_am2_score, pgh_am2_time, start_am2);
+    runParallelGreedy(ecg_am3, this->k, this->budgets.greedy, this->intervalOutputFile, "AM3", cur_seed, pgh_am3_score, pgh_am3_time, start_am3);
+#ifndef NDEBUG
+    std::cout << "parallel greedy scores: " << pgh_am1_score << " / " << pgh_am1_comp_score << " / " << pgh_am2_score << " / " << pgh_am3_score << std::endl;
+#endif
+
+    double pls_am1_score = -1;
+    double pls_am1_time = -1;
+    if ((ecg_am1 != nullptr) && (this->plsTimeLimit > 0)) {
+      std::cout << "Running AM1 phased local search...\n";
+      Clock pls_clock;
+
+      PLSHeuristic plsAM1(*ecg_am1, this->k, this->plsTimeLimit, cur_seed);
+      pls_clock.start();
+      plsAM1.run();
+      pls_am1_time = pls_clock.stop();
+
+      Evaluator plsAM1Eval(plsAM1.getLabelIntervals(), "PLS AM1");
+      pls_am1_score = plsAM1Eval.getTotalDisplayTime();
+      start_am1.offer(plsAM1.getLabelIntervals(), pls_am1_score);
+
+#ifdef CONSISTENCY_CHECKS
+      std::cout << "Running consistency checks...\n";
+      ResultConsistencyChecker rcc(plsAM1.getLabelIntervals(), camera, map, this->k);
+      rcc.check();
+#endif
+
+      if (this->intervalOutputFile != nullptr) {
+        ostringstream selection_filename;
+        selection_filename << this->intervalOutputFile << "-seed" << cur_seed << "-selection-PLS-AM1.csv";
+        plsAM1.getLabelIntervals()->write(selection_filename.str().c_str());
+      }
+    }
+
+    double pls_am2_score = -1;
+    double pls_am2_time = -1;
+    if ((ecg_am2 != nullptr) && (this->plsTimeLimit > 0)) {
+      std::cout << "Running AM2 phased local search...\n";
+      Clock pls_clock;
+
+      PLSHeuristic plsAM2(*ecg_am2, this->k, this->plsTimeLimit, cur_seed);
+      pls_clock.start();
+      plsAM2.run();
+      pls_am2_time = pls_clock.stop();
+
+      Evaluator plsAM2Eval(plsAM2.getLabelIntervals(), "PLS AM2");
+      pls_am2_score = plsAM2Eval.getTotalDisplayTime();
+      start_am2.offer(plsAM2.getLabelIntervals(), pls_am2_score);
+
+#ifdef CONSISTENCY_CHECKS
+      std::cout << "Running consistency checks...\n";
+      ResultConsistencyChecker rcc(plsAM2.getLabelIntervals(), camera, map, this->k);
+      rcc.check();
+#endif
+
+      if (this->intervalOutputFile != nullptr) {
+        ostringstream selection_filename;
+        selection_filename << this->intervalOutputFile << "-seed" << cur_seed << "-selection-PLS-AM2.csv";
+        plsAM2.getLabelIntervals()->write(selection_filename.str().c_str());
+      }
+    }
+
+    double pls_am3_score = -1;
+    double pls_am3_time = -1;
+    if ((ecg_am3 != nullptr) && (this->plsTimeLimit > 0)) {
+      std::cout << "Running AM3 phased local search...\n";
+      Clock pls_clock;
+
+      PLSHeuristic plsAM3(*ecg_am3, this->k, this->plsTimeLimit, cur_seed);
+      pls_clock.start();
+      plsAM3.run();
+      pls_am3_time = pls_clock.stop();
+
+      Evaluator plsAM3Eval(plsAM3.getLabelIntervals(), "PLS AM3");
+      pls_am3_score = plsAM3Eval.getTotalDisplayTime();
+      start_am3.offer(plsAM3.getLabelIntervals(), pls_am3_score);
+
+#ifdef CONSISTENCY_CHECKS
+      std::cout << "Running consistency checks...\n";
+      ResultConsistencyChecker rcc(plsAM3.getLabelIntervals(), camera, map, this->k);
+      rcc.check();
+#endif
+
+      if (this->intervalOutputFile != nullptr) {
+        ostringstream selection_filename;
+        selection_filename << this->intervalOutputFile << "-seed" << cur_seed << "-selection-PLS-AM3.csv";
+        plsAM3.getLabelIntervals()->write(selection_filename.str().c_str());
+      }
+    }
+
+
+    /* Upper bounds, to judge the heuristics without the ILP */
+    std::cout << "Computing upper bounds...\n";
+    double clique_am1_bound, clique_am1_time, lagrangian_am1_bound, lagrangian_am1_time;
+    computeUpperBounds(ecg_am1, this->k, std::max(gh_am1_score, pls_am1_score), clique_am1_bound, clique_am1_time, lagrangian_am1_bound, lagrangian_am1_time);
+    double clique_am2_bound, clique_am2_time, lagrangian_am2_bound, lagrangian_am2_time;
+    computeUpperBounds(ecg_am2, this->k, std::max(gh_am2_score, pls_am2_score), clique_am2_bound, clique_am2_time, lagrangian_am2_bound, lagrangian_am2_time);
+    double clique_am3_bound, clique_am3_time, lagrangian_am3_bound, lagrangian_am3_time;
+    computeUpperBounds(ecg_am3, this->k, std::max(gh_am3_score, pls_am3_score), clique_am3_bound, clique_am3_time, lagrangian_am3_bound, lagrangian_am3_time);
+
+    /* The branch and reduce solver, on the same graphs */
+    double exact_am1_score = -1, exact_am1_bound = -1, exact_am1_time = -1;
+    double exact_am2_score = -1, exact_am2_bound = -1, exact_am2_time = -1;
+    double exact_am3_score = -1, exact_am3_bound = -1, exact_am3_time = -1;
+    if (this->exact) {
+      std::cout << "Running AM1 exact solver...\n";
+      solveExactly(ecg_am1, this->k, this->intervalOutputFile, "AM1", cur_seed, exact_am1_score, exact_am1_bound, exact_am1_time, start_am1);
+      std::cout << "Running AM2 exact solver...\n";
+      solveExactly(ecg_am2, this->k, this->intervalOutputFile, "AM2", cur_seed, exact_am2_score, exact_am2_bound, exact_am2_time, start_am2);
+      std::cout << "Running AM3 exact solver...\n";
+      solveExactly(ecg_am3, this->k, this->intervalOutputFile, "AM3", cur_seed, exact_am3_score, exact_am3_bound, exact_am3_time, start_am3);
+    }
+
+    /* All solvers at once, as used interactively */
+    double portfolio_am1_score = -1, portfolio_am1_bound = -1, portfolio_am1_win_time = -1, portfolio_am1_time = -1;
+    double portfolio_am2_score = -1, portfolio_am2_bound = -1, portfolio_am2_win_time = -1, portfolio_am2_time = -1;
+    double portfolio_am3_score = -1, portfolio_am3_bound = -1, portfolio_am3_win_time = -1, portfolio_am3_time = -1;
+    std::string portfolio_am1_winner = "-1", portfolio_am2_winner = "-1", portfolio_am3_winner = "-1";
+    if (this->portfolioTimeLimit > 0) {
+      std::cout << "Running AM1 solver portfolio...\n";
+      runPortfolio(this->map, camera, ecg_am1, ecg_am1, Heuristic::AM1, this->k, this->portfolioTimeLimit, this->plsTimeLimit, this->exact, lagrangian_am1_bound, this->intervalOutputFile, "AM1", cur_seed, portfolio_am1_score, portfolio_am1_bound, portfolio_am1_winner, portfolio_am1_win_time, portfolio_am1_time);
+      std::cout << "Running AM2 solver portfolio...\n";
+      runPortfolio(this->map, camera, ecg_am2, ecg_am1, Heuristic::AM2, this->k, this->portfolioTimeLimit, this->plsTimeLimit, this->exact, lagrangian_am2_bound, this->intervalOutputFile, "AM2", cur_seed, portfolio_am2_score, portfolio_am2_bound, portfolio_am2_winner, portfolio_am2_win_time, portfolio_am2_time);
+      std::cout << "Running AM3 solver portfolio...\n";
+      runPortfolio(this->map, camera, ecg_am3, ecg_am1, Heuristic::AM3, this->k, this->portfolioTimeLimit, this->plsTimeLimit, this->exact, lagrangian_am3_bound, this->intervalOutputFile, "AM3", cur_seed, portfolio_am3_score, portfolio_am3_bound, portfolio_am3_winner, portfolio_am3_win_time, portfolio_am3_time);
+    }
+
+#ifndef NDEBUG
+    std::cout << "portfolio AM1: " << portfolio_am1_score << " by " << portfolio_am1_winner << " after " << portfolio_am1_win_time << "s" << std::endl;
+    std::cout << "portfolio AM2: " << portfolio_am2_score << " by " << portfolio_am2_winner << " after " << portfolio_am2_win_time << "s" << std::endl;
+    std::cout << "portfolio AM3: " << portfolio_am3_score << " by " << portfolio_am3_winner << " after " << portfolio_am3_win_time << "s" << std::endl;
+    std::cout << "bounds AM1: " << clique_am1_bound << " / " << lagrangian_am1_bound << std::endl;
+    std::cout << "bounds AM2: " << clique_am2_bound << " / " << lagrangian_am2_bound << std::endl;
+    std::cout << "bounds AM3: " << clique_am3_bound << " / " << lagrangian_am3_bound << std::endl;
+#endif
 
     // Graph Complexity measures
     long edges_am1 = -1, edges_am2 = -1, edges_am3 = -1, vertices_am1 = -1, vertices_am2 = -1, vertices_am3 = -1;
@@ -419,14 +1030,11 @@ void CLIRunner::run()
     if (ecg_am3 != nullptr)
       delete ecg_am3;
 
-    /* First: The ILP, AM1 */
-    std::cout << "Running AM1 ILP...\n";
-    double ilp_AM1_score;
-    double ilp_AM1_bound;
-    double ilp_AM1_gap;
-
-    double ilp_AM1_time = -1;
-    if (COMPUTE_LARGE_ILPS || (ecg_am1 != nullptr)) {
+    /* With ILP_CHAIN, one adapter solves the ILPs of all three models, building the model only
+     * once. It gets the budget of each of them. */
+    std::unique_ptr<ILPAdapter> ilpChain;
+    if (ILP_CHAIN && (COMPUTE_LARGE_ILPS || (ecg_am3 != nullptr))) {
+      std::cout << "Running chained ILP...\n";
       const char *ilp_filename;
       string buf;
       if (this->ilpOutputFile != nullptr) {
@@ -438,37 +1046,24 @@ void CLIRunner::run()
         ilp_filename = nullptr;
       }
 
-      ILPAdapter ilp1(this->map, camera->getVisibilityIntervals(), camera->getConflictIntervals(), Heuristic::AM1, this->k, ilp_filename);
-      Clock ilp_clock;
-      ilp_clock.start();
-      ilp1.run();
-      double tmp_time = ilp_clock.stop();
-      ilp_AM1_bound = ilp1.getBound();
-      ilp_AM1_gap = ilp1.getGap();
-
-      if (ilp1.getLabelIntervals() != nullptr) {
-        Evaluator ilpAM1Eval(ilp1.getLabelIntervals(), "ILP AM1");
-        ilp_AM1_score = ilpAM1Eval.getTotalDisplayTime();
-        ilpAM1Eval.print();
-        ilp_AM1_time = tmp_time;
-
-        if (this->intervalOutputFile != nullptr) {
-          ostringstream selection_filename;
-          selection_filename << this->intervalOutputFile << "-seed" << cur_seed << "-selection-ILP-AM1.csv";
-          ilp1.getLabelIntervals()->write(selection_filename.str().c_str());
-        }
+      ilpChain.reset(new ILPAdapter(this->map, camera->getVisibilityIntervals(), camera->getConflictIntervals(), Heuristic::AM3, this->k, ilp_filename));
+      ilpChain->setChained(true);
+      if (ILP_WARM_START) {
+        ilpChain->setStart(start_am1.selection);
+      }
+      applyBudget(*ilpChain, 3 * this->budgets.ilp);
+      ilpChain->run();
+    }
 
-#ifdef CONSISTENCY_CHECKS
-        std::cout << "Running consistency checks...\n";
-        ResultConsistencyChecker rcc(ilp1.getLabelIntervals(), camera, map, this->k);
-        rcc.check();
-#endif
+    /* First: The ILP, AM1 */
+    std::cout << "Running AM1 ILP...\n";
+    double ilp_AM1_score = -1;
+    double ilp_AM1_bound = -1;
+    double ilp_AM1_gap = -1;
 
-      } else {
-        ilp_AM1_score = -2;
-      }
-    } else {
-      ilp_AM1_score = -1;
+    double ilp_AM1_time = -1;
+    if (COMPUTE_LARGE_ILPS || (ecg_am1 != nullptr)) {
+      runILP(this->map, camera, ilpChain.get(), Heuristic::AM1, this->k, this->budgets.ilp, this->ilpOutputFile, this->intervalOutputFile, "AM1", cur_seed, start_am1, ilp_AM1_score, ilp_AM1_bound, ilp_AM1_gap, ilp_AM1_time);
     }
 
     camera->getVisibilityIntervals().write("/tmp/visibilities-after-am1-ilp.csv");
@@ -477,98 +1072,41 @@ void CLIRunner::run()
     /* The ILP, AM2 */
     std::cout << "Running AM2 ILP...\n";
 
-    double ilp_AM2_score;
-    double ilp_AM2_bound;
-    double ilp_AM2_gap;
+    double ilp_AM2_score = -1;
+    double ilp_AM2_bound = -1;
+    double ilp_AM2_gap = -1;
 
     double ilp_AM2_time = -1;
     if (COMPUTE_LARGE_ILPS || (ecg_am2 != nullptr)) {
-      const char *ilp_filename;
-      string buf;
-      if (this->ilpOutputFile != nullptr) {
-        ostringstream ilp_filename_stream;
-        ilp_filename_stream << this->ilpOutputFile << "-AM2.mps";
-        buf = ilp_filename_stream.str();
-        ilp_filename = buf.c_str();
-      } else {
-        ilp_filename = nullptr;
-      }
-
-      ILPAdapter ilp2(this->map, camera->getVisibilityIntervals(), camera->getConflictIntervals(), Heuristic::AM2, this->k, ilp_filename);
-
-      Clock ilp_clock;
-      ilp_clock.start();
-      ilp2.run();
-      double tmp_time = ilp_clock.stop();
-
-      ilp_AM2_bound = ilp2.getBound();
-      ilp_AM2_gap = ilp2.getGap();
-
-      if (ilp2.getLabelIntervals() != nullptr) {
-        Evaluator ilpAM2Eval(ilp2.getLabelIntervals(), "ILP AM2");
-        ilp_AM2_score = ilpAM2Eval.getTotalDisplayTime();
-        ilpAM2Eval.print();
-        ilp_AM2_time = tmp_time;
-
-        if (this->intervalOutputFile != nullptr) {
-          ostringstream selection_filename;
-          selection_filename << this->intervalOutputFile << "-seed" << cur_seed << "-selection-ILP-AM2.csv";
-          ilp2.getLabelIntervals()->write(selection_filename.str().c_str());
-        }
-      } else {
-        ilp_AM2_score = -2;
-      }
-    } else {
-      ilp_AM2_score = -1;
+      runILP(this->map, camera, ilpChain.get(), Heuristic::AM2, this->k, this->budgets.ilp, this->ilpOutputFile, this->intervalOutputFile, "AM2", cur_seed, start_am2, ilp_AM2_score, ilp_AM2_bound, ilp_AM2_gap, ilp_AM2_time);
     }
 
     /* The ILP, AM3 */
     std::cout << "Running AM3 ILP...\n";
 
-    double ilp_AM3_score;
-    double ilp_AM3_bound;
-    double ilp_AM3_gap;
+    double ilp_AM3_score = -1;
+    double ilp_AM3_bound = -1;
+    double ilp_AM3_gap = -1;
 
     double ilp_AM3_time = -1;
     if (COMPUTE_LARGE_ILPS || (ecg_am3 != nullptr)) {
-      const char *ilp_filename;
-      string buf;
-      if (this->ilpOutputFile != nullptr) {
-        ostringstream ilp_filename_stream;
-        ilp_filename_stream << this->ilpOutputFile << "-AM3.mps";
-        buf = ilp_filename_stream.str();
-        ilp_filename = buf.c_str();
-      } else {
-        ilp_filename = nullptr;
+      runILP(this->map, camera, ilpChain.get(), Heuristic::AM3, this->k, this->budgets.ilp, this->ilpOutputFile, this->intervalOutputFile, "AM3", cur_seed, start_am3, ilp_AM3_score, ilp_AM3_bound, ilp_AM3_gap, ilp_AM3_time);
+    }
+    ilpChain.reset();
+
+    /* With ILP_K_SWEEP, the ILPs are swept like the interval graph heuristic, each on one model
+     * for all k (with 'all', up to the rounds of the heuristic of the same model) */
+    if (this->sweepK() && ILP_K_SWEEP) {
+      std::cout << "Running ILP k sweep...\n";
+      if (COMPUTE_LARGE_ILPS || (ecg_am1 != nullptr)) {
+        runILPKSweep(this->map, camera, Heuristic::AM1, this->sweptKs(igh_am1_rounds), this->budgets.ilp, this->intervalOutputFile, "ILP-AM1", cur_seed, start_am1, this->kSweepFile);
       }
-
-      ILPAdapter ilp3(this->map, camera->getVisibilityIntervals(), camera->getConflictIntervals(), Heuristic::AM3, this->k, ilp_filename);
-
-      Clock ilp_clock;
-      ilp_clock.start();
-      ilp3.run();
-      double tmp_time = ilp_clock.stop();
-
-      ilp_AM3_bound = ilp3.getBound();
-      ilp_AM3_gap = ilp3.getGap();
-
-      if (ilp3.getLabelIntervals() != nullptr) {
-        Evaluator ilpAM3Eval(ilp3.getLabelIntervals(), "ILP AM3");
-        ilp_AM3_score = ilpAM3Eval.getTotalDisplayTime();
-        ilpAM3Eval.print();
-
-        ilp_AM3_time = tmp_time;
-
-        if (this->intervalOutputFile != nullptr) {
-          ostringstream selection_filename;
-          selection_filename << this->intervalOutputFile << "-seed" << cur_seed << "-selection-ILP-AM3.csv";
-          ilp3.getLabelIntervals()->write(selection_filename.str().c_str());
-        }
-      } else {
-        ilp_AM3_score = -2;
+      if (COMPUTE_LARGE_ILPS || (ecg_am2 != nullptr)) {
+        runILPKSweep(this->map, camera, Heuristic::AM2, this->sweptKs(igh_am2_rounds), this->budgets.ilp, this->intervalOutputFile, "ILP-AM2", cur_seed, start_am2, this->kSweepFile);
+      }
+      if (COMPUTE_LARGE_ILPS || (ecg_am3 != nullptr)) {
+        runILPKSweep(this->map, camera, Heuristic::AM3, this->sweptKs(igh_am3_rounds), this->budgets.ilp, this->intervalOutputFile, "ILP-AM3", cur_seed, start_am3, this->kSweepFile);
       }
-    } else {
-      ilp_AM3_score = -1;
     }
 
     //ghEval.print();
@@ -583,16 +1121,46 @@ void CLIRunner::run()
     // ILP Timings
     outfile << "," << ilp_AM1_time << "," << ilp_AM2_time << "," << ilp_AM3_time;
 
+    // Branch and Reduce Scores, Bounds and Timings
+    outfile << "," << exact_am1_score << "," << exact_am2_score << "," << exact_am3_score;
+    outfile << "," << exact_am1_bound << "," << exact_am2_bound << "," << exact_am3_bound;
+    outfile << "," << exact_am1_time << "," << exact_am2_time << "," << exact_am3_time;
+
     // Greedy Scores
     outfile  << "," << gh_am1_score << "," << gh_am1_comp_score << "," << gh_am2_score << "," << gh_am3_score;
     // Greedy Timings
     outfile  << "," << gh_am1_time << "," << gh_am1_comp_time << "," << gh_am2_time << "," << gh_am3_time;
 
+    // Parallel Greedy Scores and Timings
+    outfile  << "," << pgh_am1_score << "," << pgh_am1_comp_score << "," << pgh_am2_score << "," << pgh_am3_score;
+    outfile  << "," << pgh_am1_time << "," << pgh_am1_comp_time << "," << pgh_am2_time << "," << pgh_am3_time;
+
     // Interval-Graph-Heuristic Scores
     outfile  << "," << igh_am1_score << "," << igh_am2_score << "," << igh_am3_score;
     // Interval-Graph-Heuristic Timings
     outfile  << "," << igh_am1_time << "," << igh_am2_time << "," << igh_am3_time;
 
+    // Local Search Improvement Scores and Timings
+    outfile  << "," << ls_gh_am1_score << "," << ls_gh_am2_score << "," << ls_gh_am3_score << "," << ls_igh_am1_score << "," << ls_igh_am2_score << "," << ls_igh_am3_score;
+    outfile  << "," << ls_gh_am1_time << "," << ls_gh_am2_time << "," << ls_gh_am3_time << "," << ls_igh_am1_time << "," << ls_igh_am2_time << "," << ls_igh_am3_time;
+
+    // Phased Local Search Scores and Timings
+    outfile  << "," << pls_am1_score << "," << pls_am2_score << "," << pls_am3_score;
+    outfile  << "," << pls_am1_time << "," << pls_am2_time << "," << pls_am3_time;
+
+    // Upper Bounds and their Timings
+    outfile  << "," << clique_am1_bound << "," << clique_am2_bound << "," << clique_am3_bound;
+    outfile  << "," << clique_am1_time << "," << clique_am2_time << "," << clique_am3_time;
+    outfile  << "," << lagrangian_am1_bound << "," << lagrangian_am2_bound << "," << lagrangian_am3_bound;
+    outfile  << "," << lagrangian_am1_time << "," << lagrangian_am2_time << "," << lagrangian_am3_time;
+
+    // Solver Portfolio Scores, Bounds, Winners and Timings
+    outfile  << "," << portfolio_am1_score << "," << portfolio_am2_score << "," << portfolio_am3_score;
+    outfile  << "," << portfolio_am1_bound << "," << portfolio_am2_bound << "," << portfolio_am3_bound;
+    outfile  << "," << portfolio_am1_winner << "," << portfolio_am2_winner << "," << portfolio_am3_winner;
+    outfile  << "," << portfolio_am1_win_time << "," << portfolio_am2_win_time << "," << portfolio_am3_win_time;
+    outfile  << "," << portfolio_am1_time << "," << portfolio_am2_time << "," << portfolio_am3_time;
+
 
     // General Timings
     outfile << "," << camera->time_rotation_conflicts << "," << camera->time_zoom_conflicts << "," << camera->time_path << "," << camera->time_interpolate;
@@ -612,5 +1180,8 @@ void CLIRunner::run()
     delete trajectory;
   }
   outfile.close();
+  if (this->sweepK()) {
+    this->kSweepFile.close();
+  }
   Q_EMIT finished();
 }
@@ -3,15 +3,38 @@
 
 #include <QObject>
 #include <random>
+#include <vector>
+#include <fstream>
 
 #include "map/map.h"
 #include "map/trajectoryfactory.h"
 
+class IGHeuristic;
+
+/* Time budgets in seconds for every single run of a solver, none if not positive */
+struct SolverBudgets {
+    SolverBudgets() : greedy(0), ig(0), ilp(0) {}
+
+    double greedy;
+    double ig;
+    double ilp;
+};
+
 class CLIRunner : public QObject
 {
     Q_OBJECT
 public:
-    CLIRunner(Map *map, int seed, int iterations, const char *graphOutFile, const char *outputFile, const char *ilpOutputFile = nullptr, const char *intervalOutputFile = nullptr, bool fixseed = false, int k = -1);
+    /* If kSweep is not empty (or kSweepAll is set), the interval graph heuristic is run
+     * without bound on k once, and its results for all k in kSweep (or all k up to the
+     * number of rounds) are written to <outputFile>-ksweep.csv. With ILP_K_SWEEP, so are the
+     * ones of the ILPs, which solve one model per AM for all of these k.
+     * The phased local search runs for plsTimeLimit seconds per model, if positive.
+     * Likewise, every greedy and interval graph result is improved by local search for
+     * at most lsTimeLimit seconds. If exact is set, the branch and reduce solver runs on
+     * all three models. A solver that exceeds its budget returns its best solution so far.
+     * If portfolioTimeLimit is positive, all solvers also run at the same time, for at most that
+     * many seconds per model. */
+    CLIRunner(Map *map, int seed, int iterations, const char *graphOutFile, const char *outputFile, const char *ilpOutputFile = nullptr, const char *intervalOutputFile = nullptr, bool fixseed = false, int k = -1, std::vector<int> kSweep = std::vector<int>(), bool kSweepAll = false, double plsTimeLimit = 0, double lsTimeLimit = 0, bool exact = false, SolverBudgets budgets = SolverBudgets(), double portfolioTimeLimit = 0);
 
 public Q_SLOTS:
     void run();
@@ -20,6 +43,11 @@ Q_SIGNALS:
     void finished();
 
 private:
+    bool sweepK() const;
+    /* The k of the sweep, given the number of rounds of the interval graph heuristic */
+    std::vector<int> sweptKs(int rounds) const;
+    void writeKSweep(const IGHeuristic &igh, const char *name, int cur_seed);
+
     Map *map;
     int seed;
     int iterations;
@@ -30,6 +58,14 @@ private:
     const char *intervalOutputFile;
     bool fixseed;
     int k;
+    std::vector<int> kSweep;
+    bool kSweepAll;
+    double plsTimeLimit;
+    double lsTimeLimit;
+    bool exact;
+    SolverBudgets budgets;
+    double portfolioTimeLimit;
+    std::ofstream kSweepFile;
 };
 
 #endif // CLIRUNNER_H
@@ -21,6 +21,14 @@ double poi_box_dy = -10;
 double poi_box_dw = 30;
 
 int TIME_LIMIT = 600;
+bool ILP_SPARSE = true;
+bool ILP_WARM_START = true;
+bool ILP_CHAIN = false;
+bool ILP_K_SWEEP = false;
+double ILP_COARSENING = 0;
+std::string ILP_SOLVER = "";
+int ILP_LAZY_CONFLICTS = 0;
+double ILP_HORIZON = 0;
 
 /* Determines which OpenStreetMap POIs are used for labels. This is ORed. Thus, with these
    settings, any OSM node with "amenity: parking", or "amenity: fuel", …, or "tourism: hotel",…
@@ -3,6 +3,7 @@
 
 #include <QFont>
 #include <set>
+#include <string>
 
 // Height and width of the virtual viewport moving along the trajectory, in pixels
 #define CAMERA_HEIGHT 600
@@ -40,11 +41,65 @@ extern const QFont LABEL_FONT;
 #define COMPUTE_LARGE_ILPS true
 // ILP fine-tuning
 #define PRESOLVE_ITERATIONS 15
+// The part of an ILP_HORIZON window that the next window overlaps
+#define ILP_HORIZON_OVERLAP 0.25
+// Set to false to solve the ILP for all labels at once, instead of for every connected
+// component of the conflict graph on its own (only done without k-restriction)
+#define ILP_SPLIT_COMPONENTS true
+
+// Components of the conflict graph with more vertices are not solved to optimality by
+// the branch and reduce solver (--exact), but get a greedy solution
+#define EXACT_MAX_COMPONENT_SIZE 200
+
+// Relative gap between the best solution and the best upper bound at which the solver
+// portfolio (--portfolio) considers the solution optimal. Same as Gurobi's default MIPGap.
+#define PORTFOLIO_OPTIMALITY_GAP 1e-4
 
 // Maximum time (in seconds) that the ILP should run on every instance.
 // configured in config.cpp
 extern int TIME_LIMIT;
 
+// Whether the ILP only has variables for the atomic segments within the presence intervals
+// of a label. The dense formulation (--ilp-dense) has the same optimum, and is much larger.
+// configured in config.cpp
+extern bool ILP_SPARSE;
+
+// Whether the ILP starts from the best heuristic result of its model (see --ilp-cold)
+// configured in config.cpp
+extern bool ILP_WARM_START;
+
+// Whether the ILPs of AM1, AM2 and AM3 are solved one after the other on the same model, each
+// starting from the optimum of the previous one (see --ilp-chain)
+// configured in config.cpp
+extern bool ILP_CHAIN;
+
+// Whether a k sweep (see --k-sweep) also solves the ILP of every model for all of its k, on a
+// model that is only built once (see --ilp-k-sweep and ILPAdapter::setKSweep())
+// configured in config.cpp
+extern bool ILP_K_SWEEP;
+
+// Endpoints closer than this (in the units of the visibility intervals) are snapped onto
+// common events before the ILP is built, see ILP::coarsenInstance(). 0 turns it off
+// (see --ilp-coarsen).
+// configured in config.cpp
+extern double ILP_COARSENING;
+
+// The MIP solver that optimizes the ILP, "gurobi" or "highs" (see --mip-solver). Which of them
+// exist depends on MIP_BACKENDS in tmlframework.pro; empty is the first one that does.
+// configured in config.cpp
+extern std::string ILP_SOLVER;
+
+// How lazy the conflict constraints of the ILP are (see --ilp-lazy): 0 adds all of them to the
+// model, 1-3 leave them out until a solution violates them (see MIP::LAZY_SOME, LAZY_ALL and
+// LAZY_RELAXATION). Only Gurobi has lazy constraints.
+// configured in config.cpp
+extern int ILP_LAZY_CONFLICTS;
+
+// Solve the ILP in windows of this length (in the units of the visibility intervals) one
+// after the other, see ILP::RollingHorizon. 0 solves it as a whole (see --ilp-horizon).
+// configured in config.cpp
+extern double ILP_HORIZON;
+
 /**********************************************************
  *
  *     No changes should be necessary below this line
@@ -10,7 +10,7 @@
 #include "util/debugging.h"
 
 void
-ExpandedConflictGraph::compute_compound_weight(vertex_t v, const std::set<vertex_t> &blocked)
+ExpandedConflictGraph::compute_compound_weight(vertex_t v, const VertexSet &blocked)
 {
   if (!this->compound) {
     return;
@@ -20,7 +20,7 @@ ExpandedConflictGraph::compute_compound_weight(vertex_t v, const std::set<vertex
 
   auto neighbors = boost::adjacent_vertices(v, *this);
   for (auto nit = neighbors.first; nit != neighbors.second; ++nit) {
-    if (blocked.find(*nit) != blocked.end()) {
+    if (blocked.test(*nit)) {
       compound_weight -= (*this)[*nit].weight;
     }
   }
@@ -29,7 +29,7 @@ ExpandedConflictGraph::compute_compound_weight(vertex_t v, const std::set<vertex
 }
 
 void
-ExpandedConflictGraph::compute_compound_weights(const std::set<vertex_t> &blocked)
+ExpandedConflictGraph::compute_compound_weights(const VertexSet &blocked)
 {
   if (!this->compound) {
     return;
@@ -37,7 +37,7 @@ ExpandedConflictGraph::compute_compound_weights(const std::set<vertex_t> &blocke
 
   auto vs = boost::vertices(*this);
   for (auto vit = vs.first; vit != vs.second; ++vit) {
-    if (blocked.find(*vit) != blocked.end()) {
+    if (blocked.test(*vit)) {
       (*this)[*vit].compound_weight = std::numeric_limits<double>::lowest();
     } else {
       this->compute_compound_weight(*vit, blocked);
@@ -45,6 +45,35 @@ ExpandedConflictGraph::compute_compound_weights(const std::set<vertex_t> &blocke
   }
 }
 
+bool
+ExpandedConflictGraph::block(vertex_t v, VertexSet &blocked)
+{
+  if (blocked.test(v)) {
+    return false;
+  }
+  blocked.set(v);
+
+  if (!this->compound) {
+    return true;
+  }
+
+  double weight = (*this)[v].weight;
+  auto neighbors = boost::adjacent_vertices(v, *this);
+  for (auto nit = neighbors.first; nit != neighbors.second; ++nit) {
+    if (!blocked.test(*nit)) {
+      (*this)[*nit].compound_weight -= weight;
+    }
+  }
+
+  return true;
+}
+
+bool
+ExpandedConflictGraph::is_compound() const
+{
+  return this->compound;
+}
+
 ExpandedConflictGraph *
 ExpandedConflictGraph::fromConflicts(ConflictIntervals &conflicts, VisibilityIntervals visibilityIntervals, Heuristic::ModelType mtype, bool compound)
 {
@@ -4,6 +4,7 @@
 #include <boost/graph/graph_traits.hpp>
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/graph/properties.hpp>
+#include <boost/dynamic_bitset.hpp>
 
 #include "util/setrtree.h"
 #include "conflicts/camera.h"
@@ -34,12 +35,20 @@ class ExpandedConflictGraph : public ExpandedConflictGraphBase {
 public:
   typedef boost::graph_traits<ExpandedConflictGraphBase>::vertex_descriptor vertex_t;
   typedef boost::graph_traits<ExpandedConflictGraphBase>::edge_descriptor edge_t;
+  /* Vertex descriptors are dense integers, so sets of vertices are kept as bitsets */
+  typedef boost::dynamic_bitset<> VertexSet;
 
   static ExpandedConflictGraph *fromConflicts(ConflictIntervals &conflicts, VisibilityIntervals visibilityIntervals, Heuristic::ModelType mtype, bool compound);
   static void writeToFile(const char *fileName, const ExpandedConflictGraph &g);
 
-  void compute_compound_weight(vertex_t v, const std::set<vertex_t> &blocked);
-  void compute_compound_weights(const std::set<vertex_t> &blocked);
+  void compute_compound_weight(vertex_t v, const VertexSet &blocked);
+  void compute_compound_weights(const VertexSet &blocked);
+
+  /* Adds v to blocked and subtracts its weight from the compound weights of its
+   * unblocked neighbors. Returns false if v was already blocked. */
+  bool block(vertex_t v, VertexSet &blocked);
+
+  bool is_compound() const;
 
 private:
   bool compound;
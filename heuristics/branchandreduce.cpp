@@ -0,0 +1,612 @@
+#include "branchandreduce.h"
+
+#include "config.h"
+#include "util/segmenttree.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+
+namespace {
+
+typedef std::chrono::steady_clock BRClock;
+
+// A subset of the vertices of a component
+typedef std::vector<uint64_t> Bits;
+
+// Subgraphs with at most this many vertices are memoized, up to MEMO_ENTRIES of them per component
+const size_t MEMO_VERTICES = 64;
+const size_t MEMO_ENTRIES = 1 << 20;
+
+// The deadline and the cancellation are only checked every this many branch nodes
+const long CLOCK_INTERVAL = 256;
+
+struct BRTimeout {};
+
+struct BitsHash {
+  size_t operator()(const Bits &bits) const {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (uint64_t word : bits) {
+      h = (h ^ word) * 0x100000001b3ULL;
+      h ^= h >> 29;
+    }
+    return static_cast<size_t>(h);
+  }
+};
+
+inline bool test(const Bits &bits, size_t i) {
+  return (bits[i >> 6] >> (i & 63)) & 1;
+}
+
+inline void set(Bits &bits, size_t i) {
+  bits[i >> 6] |= uint64_t(1) << (i & 63);
+}
+
+inline void reset(Bits &bits, size_t i) {
+  bits[i >> 6] &= ~(uint64_t(1) << (i & 63));
+}
+
+inline size_t count(const Bits &bits) {
+  size_t result = 0;
+  for (uint64_t word : bits) {
+    result += __builtin_popcountll(word);
+  }
+  return result;
+}
+
+inline bool empty(const Bits &bits) {
+  for (uint64_t word : bits) {
+    if (word != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+inline size_t countAnd(const Bits &a, const Bits &b) {
+  size_t result = 0;
+  for (size_t w = 0; w < a.size(); ++w) {
+    result += __builtin_popcountll(a[w] & b[w]);
+  }
+  return result;
+}
+
+template<class F>
+inline void forEach(const Bits &bits, F f) {
+  for (size_t w = 0; w < bits.size(); ++w) {
+    uint64_t word = bits[w];
+    while (word != 0) {
+      f(w * 64 + __builtin_ctzll(word));
+      word &= word - 1;
+    }
+  }
+}
+
+/* The branch and reduce search on a single component, with local vertex ids 0..n-1 */
+class BRComponent {
+public:
+  BRComponent(const std::vector<Bits> &adjacency, const std::vector<double> &weights, const std::vector<double> &starts, const std::vector<double> &ends, int k, BRClock::time_point deadline, std::function<bool()> cancelled) :
+    n(weights.size()), words((weights.size() + 63) / 64), adjacency(adjacency), weights(weights), starts(starts), ends(ends), k(k), deadline(deadline), cancelled(cancelled), nodes(0)
+  {
+    this->order.resize(this->n);
+    std::iota(this->order.begin(), this->order.end(), 0);
+    std::stable_sort(this->order.begin(), this->order.end(), [&weights](size_t a, size_t b) {
+      return weights[a] > weights[b];
+    });
+
+    if (this->k > 0) {
+      std::vector<double> coordinates(starts);
+      coordinates.insert(coordinates.end(), ends.begin(), ends.end());
+      this->overlaps.reset(coordinates);
+    }
+  }
+
+  Bits all() const {
+    Bits result(this->words, 0);
+    for (size_t v = 0; v < this->n; ++v) {
+      set(result, v);
+    }
+    return result;
+  }
+
+  /* Takes vertices by decreasing weight, as long as they fit */
+  double greedy(Bits &result) {
+    result.assign(this->words, 0);
+    Bits blocked(this->words, 0);
+    double value = 0;
+    for (size_t v : this->order) {
+      if (test(blocked, v) || !this->fits(v)) {
+        continue;
+      }
+      set(result, v);
+      value += this->weights[v];
+      for (size_t w = 0; w < this->words; ++w) {
+        blocked[w] |= this->adjacency[v][w];
+      }
+      this->take(v, 1);
+    }
+    forEach(result, [this](size_t v) { this->take(v, -1); });
+    return value;
+  }
+
+  /* The weight of a greedy clique cover: every clique contributes its heaviest vertex */
+  double upperBound(const Bits &P) const {
+    std::vector<Bits> common;
+    double bound = 0;
+    for (size_t v : this->order) {
+      if (!test(P, v)) {
+        continue;
+      }
+      bool placed = false;
+      for (Bits &clique : common) {
+        if (test(clique, v)) {
+          for (size_t w = 0; w < this->words; ++w) {
+            clique[w] &= this->adjacency[v][w];
+          }
+          placed = true;
+          break;
+        }
+      }
+      if (!placed) {
+        common.push_back(this->adjacency[v]);
+        bound += this->weights[v];
+      }
+    }
+    return bound;
+  }
+
+  /* Returns true and the optimum within P if it is larger than lowerBound, false otherwise */
+  bool solve(Bits P, double lowerBound, Bits &result, double &value) {
+    if (++this->nodes % CLOCK_INTERVAL == 0) {
+      if ((BRClock::now() >= this->deadline) || this->cancelled()) {
+        throw BRTimeout();
+      }
+    }
+
+    Bits taken(this->words, 0);
+    double takenWeight = 0;
+    if (this->k > 0) {
+      forEach(P, [this, &P](size_t v) {
+        if (!this->fits(v)) {
+          reset(P, v);
+        }
+      });
+    } else {
+      this->reduce(P, taken, takenWeight);
+    }
+
+    double lb = lowerBound - takenWeight;
+    Bits sub(this->words, 0);
+    double subValue = 0;
+    bool found;
+    if (empty(P)) {
+      found = 0 > lb + DELTA;
+    } else {
+      bool memoize = (this->k <= 0) && (count(P) <= MEMO_VERTICES);
+      auto it = memoize ? this->memo.find(P) : this->memo.end();
+      if ((it != this->memo.end()) && it->second.exact) {
+        sub = it->second.set;
+        subValue = it->second.value;
+        found = subValue > lb + DELTA;
+      } else if ((it != this->memo.end()) && (it->second.value <= lb + DELTA)) {
+        found = false;
+      } else if (this->upperBound(P) <= lb + DELTA) {
+        found = false;
+      } else {
+        std::vector<Bits> parts;
+        if (this->k <= 0) {
+          this->split(P, parts);
+        }
+        if (parts.size() > 1) {
+          found = this->solveParts(parts, lb, sub, subValue);
+        } else {
+          found = this->branch(P, lb, sub, subValue);
+        }
+
+        if (memoize && (this->memo.size() < MEMO_ENTRIES)) {
+          MemoEntry &entry = this->memo[P];
+          // a failed search only shows that the optimum is at most lb
+          entry.exact = found;
+          entry.value = found ? subValue : lb;
+          entry.set = sub;
+        }
+      }
+    }
+
+    if (!found) {
+      return false;
+    }
+    for (size_t w = 0; w < this->words; ++w) {
+      result[w] = taken[w] | sub[w];
+    }
+    value = takenWeight + subValue;
+    return true;
+  }
+
+  long getNodes() const {
+    return this->nodes;
+  }
+
+private:
+  struct MemoEntry {
+    bool exact;
+    double value;
+    Bits set;
+  };
+
+  bool fits(size_t v) const {
+    return (this->k <= 0) || (this->overlaps.max(this->starts[v], this->ends[v]) < this->k);
+  }
+
+  void take(size_t v, int delta) {
+    if (this->k > 0) {
+      this->overlaps.add(this->starts[v], this->ends[v], delta);
+    }
+  }
+
+  /* Applies the neighborhood weight and the domination reduction until neither applies */
+  void reduce(Bits &P, Bits &taken, double &takenWeight) const {
+    bool changed = true;
+    while (changed) {
+      changed = false;
+      for (size_t v : this->order) {
+        if (!test(P, v)) {
+          continue;
+        }
+        const Bits &neighbors = this->adjacency[v];
+        double neighborhood = 0;
+        forEach(P, [this, &neighbors, &neighborhood](size_t u) {
+          if (test(neighbors, u)) {
+            neighborhood += this->weights[u];
+          }
+        });
+        if (this->weights[v] >= neighborhood) {
+          set(taken, v);
+          takenWeight += this->weights[v];
+          for (size_t w = 0; w < this->words; ++w) {
+            P[w] &= ~neighbors[w];
+          }
+          reset(P, v);
+          changed = true;
+          continue;
+        }
+
+        bool dominated = false;
+        for (size_t w = 0; (w < this->words) && !dominated; ++w) {
+          uint64_t word = neighbors[w] & P[w];
+          while ((word != 0) && !dominated) {
+            size_t u = w * 64 + __builtin_ctzll(word);
+            word &= word - 1;
+            if (this->weights[u] < this->weights[v]) {
+              continue;
+            }
+            // N[u] is a subset of N[v] within P
+            dominated = true;
+            for (size_t x = 0; x < this->words; ++x) {
+              uint64_t own = (x == (v >> 6)) ? (uint64_t(1) << (v & 63)) : 0;
+              if ((this->adjacency[u][x] & P[x] & ~(neighbors[x] | own)) != 0) {
+                dominated = false;
+                break;
+              }
+            }
+          }
+        }
+        if (dominated) {
+          reset(P, v);
+          changed = true;
+        }
+      }
+    }
+  }
+
+  /* Splits P into its connected components */
+  void split(const Bits &P, std::vector<Bits> &parts) const {
+    Bits remaining = P;
+    std::vector<size_t> stack;
+    for (size_t w = 0; w < this->words; ++w) {
+      while (remaining[w] != 0) {
+        size_t start = w * 64 + __builtin_ctzll(remaining[w]);
+        Bits part(this->words, 0);
+        reset(remaining, start);
+        set(part, start);
+        stack.push_back(start);
+        while (!stack.empty()) {
+          size_t v = stack.back();
+          stack.pop_back();
+          for (size_t x = 0; x < this->words; ++x) {
+            uint64_t word = this->adjacency[v][x] & remaining[x];
+            remaining[x] &= ~word;
+            part[x] |= word;
+            while (word != 0) {
+              stack.push_back(x * 64 + __builtin_ctzll(word));
+              word &= word - 1;
+            }
+          }
+        }
+        parts.push_back(part);
+      }
+    }
+  }
+
+  /* Solves independent parts, each one against the lower bound minus what the others can contribute */
+  bool solveParts(std::vector<Bits> &parts, double lb, Bits &result, double &value) {
+    std::sort(parts.begin(), parts.end(), [](const Bits &a, const Bits &b) {
+      return count(a) < count(b);
+    });
+    std::vector<double> bounds;
+    double rest = 0;
+    for (const Bits &part : parts) {
+      bounds.push_back(this->upperBound(part));
+      rest += bounds.back();
+    }
+
+    double known = 0;
+    Bits sub(this->words, 0);
+    for (size_t i = 0; i < parts.size(); ++i) {
+      rest -= bounds[i];
+      double partValue = 0;
+      if (!this->solve(parts[i], lb - known - rest, sub, partValue)) {
+        return false;
+      }
+      known += partValue;
+      for (size_t w = 0; w < this->words; ++w) {
+        result[w] |= sub[w];
+      }
+    }
+    value = known;
+    return true;
+  }
+
+  /* Branches on the vertex of maximum degree in P: either it is in the solution or not */
+  bool branch(const Bits &P, double lb, Bits &result, double &value) {
+    size_t v = 0;
+    size_t degree = 0;
+    bool first = true;
+    forEach(P, [this, &P, &v, &degree, &first](size_t u) {
+      size_t d = countAnd(this->adjacency[u], P);
+      if (first || (d > degree) || ((d == degree) && (this->weights[u] > this->weights[v]))) {
+        v = u;
+        degree = d;
+        first = false;
+      }
+    });
+
+    bool found = false;
+    double best = lb;
+    Bits sub(this->words, 0);
+    double subValue = 0;
+
+    if (this->fits(v)) {
+      Bits with(P);
+      for (size_t w = 0; w < this->words; ++w) {
+        with[w] &= ~this->adjacency[v][w];
+      }
+      reset(with, v);
+      this->take(v, 1);
+      bool ok;
+      try {
+        ok = this->solve(with, best - this->weights[v], sub, subValue);
+      } catch (BRTimeout &) {
+        this->take(v, -1);
+        throw;
+      }
+      this->take(v, -1);
+      if (ok) {
+        found = true;
+        best = subValue + this->weights[v];
+        result = sub;
+        set(result, v);
+        value = best;
+      }
+    }
+
+    Bits without(P);
+    reset(without, v);
+    if (this->solve(without, best, sub, subValue)) {
+      found = true;
+      result = sub;
+      value = subValue;
+    }
+    return found;
+  }
+
+  size_t n;
+  size_t words;
+  const std::vector<Bits> &adjacency;
+  const std::vector<double> &weights;
+  const std::vector<double> &starts;
+  const std::vector<double> &ends;
+  int k;
+  BRClock::time_point deadline;
+  std::function<bool()> cancelled;
+
+  std::vector<size_t> order;
+  OverlapSegmentTree overlaps;
+  std::unordered_map<Bits, MemoEntry, BitsHash> memo;
+  long nodes;
+};
+
+size_t findRoot(std::vector<size_t> &parent, size_t v) {
+  while (parent[v] != v) {
+    parent[v] = parent[parent[v]];
+    v = parent[v];
+  }
+  return v;
+}
+
+void unite(std::vector<size_t> &parent, size_t a, size_t b) {
+  a = findRoot(parent, a);
+  b = findRoot(parent, b);
+  if (a != b) {
+    parent[std::max(a, b)] = std::min(a, b);
+  }
+}
+
+}
+
+BranchAndReduce::BranchAndReduce(const ExpandedConflictGraph &g, int k, double timeLimit, size_t maxComponentSize):
+  graph(g), k(k), timeLimit(timeLimit), maxComponentSize(maxComponentSize), labelIntervals(nullptr), score(0), bound(0), components(0), solvedComponents(0)
+{
+}
+
+BranchAndReduce::~BranchAndReduce()
+{
+  if (this->labelIntervals != nullptr) {
+    delete this->labelIntervals;
+  }
+}
+
+SelectionIntervals *
+BranchAndReduce::getLabelIntervals()
+{
+  return this->labelIntervals;
+}
+
+double
+BranchAndReduce::getScore() const
+{
+  return this->score;
+}
+
+double
+BranchAndReduce::getBound() const
+{
+  return this->bound;
+}
+
+bool
+BranchAndReduce::isOptimal() const
+{
+  return this->solvedComponents == this->components;
+}
+
+size_t
+BranchAndReduce::getComponents() const
+{
+  return this->components;
+}
+
+size_t
+BranchAndReduce::getSolvedComponents() const
+{
+  return this->solvedComponents;
+}
+
+void
+BranchAndReduce::run()
+{
+  const ExpandedConflictGraph &g = this->graph;
+  this->startRun();
+  BRClock::time_point deadline = this->deadlineAfter(this->timeLimit);
+  std::function<bool()> cancelled = [this]() { return this->isCancelled(); };
+
+  if (this->labelIntervals != nullptr) {
+    delete this->labelIntervals;
+  }
+  this->labelIntervals = new SelectionIntervals();
+  this->score = 0;
+  this->bound = 0;
+  this->components = 0;
+  this->solvedComponents = 0;
+
+  size_t n = boost::num_vertices(g);
+  std::vector<size_t> parent(n);
+  std::iota(parent.begin(), parent.end(), 0);
+  auto edges = boost::edges(g);
+  for (auto eit = edges.first; eit != edges.second; ++eit) {
+    unite(parent, boost::source(*eit, g), boost::target(*eit, g));
+  }
+  if (this->k > 0) {
+    // the k-restriction couples all vertices whose intervals overlap
+    std::vector<size_t> byStart(n);
+    std::iota(byStart.begin(), byStart.end(), 0);
+    std::sort(byStart.begin(), byStart.end(), [&g](size_t a, size_t b) {
+      return bg::get<0>(g[a].interval.first) < bg::get<0>(g[b].interval.first);
+    });
+    double reach = -std::numeric_limits<double>::max();
+    size_t reaching = 0;
+    for (size_t v : byStart) {
+      if (bg::get<0>(g[v].interval.first) <= reach) {
+        unite(parent, v, reaching);
+      }
+      if (bg::get<0>(g[v].interval.second) > reach) {
+        reach = bg::get<0>(g[v].interval.second);
+        reaching = v;
+      }
+    }
+  }
+
+  std::vector<std::vector<size_t>> members(n);
+  for (size_t v = 0; v < n; ++v) {
+    members[findRoot(parent, v)].push_back(v);
+  }
+  std::vector<std::vector<size_t>> parts;
+  for (std::vector<size_t> &part : members) {
+    if (!part.empty()) {
+      parts.push_back(std::move(part));
+    }
+  }
+  // small components first, so that a timeout hits as few of them as possible
+  std::stable_sort(parts.begin(), parts.end(), [](const std::vector<size_t> &a, const std::vector<size_t> &b) {
+    return a.size() < b.size();
+  });
+  this->components = parts.size();
+
+  std::vector<size_t> local(n);
+  size_t done = 0;
+  for (const std::vector<size_t> &part : parts) {
+    size_t m = part.size();
+    size_t words = (m + 63) / 64;
+    for (size_t i = 0; i < m; ++i) {
+      local[part[i]] = i;
+    }
+
+    std::vector<Bits> adjacency(m, Bits(words, 0));
+    std::vector<double> weights(m), starts(m), ends(m);
+    for (size_t i = 0; i < m; ++i) {
+      weights[i] = g[part[i]].weight;
+      starts[i] = bg::get<0>(g[part[i]].interval.first);
+      ends[i] = bg::get<0>(g[part[i]].interval.second);
+      auto neighbors = boost::adjacent_vertices(part[i], g);
+      for (auto nit = neighbors.first; nit != neighbors.second; ++nit) {
+        set(adjacency[i], local[*nit]);
+      }
+    }
+
+    BRComponent component(adjacency, weights, starts, ends, this->k, deadline, cancelled);
+    Bits solution;
+    double value = component.greedy(solution);
+    bool solved = false;
+    if ((m <= this->maxComponentSize) && (BRClock::now() < deadline) && !cancelled()) {
+      try {
+        Bits better(words, 0);
+        double betterValue = 0;
+        if (component.solve(component.all(), value, better, betterValue)) {
+          solution = better;
+          value = betterValue;
+        }
+        solved = true;
+      } catch (BRTimeout &) {
+      }
+    }
+
+    if (solved) {
+      this->solvedComponents++;
+      this->bound += value;
+    } else {
+      this->bound += component.upperBound(component.all());
+    }
+    this->score += value;
+    forEach(solution, [this, &g, &part](size_t i) {
+      this->labelIntervals->insert(g[part[i]].interval, g[part[i]].poi);
+    });
+    this->reportProgress((double)++done / parts.size(), this->score);
+  }
+
+  // records a cancellation or a passed deadline
+  this->shouldStop();
+}
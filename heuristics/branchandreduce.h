@@ -0,0 +1,54 @@
+#ifndef BRANCHANDREDUCE_H
+#define BRANCHANDREDUCE_H
+
+#include "heuristic.h"
+#include "conflicts/conflictgraph.h"
+
+/**
+ * Exact maximum weight independent set on the expanded conflict graph by branch and reduce,
+ * solving every connected component on its own.
+ *
+ * Each branch node first applies reductions (take a vertex that is at least as heavy as its
+ * remaining neighborhood, drop a vertex whose closed neighborhood contains the one of a
+ * heavier neighbor), then splits the remaining graph into its components, and prunes using
+ * a weighted clique cover as upper bound. Results of subgraphs with few vertices are
+ * memoized.
+ *
+ * With a k-restriction, reductions and splitting do not apply, and all vertices whose
+ * intervals overlap are treated as connected, which usually leaves few solvable components.
+ *
+ * Components with more than maxComponentSize vertices, and all components that are not done
+ * when the time limit is reached, get a greedy solution and contribute their clique cover
+ * bound to getBound().
+ */
+class BranchAndReduce : public Heuristic {
+public:
+  /* timeLimit is the total time budget in seconds */
+  BranchAndReduce(const ExpandedConflictGraph &g, int k = -1, double timeLimit = 60.0, size_t maxComponentSize = 200);
+  ~BranchAndReduce();
+  virtual SelectionIntervals * getLabelIntervals();
+  void run();
+
+  // after run(): weight of the solution, an upper bound on the optimum, and whether both are equal
+  double getScore() const;
+  double getBound() const;
+  bool isOptimal() const;
+
+  // after run(): number of components, and of those solved to optimality
+  size_t getComponents() const;
+  size_t getSolvedComponents() const;
+
+private:
+  const ExpandedConflictGraph &graph;
+  int k;
+  double timeLimit;
+  size_t maxComponentSize;
+
+  SelectionIntervals *labelIntervals;
+  double score;
+  double bound;
+  size_t components;
+  size_t solvedComponents;
+};
+
+#endif // BRANCHANDREDUCE_H
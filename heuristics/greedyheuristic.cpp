@@ -1,10 +1,14 @@
 #include "greedyheuristic.h"
 
-#include <queue>
+#include "util/indexedheap.h"
+
 #include <cassert>
 
 #include <boost/graph/copy.hpp>
 
+// Progress is reported, and the deadline checked, every this many vertices
+static const size_t PROGRESS_INTERVAL = 256;
+
 GreedyHeuristic::GreedyHeuristic(ExpandedConflictGraph g, int k):
   graph(g), labelIntervals(nullptr), k(k)
 {
@@ -23,54 +27,61 @@ GreedyHeuristic::make_copy()
   return result;
 }
 
-void dbg_print_overlaps(const OverlapCounterT& counter)
-{
-    for(OverlapCounterT::const_iterator it = counter.begin(); it != counter.end(); it++)
-    {
-        auto itv  = (*it).first;
-        int overlaps_count = (*it).second;
-        if(overlaps_count == 1)
-            std::cout << "in interval " << itv << " intervals do not overlap" << std::endl;
-        else
-            std::cout << "in interval " << itv << ": "<< overlaps_count << " intervals overlap" << std::endl;
-    }
-}
-
 void
 GreedyHeuristic::run()
 {
   ExpandedConflictGraph g = this->make_copy();
+  this->startRun();
 
   if (this->labelIntervals != nullptr) {
     delete this->labelIntervals;
   }
   this->labelIntervals = new SelectionIntervals();
 
-  /* Prepare the priority queue */
-  //std::priority_queue<std::pair<double, ExpandedConflictGraph::vertex_t>> vertices;
-  std::vector<ExpandedConflictGraph::vertex_t> queue;
-  std::set<ExpandedConflictGraph::vertex_t> blocked;
+  /* Prepare the priority queue. Blocked vertices are deleted lazily, i.e., they
+   * stay in the queue and are skipped once they reach the top. */
+  size_t n = boost::num_vertices(g);
+  IndexedHeap<double> queue(n);
+  ExpandedConflictGraph::VertexSet blocked(n);
+
+  /* Epoch-stamped scratch space to collect the vertices whose keys changed */
+  std::vector<unsigned int> touched_epoch(n, 0);
+  unsigned int epoch = 0;
+  std::vector<ExpandedConflictGraph::vertex_t> touched;
 
   g.compute_compound_weights(blocked);
 
+  /* The k-restriction counter works on all endpoints a selection could have */
+  if (this->k > 0) {
+    std::vector<double> endpoints;
+    endpoints.reserve(2 * n);
+    auto cvs = boost::vertices(g);
+    for (auto vit = cvs.first; vit != cvs.second; ++vit) {
+      endpoints.push_back(bg::get<0>(g[*vit].interval.first));
+      endpoints.push_back(bg::get<0>(g[*vit].interval.second));
+    }
+    this->overlap_counter.reset(endpoints);
+  }
+
   auto vs = boost::vertices(g);
   for (auto vit = vs.first; vit != vs.second; ++vit) {
     ExpandedConflictGraph::vertex_t v = *vit;
-    queue.push_back(v);
+    queue.push(v, g[v].compound_weight);
   }
 
-  std::make_heap(queue.begin(), queue.end(), [&](vertex_t &v1, vertex_t &v2) {
-    return (g[v1].compound_weight < g[v2].compound_weight);
-  });
-
-  /* Select visibilities! */
+  /* Select visibilities! Every selection so far is valid, so an interrupted run just stops. */
+  size_t popped = 0;
+  double score = 0;
   while (!queue.empty()) {
-    ExpandedConflictGraph::vertex_t v = queue.front();
-    double weight = g[v].compound_weight;
-    std::pop_heap(queue.begin(), queue.end());
-    queue.pop_back();
+    if (++popped % PROGRESS_INTERVAL == 0) {
+      this->reportProgress((double)popped / n, score);
+      if (this->shouldStop()) {
+        break;
+      }
+    }
+    ExpandedConflictGraph::vertex_t v = queue.pop();
 
-    if (blocked.find(v) != blocked.end()) {
+    if (blocked.test(v)) {
       continue;
     }
 
@@ -78,25 +89,12 @@ GreedyHeuristic::run()
 
     bool k_reached = false;
     if (this->k > 0) {
-      OverlapCounterT::interval_type map_interval = OverlapCounterT::interval_type::closed(bg::get<0>(visInterval.first), bg::get<0>(visInterval.second));
-
-      /*
-      std::cout << "||||||||||||||||||||||||||||||||||||||\n";
-      std::cout << "Our interval is: " << bg::get<0>(visInterval.first) << " -> " << bg::get<0>(visInterval.second) << "\n";
-      std::cout << "==== OVERLAP MAP: \n";
-      dbg_print_overlaps(this->overlap_counter);
-      std::cout << "----------- INTERSECTED OVERLAP MAP: \n";
-      dbg_print_overlaps(this->overlap_counter & map_interval);
-      */
-      for (auto e : (this->overlap_counter & map_interval)) {
-        if (e.second >= this->k) {
-          k_reached = true;
-          break;
-        }
-      }
-
-      if (!k_reached) {
-        this->overlap_counter += std::make_pair(map_interval, 1);
+      double start = bg::get<0>(visInterval.first);
+      double end = bg::get<0>(visInterval.second);
+      if (this->overlap_counter.max(start, end) >= this->k) {
+        k_reached = true;
+      } else {
+        this->overlap_counter.add(start, end, 1);
       }
     }
     if (k_reached) {
@@ -105,27 +103,36 @@ GreedyHeuristic::run()
 
     POI *poi = g[v].poi;
     this->labelIntervals->insert(visInterval, poi);
+    score += bg::get<0>(visInterval.second) - bg::get<0>(visInterval.first);
 
     //std::cout << "Accepting vertex " << v << ": POI " << poi->getLabel() << " from " << bg::get<0>(visInterval.first) << " -> " <<  bg::get<0>(visInterval.second) << "\n";
 
-    // Block neighbors!
+    // Block neighbors! Blocking maintains the compound weights of the vertices around
+    // the blocked ones, which then need their keys updated.
+    epoch++;
+    touched.clear();
     auto neighbors = boost::adjacent_vertices(v, g);
-    std::set<ExpandedConflictGraph::vertex_t> recompute_at;
     for (auto nit = neighbors.first; nit != neighbors.second; ++nit) {
       //std::cout << "  ---> Blocking " << *nit << "\n";
-      blocked.insert(*nit);
+      if (!g.block(*nit, blocked) || !g.is_compound()) {
+        continue;
+      }
       auto blocked_neighbors = boost::adjacent_vertices(*nit, g);
       for (auto bnit = blocked_neighbors.first; bnit != blocked_neighbors.second; ++bnit) {
-        recompute_at.insert(*bnit);
+        if (touched_epoch[*bnit] != epoch) {
+          touched_epoch[*bnit] = epoch;
+          touched.push_back(*bnit);
+        }
       }
     }
 
-    for (auto recompute : recompute_at) {
-      g.compute_compound_weight(recompute, blocked);
+    /* Blocked vertices are never selected anyways, so their keys do not need to be updated. */
+    for (auto recompute : touched) {
+      if (queue.contains(recompute) && !blocked.test(recompute)) {
+        queue.update(recompute, g[recompute].compound_weight);
+      }
     }
-
-    std::make_heap(queue.begin(), queue.end(), [&](vertex_t &v1, vertex_t &v2) {
-      return (g[v1].compound_weight < g[v2].compound_weight);
-    });
   }
+
+  this->reportProgress(this->wasInterrupted() ? (double)popped / n : 1.0, score);
 }
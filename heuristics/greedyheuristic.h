@@ -3,14 +3,7 @@
 
 #include "heuristic.h"
 #include "conflicts/conflictgraph.h"
-
-#include <boost/icl/interval_map.hpp>
-#include <boost/icl/split_interval_map.hpp>
-
-/* Most interval map related stuff is taken straight from
- * http://www.boost.org/doc/libs/1_46_1/libs/icl/doc/html/boost_icl/examples/overlap_counter.html
- */
-typedef boost::icl::interval_map<double, int> OverlapCounterT;
+#include "util/segmenttree.h"
 
 class GreedyHeuristic : public Heuristic {
 public:
@@ -28,7 +21,7 @@ private:
 
   // stuff for k-Restriction
   int k;
-  OverlapCounterT overlap_counter;
+  OverlapSegmentTree overlap_counter;
 };
 
 #endif
@@ -4,13 +4,103 @@
 #include "../conflicts/trajectoryfilter.h"
 #include "../util/setrtree.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+
 typedef SetRTree<POI *> SelectionIntervals;
 
+/* Set to true by the caller to stop running heuristics early. The caller keeps ownership. */
+typedef std::atomic<bool> CancellationToken;
+
 class Heuristic {
 public:
+  typedef std::chrono::steady_clock::time_point Deadline;
+
+  /* Receives the fraction of the work done so far (in [0, 1], only an estimate for some
+   * heuristics) and the score of the current solution */
+  typedef std::function<void(double progress, double score)> ProgressCallback;
+
+  Heuristic() : hasDeadline(false), cancellation(nullptr), interrupted(false) {}
+  virtual ~Heuristic() {}
+
+  virtual void run() = 0;
   virtual SelectionIntervals *getLabelIntervals() = 0;
 
   enum ModelType {AM1, AM2, AM3};
+
+  /* A run that passes the deadline or gets cancelled stops early, and getLabelIntervals()
+   * then returns the best (valid) solution found so far. */
+  void setDeadline(Deadline deadline) {
+    this->deadline = deadline;
+    this->hasDeadline = true;
+  }
+
+  /* Sets the deadline to the given number of seconds from now */
+  void setTimeBudget(double seconds) {
+    this->setDeadline(std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds)));
+  }
+
+  void setCancellationToken(const CancellationToken *token) {
+    this->cancellation = token;
+  }
+
+  void setProgressCallback(ProgressCallback callback) {
+    this->progressCallback = callback;
+  }
+
+  /* true if the last run stopped because of the deadline or a cancellation */
+  bool wasInterrupted() const {
+    return this->interrupted;
+  }
+
+protected:
+  /* To be called at the start of every run */
+  void startRun() {
+    this->interrupted = false;
+  }
+
+  /* true once the deadline has passed or the run was cancelled */
+  bool shouldStop() {
+    if (!this->interrupted) {
+      this->interrupted = this->isCancelled() || (this->hasDeadline && (std::chrono::steady_clock::now() >= this->deadline));
+    }
+    return this->interrupted;
+  }
+
+  /* true if the run was cancelled. Unlike shouldStop(), this may be called from several threads */
+  bool isCancelled() const {
+    return (this->cancellation != nullptr) && this->cancellation->load(std::memory_order_relaxed);
+  }
+
+  /* The earlier of the deadline and timeLimit seconds from now */
+  Deadline deadlineAfter(double timeLimit) const {
+    Deadline own = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(timeLimit));
+    return this->hasDeadline ? std::min(own, this->deadline) : own;
+  }
+
+  /* The seconds left until the deadline (at least 0), but at most limit */
+  double remainingTime(double limit) const {
+    if (!this->hasDeadline) {
+      return limit;
+    }
+    double left = std::chrono::duration<double>(this->deadline - std::chrono::steady_clock::now()).count();
+    return std::max(0.0, std::min(limit, left));
+  }
+
+  void reportProgress(double progress, double score) const {
+    if (this->progressCallback) {
+      this->progressCallback(progress, score);
+    }
+  }
+
+private:
+  bool hasDeadline;
+  Deadline deadline;
+  const CancellationToken *cancellation;
+  ProgressCallback progressCallback;
+  bool interrupted;
 };
 
 #endif
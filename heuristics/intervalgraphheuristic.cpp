@@ -6,12 +6,13 @@
 
 #include <queue>
 #include <cassert>
+#include <cmath>
 
 #include <boost/graph/copy.hpp>
 
 
-IGHeuristic::IGHeuristic(ExpandedConflictGraph g, Mode mode, int k):
-  graph(g), labelIntervals(nullptr), mode(mode), k(k)
+IGHeuristic::IGHeuristic(ExpandedConflictGraph g, Mode mode, int k, bool incremental):
+  graph(g), labelIntervals(nullptr), mode(mode), k(k), incremental(incremental)
 {
   if (this->k < 1) {
     this->k = std::numeric_limits<int>::max();
@@ -35,12 +36,30 @@ void
 IGHeuristic::run()
 {
   ExpandedConflictGraph g = this->make_copy();
+  this->startRun();
 
   if (this->labelIntervals != nullptr) {
     delete this->labelIntervals;
   }
   this->labelIntervals = new SelectionIntervals();
 
+  this->selections.clear();
+  this->roundEnds.clear();
+  this->roundScores.clear();
+  this->roundTimes.clear();
+  this->score = 0;
+  this->clock.start();
+
+  if (this->incremental) {
+    this->runIncremental(g);
+  } else {
+    this->runFromScratch(g);
+  }
+}
+
+void
+IGHeuristic::runFromScratch(ExpandedConflictGraph &g)
+{
   // set of presence intervals that can still be chosen
   std::set<ExpandedConflictGraph::vertex_t> remaining;
 
@@ -52,8 +71,10 @@ IGHeuristic::run()
       }
   }
 
+  // rounds are never interrupted, so every round that started is complete
+  size_t total = remaining.size();
   int iteration =0;
-  while(!remaining.empty() && iteration < k){
+  while(!remaining.empty() && iteration < k && !this->shouldStop()){
       iteration++;
       std::vector<ExpandedConflictGraph::vertex_t> vertices;
       std::vector<WeightedInterval> intervals;
@@ -84,7 +105,7 @@ IGHeuristic::run()
 
         ExpandedConflictGraph::vertex_t &v = vertices[wi.id()];
 
-        this->labelIntervals->insert(make_interval(wi.start(),wi.end()), g[v].poi);
+        this->select(make_interval(wi.start(),wi.end()), g[v].poi);
 
 
         remaining.erase(v);
@@ -96,100 +117,220 @@ IGHeuristic::run()
         std::for_each(current, last,
           [&](ExpandedConflictGraph::edge_descriptor it)
             {
-              ExpandedConflictGraph::vertex_t n = boost::target(it,g);
-              Interval & visInterval = g[n].interval;
-
-              assert(!intervals.empty());
-
-              if(this->mode == AM1){ // in case of AM1 we just remove all conflicting presence intervals.
-                  remaining.erase(n);
-              }else if(this->mode == AM2){ // shorten all conflicting presence intervals to their longest prefix that is conflict-free with v
-                  const std::vector<Interval> & intervals = g[it].intervals;
-
-                  const Interval & front = intervals.front();
-
-                  if(bg::get<0>(visInterval.first) + MINIMUM_SELECTION_LENGTH < std::min(bg::get<0>(front.first),bg::get<0>(visInterval.second))){ // there is a prefix.
-                     g[n].interval = make_interval(bg::get<0>(visInterval.first),
-                                                  std::min(bg::get<0>(front.first),bg::get<0>(visInterval.second)));
-                     g[n].weight = std::min(bg::get<0>(front.first),bg::get<0>(visInterval.second))-bg::get<0>(visInterval.first);
-                  }else{ // if there is no prefix then just delete the interval.
-                      remaining.erase(n);
-                  }
-
-              }else if(this->mode == AM3){
-                 const std::vector<Interval> & intervals = g[it].intervals;
-                 Interval bestChoice = make_interval(0,0); // best pre-, in- or suffix that is conlfict free
-                 assert(bg::get<0>(bestChoice.second)-bg::get<0>(bestChoice.first) >= 0);
-
-                 // consider the first interval: it may allow a prefix of n
-                 const Interval & front = intervals.front();
-                 if(bg::get<0>(visInterval.first) < std::min(bg::get<0>(front.first),bg::get<0>(visInterval.second))){
-                     bestChoice = make_interval(bg::get<0>(visInterval.first),
-                                                std::min(bg::get<0>(front.first),bg::get<0>(visInterval.second)));
-                 }
-
-
-                 for(size_t i=1; i < intervals.size(); ++i){
-                     const Interval & i1 = intervals[i-1];
-                     const Interval & i2 = intervals[i];
-
-                     double begin = std::max(bg::get<0>(visInterval.first),bg::get<0>(i1.second));
-                     double end   = std::min(bg::get<0>(visInterval.second),bg::get<0>(i2.first));
-                     if(bg::get<0>(bestChoice.second)-bg::get<0>(bestChoice.first) < end - begin){
-                        bestChoice = make_interval(begin,end);
-                     }
-                 }
-
-                 const Interval & back = intervals.back();
-
-                 if(bg::get<0>(visInterval.second) > std::max(bg::get<0>(back.second),bg::get<0>(visInterval.first))){
-                     if(bg::get<0>(bestChoice.second)-bg::get<0>(bestChoice.first) <
-                             bg::get<0>(visInterval.second) - std::max(bg::get<0>(back.second),bg::get<0>(visInterval.first))){
-                        bestChoice = make_interval(std::max(bg::get<0>(back.second),bg::get<0>(visInterval.first)),bg::get<0>(visInterval.second));
-                     }
-                 }
-
-                 if(bg::get<0>(bestChoice.second)-bg::get<0>(bestChoice.first) >= MINIMUM_SELECTION_LENGTH){
-                     g[n].interval = make_interval(bg::get<0>(bestChoice.first),
-                                                   bg::get<0>(bestChoice.second));
-                     g[n].weight = bg::get<0>(bestChoice.second)-bg::get<0>(bestChoice.first);
-                 }else{
-                     remaining.erase(n);
-                 }
+              if (!this->adaptNeighbor(g, it)) {
+                remaining.erase(boost::target(it,g));
               }
+            });
+    }
+
+    this->finishRound();
+    this->reportProgress(remaining.empty() ? 1.0 : 1.0 - (double)remaining.size() / total, this->score);
+  }
+}
+
+void
+IGHeuristic::runIncremental(ExpandedConflictGraph &g)
+{
+  IncrementalMWIS remaining(boost::num_vertices(g));
+
+  // at the beginning all vertices can be chosen.
+  auto vs = boost::vertices(g);
+  for (auto vit = vs.first; vit != vs.second; ++vit) {
+      if(g[*vit].weight > 0){
+          Interval & visInterval = g[*vit].interval;
+          remaining.update(*vit, bg::get<0>(visInterval.first), bg::get<0>(visInterval.second), g[*vit].weight);
+      }
+  }
 
-             // std::cout << boost::target(it, g) << '\n';
+  size_t total = remaining.size();
+  int iteration =0;
+  while(!remaining.empty() && iteration < k && !this->shouldStop()){
+    iteration++;
 
+    std::vector<int> mwis = remaining.compute();
 
+    // The intervals of selected vertices may still be adapted as neighbors of other
+    // selected vertices, so remember what has actually been selected first.
+    std::vector<WeightedInterval> selected;
+    for(int v : mwis){
+        selected.push_back(remaining.interval(v));
+    }
 
+#ifdef CONSISTENCY_CHECKS
+    {
+      std::vector<WeightedInterval> intervals;
+      for (auto vit = vs.first; vit != vs.second; ++vit) {
+        if (remaining.contains(*vit)) {
+          intervals.push_back(remaining.interval(*vit));
+        }
+      }
+      double expected = 0, actual = 0;
+      for (int index : computeMWIS(intervals)) {
+        expected += intervals[index].weight();
+      }
+      for (const WeightedInterval &wi : selected) {
+        actual += wi.weight();
+      }
+      assert(std::abs(expected - actual) < DELTA);
 
-            });
+      std::vector<int> all;
+      for (size_t i = 0; i < selected.size(); ++i) {
+        all.push_back(i);
+      }
+      assert(areIndependent(selected, all));
     }
+#endif
+
+    for(const WeightedInterval & wi : selected){
+        ExpandedConflictGraph::vertex_t v = wi.id();
+
+        this->select(make_interval(wi.start(),wi.end()), g[v].poi);
+
+        remaining.remove(v);
+
+        ExpandedConflictGraph::out_edge_iterator current, last;
+        std::tie(current, last) = boost::out_edges(v, g);
+
+        for (; current != last; ++current) {
+          ExpandedConflictGraph::vertex_t n = boost::target(*current, g);
+          if (!remaining.contains(n)) {
+            continue;
+          }
+
+          if (this->adaptNeighbor(g, *current)) {
+            Interval & visInterval = g[n].interval;
+            remaining.update(n, bg::get<0>(visInterval.first), bg::get<0>(visInterval.second), g[n].weight);
+          } else {
+            remaining.remove(n);
+          }
+        }
+    }
+
+    this->finishRound();
+    this->reportProgress(remaining.empty() ? 1.0 : 1.0 - (double)remaining.size() / total, this->score);
+  }
 }
 
+void
+IGHeuristic::select(Interval interval, POI *poi)
+{
+  this->labelIntervals->insert(interval, poi);
+  this->selections.push_back(std::make_pair(interval, poi));
+  this->score += bg::get<0>(interval.second) - bg::get<0>(interval.first);
+}
 
+void
+IGHeuristic::finishRound()
+{
+  this->roundEnds.push_back(this->selections.size());
+  this->roundScores.push_back(this->score);
+  this->roundTimes.push_back(this->clock.get());
+}
 
+int
+IGHeuristic::getRounds() const
+{
+  return this->roundEnds.size();
+}
 
+size_t
+IGHeuristic::roundsForK(int k) const
+{
+  if ((k < 1) || ((size_t)k > this->roundEnds.size())) {
+    return this->roundEnds.size();
+  }
+  return k;
+}
 
+double
+IGHeuristic::getScoreForK(int k) const
+{
+  size_t rounds = this->roundsForK(k);
+  return rounds == 0 ? 0 : this->roundScores[rounds - 1];
+}
 
+double
+IGHeuristic::getTimeForK(int k) const
+{
+  size_t rounds = this->roundsForK(k);
+  return rounds == 0 ? 0 : this->roundTimes[rounds - 1];
+}
 
-//  /* Select visibilities! */
-//  while (!vertices.empty()) {
-//    std::pair<double, ConflictGraph::vertex_t> top = vertices.top();
-//    vertices.pop();
-//    ConflictGraph::vertex_t v = top.second;
-//    if (blocked.find(v) != blocked.end()) {
-//      continue;
-//    }
+SelectionIntervals *
+IGHeuristic::getLabelIntervalsForK(int k) const
+{
+  size_t rounds = this->roundsForK(k);
+  size_t count = rounds == 0 ? 0 : this->roundEnds[rounds - 1];
 
-//    Interval visInterval = g[v].interval;
-//    POI *poi = g[v].poi;
-//    this->labelIntervals->insert(visInterval, poi);
+  SelectionIntervals *result = new SelectionIntervals();
+  for (size_t i = 0; i < count; ++i) {
+    result->insert(this->selections[i].first, this->selections[i].second);
+  }
+  return result;
+}
+
+bool
+IGHeuristic::adaptNeighbor(ExpandedConflictGraph &g, ExpandedConflictGraph::edge_descriptor it)
+{
+  ExpandedConflictGraph::vertex_t n = boost::target(it,g);
+  Interval & visInterval = g[n].interval;
+
+  if(this->mode == AM1){ // in case of AM1 we just remove all conflicting presence intervals.
+      return false;
+  }else if(this->mode == AM2){ // shorten all conflicting presence intervals to their longest prefix that is conflict-free with v
+      const std::vector<Interval> & intervals = g[it].intervals;
+
+      const Interval & front = intervals.front();
+
+      if(bg::get<0>(visInterval.first) + MINIMUM_SELECTION_LENGTH < std::min(bg::get<0>(front.first),bg::get<0>(visInterval.second))){ // there is a prefix.
+         g[n].interval = make_interval(bg::get<0>(visInterval.first),
+                                      std::min(bg::get<0>(front.first),bg::get<0>(visInterval.second)));
+         g[n].weight = std::min(bg::get<0>(front.first),bg::get<0>(visInterval.second))-bg::get<0>(visInterval.first);
+      }else{ // if there is no prefix then just delete the interval.
+          return false;
+      }
+
+  }else if(this->mode == AM3){
+     const std::vector<Interval> & intervals = g[it].intervals;
+     Interval bestChoice = make_interval(0,0); // best pre-, in- or suffix that is conlfict free
+     assert(bg::get<0>(bestChoice.second)-bg::get<0>(bestChoice.first) >= 0);
+
+     // consider the first interval: it may allow a prefix of n
+     const Interval & front = intervals.front();
+     if(bg::get<0>(visInterval.first) < std::min(bg::get<0>(front.first),bg::get<0>(visInterval.second))){
+         bestChoice = make_interval(bg::get<0>(visInterval.first),
+                                    std::min(bg::get<0>(front.first),bg::get<0>(visInterval.second)));
+     }
+
+
+     for(size_t i=1; i < intervals.size(); ++i){
+         const Interval & i1 = intervals[i-1];
+         const Interval & i2 = intervals[i];
+
+         double begin = std::max(bg::get<0>(visInterval.first),bg::get<0>(i1.second));
+         double end   = std::min(bg::get<0>(visInterval.second),bg::get<0>(i2.first));
+         if(bg::get<0>(bestChoice.second)-bg::get<0>(bestChoice.first) < end - begin){
+            bestChoice = make_interval(begin,end);
+         }
+     }
+
+     const Interval & back = intervals.back();
+
+     if(bg::get<0>(visInterval.second) > std::max(bg::get<0>(back.second),bg::get<0>(visInterval.first))){
+         if(bg::get<0>(bestChoice.second)-bg::get<0>(bestChoice.first) <
+                 bg::get<0>(visInterval.second) - std::max(bg::get<0>(back.second),bg::get<0>(visInterval.first))){
+            bestChoice = make_interval(std::max(bg::get<0>(back.second),bg::get<0>(visInterval.first)),bg::get<0>(visInterval.second));
+         }
+     }
+
+     if(bg::get<0>(bestChoice.second)-bg::get<0>(bestChoice.first) >= MINIMUM_SELECTION_LENGTH){
+         g[n].interval = make_interval(bg::get<0>(bestChoice.first),
+                                       bg::get<0>(bestChoice.second));
+         g[n].weight = bg::get<0>(bestChoice.second)-bg::get<0>(bestChoice.first);
+     }else{
+         return false;
+     }
+  }
 
-//    // Block neighbors!
-//    auto neighbors = boost::adjacent_vertices(v, g);
-//    for (auto nit = neighbors.first; nit != neighbors.second; ++nit) {
-//      blocked.insert(*nit);
-//    }
-//  }
+  return true;
 }
@@ -5,6 +5,7 @@
 
 #include "heuristic.h"
 #include "conflicts/conflictgraph.h"
+#include "util/clock.h"
 
 #include <boost/icl/interval_map.hpp>
 
@@ -15,19 +16,53 @@ class IGHeuristic : public Heuristic {
 
 public:
   enum Mode {AM1,AM2,AM3};
-    IGHeuristic(ExpandedConflictGraph g, Mode mode = AM1, int k = std::numeric_limits<int>::max());
+  /**
+   * In incremental mode, the intervals are kept sorted across rounds and the MWIS is only
+   * recomputed right of the leftmost interval that changed in the previous round.
+   * Otherwise, every round sorts all remaining intervals and starts over.
+   */
+    IGHeuristic(ExpandedConflictGraph g, Mode mode = AM1, int k = std::numeric_limits<int>::max(), bool incremental = true);
   virtual SelectionIntervals * getLabelIntervals();
   void run();
 
+  /* Round i does not depend on k, k only caps the number of rounds. Thus, a run with
+   * an unbounded k contains the solutions for all smaller k as prefixes, which can be
+   * extracted with the following functions. k < 1 means unbounded. */
+  int getRounds() const;
+  double getScoreForK(int k) const;
+  double getTimeForK(int k) const;
+  // The caller takes ownership of the returned intervals.
+  SelectionIntervals * getLabelIntervalsForK(int k) const;
+
 private:
   ExpandedConflictGraph make_copy();
 
+  void runFromScratch(ExpandedConflictGraph &g);
+  void runIncremental(ExpandedConflictGraph &g);
+
+  // Adapts the presence interval of the neighbor across e of a selected vertex according to
+  // the mode. Returns false if nothing of the neighbor can be selected anymore.
+  bool adaptNeighbor(ExpandedConflictGraph &g, ExpandedConflictGraph::edge_descriptor e);
+
+  void select(Interval interval, POI *poi);
+  void finishRound();
+  size_t roundsForK(int k) const;
+
   const ExpandedConflictGraph graph;
 
   SelectionIntervals *labelIntervals;
   ModelType mtype;
   Mode  mode;
   int k;
+  bool incremental;
+
+  // per-round checkpoints, in the order of selection
+  std::vector<std::pair<Interval, POI *>> selections;
+  std::vector<size_t> roundEnds;
+  std::vector<double> roundScores;
+  std::vector<double> roundTimes;
+  double score;
+  Clock clock;
 };
 
 #endif // INTERVALGRAPHHEURISTIC_H
@@ -0,0 +1,592 @@
+#include "localsearch.h"
+
+#include "config.h"
+#include "util/segmenttree.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <functional>
+#include <map>
+
+namespace {
+
+typedef std::chrono::steady_clock LSClock;
+
+const size_t NONE = static_cast<size_t>(-1);
+
+// Number of the heaviest candidates per selected interval that are combined for (1,2)-swaps
+const size_t SWAP_CANDIDATES = 32;
+
+// The deadline and the cancellation are only checked every this many move attempts
+const int CLOCK_INTERVAL = 64;
+
+/* A maximal interval in which a POI may be displayed. At most one interval is selected per presence. */
+struct LSPresence {
+  size_t poi;
+  double start;
+  double end;
+  size_t item;
+  // the points at which the model lets a selection end (conflict starts and the end of the
+  // presence) and begin (conflict ends and the start of the presence), sorted
+  std::vector<double> ends;
+  std::vector<double> begins;
+};
+
+/* A selected interval. Items that belong to no presence of the graph are never moved. */
+struct LSItem {
+  size_t poi;
+  size_t presence;
+  double start;
+  double end;
+  bool alive;
+};
+
+/* A vertex of the expanded conflict graph */
+struct LSCandidate {
+  size_t poi;
+  size_t presence;
+  double start;
+  double end;
+};
+
+class LSState {
+public:
+  LSState(Heuristic::ModelType mtype, int k, LSClock::time_point deadline, std::function<bool()> cancelled) :
+    mtype(mtype), k(k), deadline(deadline), cancelled(cancelled), score(0), moves(0), attempts(0), timeout(false) {}
+
+  size_t poiIndex(POI *poi) {
+    auto it = this->index.find(poi);
+    if (it != this->index.end()) {
+      return it->second;
+    }
+    size_t i = this->pois.size();
+    this->index[poi] = i;
+    this->pois.push_back(poi);
+    this->partners.push_back(std::vector<size_t>());
+    this->poiItems.push_back(std::vector<size_t>());
+    this->poiPresences.push_back(std::vector<size_t>());
+    return i;
+  }
+
+  void addPresence(size_t poi, double start, double end) {
+    for (size_t i : this->poiPresences[poi]) {
+      if ((this->presences[i].start == start) && (this->presences[i].end == end)) {
+        return;
+      }
+    }
+    this->poiPresences[poi].push_back(this->presences.size());
+    this->presences.push_back(LSPresence{poi, start, end, NONE, {}, {}});
+  }
+
+  void addConflict(size_t p, size_t q, double start, double end) {
+    std::vector<std::pair<double, double>> &list = this->conflictList(p, q);
+    if (list.empty()) {
+      this->partners[p].push_back(q);
+      this->partners[q].push_back(p);
+    }
+    list.push_back(std::make_pair(start, end));
+  }
+
+  void addCandidate(size_t poi, double start, double end) {
+    this->candidates.push_back(LSCandidate{poi, this->findPresence(poi, start, end), start, end});
+  }
+
+  void addItem(size_t poi, double start, double end) {
+    size_t presence = this->findPresence(poi, start, end);
+    if ((presence != NONE) && (this->presences[presence].item != NONE)) {
+      // a second interval in the same presence is kept, but never moved
+      presence = NONE;
+    }
+    this->insert(LSItem{poi, presence, start, end, true});
+  }
+
+  void run() {
+    for (LSPresence &presence : this->presences) {
+      presence.ends.push_back(presence.end);
+      presence.begins.push_back(presence.start);
+      for (size_t q : this->partners[presence.poi]) {
+        for (const std::pair<double, double> &c : *this->findConflicts(presence.poi, q)) {
+          if ((presence.start <= c.first) && (c.first <= presence.end)) {
+            presence.ends.push_back(c.first);
+          }
+          if ((presence.start <= c.second) && (c.second <= presence.end)) {
+            presence.begins.push_back(c.second);
+          }
+        }
+      }
+      std::sort(presence.ends.begin(), presence.ends.end());
+      std::sort(presence.begins.begin(), presence.begins.end());
+    }
+
+    if (this->k > 0) {
+      // every interval of a move begins and ends at one of these points
+      std::vector<double> coordinates;
+      for (const LSPresence &presence : this->presences) {
+        coordinates.push_back(presence.start);
+        coordinates.push_back(presence.end);
+      }
+      for (const auto &pair : this->conflicts) {
+        for (const std::pair<double, double> &c : pair.second) {
+          coordinates.push_back(c.first);
+          coordinates.push_back(c.second);
+        }
+      }
+      for (const LSCandidate &c : this->candidates) {
+        coordinates.push_back(c.start);
+        coordinates.push_back(c.end);
+      }
+      for (const LSItem &item : this->items) {
+        coordinates.push_back(item.start);
+        coordinates.push_back(item.end);
+      }
+      this->overlaps.reset(coordinates, true);
+      for (const LSItem &item : this->items) {
+        this->overlaps.add(item.start, item.end, 1);
+      }
+    }
+
+    // heavier candidates are tried first
+    std::stable_sort(this->candidates.begin(), this->candidates.end(), [](const LSCandidate &a, const LSCandidate &b) {
+      return (a.end - a.start) > (b.end - b.start);
+    });
+
+    bool improved = true;
+    while (improved && !this->expired()) {
+      improved = false;
+      if (this->mtype != Heuristic::AM1) {
+        improved |= this->extend();
+      }
+      improved |= this->insertFree();
+      improved |= this->swap();
+    }
+  }
+
+  double getScore() const {
+    return this->score;
+  }
+
+  long getMoves() const {
+    return this->moves;
+  }
+
+  void write(SelectionIntervals *result) const {
+    for (const LSItem &item : this->items) {
+      if (item.alive) {
+        result->insert(make_interval(item.start, item.end), this->pois[item.poi]);
+      }
+    }
+  }
+
+private:
+  std::vector<std::pair<double, double>> &conflictList(size_t p, size_t q) {
+    return this->conflicts[std::make_pair(std::min(p, q), std::max(p, q))];
+  }
+
+  const std::vector<std::pair<double, double>> *findConflicts(size_t p, size_t q) const {
+    auto it = this->conflicts.find(std::make_pair(std::min(p, q), std::max(p, q)));
+    return it == this->conflicts.end() ? nullptr : &it->second;
+  }
+
+  size_t findPresence(size_t poi, double start, double end) const {
+    for (size_t i : this->poiPresences[poi]) {
+      const LSPresence &presence = this->presences[i];
+      if ((presence.start <= start + DELTA) && (end <= presence.end + DELTA)) {
+        return i;
+      }
+    }
+    return NONE;
+  }
+
+  bool expired() {
+    if (!this->timeout && (++this->attempts % CLOCK_INTERVAL == 0)) {
+      this->timeout = (LSClock::now() >= this->deadline) || this->cancelled();
+    }
+    return this->timeout;
+  }
+
+  /* true if [s1, e1] of p and [s2, e2] of q are in conflict */
+  bool conflicting(size_t p, double s1, double e1, size_t q, double s2, double e2) const {
+    const std::vector<std::pair<double, double>> *list = this->findConflicts(p, q);
+    if (list == nullptr) {
+      return false;
+    }
+    for (const std::pair<double, double> &c : *list) {
+      double lo = std::max(c.first, std::max(s1, s2));
+      double hi = std::min(c.second, std::min(e1, e2));
+      if (hi - lo > DELTA) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /* Collects the selected intervals that prevent inserting the candidate, but stops after limit of them */
+  void blockers(const LSCandidate &c, size_t limit, std::vector<size_t> &result) const {
+    result.clear();
+    if (this->presences[c.presence].item != NONE) {
+      result.push_back(this->presences[c.presence].item);
+    }
+    for (size_t q : this->partners[c.poi]) {
+      for (size_t b : this->poiItems[q]) {
+        if (result.size() >= limit) {
+          return;
+        }
+        const LSItem &item = this->items[b];
+        if (this->conflicting(c.poi, c.start, c.end, q, item.start, item.end)) {
+          result.push_back(b);
+        }
+      }
+    }
+  }
+
+  /* true if adding the given intervals after removing the item removed keeps at most k intervals
+   * overlapping. The selection fits, so only the added intervals can exceed k. */
+  bool fitsK(const std::vector<std::pair<double, double>> &added, size_t removed) {
+    if (this->k <= 0) {
+      return true;
+    }
+    if (removed != NONE) {
+      this->overlaps.add(this->items[removed].start, this->items[removed].end, -1);
+    }
+    for (const std::pair<double, double> &interval : added) {
+      this->overlaps.add(interval.first, interval.second, 1);
+    }
+    bool fits = true;
+    for (const std::pair<double, double> &interval : added) {
+      fits = fits && (this->overlaps.max(interval.first, interval.second) <= this->k);
+    }
+    for (const std::pair<double, double> &interval : added) {
+      this->overlaps.add(interval.first, interval.second, -1);
+    }
+    if (removed != NONE) {
+      this->overlaps.add(this->items[removed].start, this->items[removed].end, 1);
+    }
+    return fits;
+  }
+
+  /* Extends every movable item as far as possible. For AM2 only the end moves. */
+  bool extend() {
+    bool improved = false;
+    for (size_t i = 0; (i < this->items.size()) && !this->expired(); ++i) {
+      LSItem &item = this->items[i];
+      if (!item.alive || (item.presence == NONE)) {
+        continue;
+      }
+      const LSPresence &presence = this->presences[item.presence];
+
+      double right = presence.end;
+      double left = presence.start;
+      for (size_t q : this->partners[item.poi]) {
+        const std::vector<std::pair<double, double>> &list = *this->findConflicts(item.poi, q);
+        for (size_t b : this->poiItems[q]) {
+          const LSItem &other = this->items[b];
+          for (const std::pair<double, double> &c : list) {
+            double lo = std::max(c.first, other.start);
+            double hi = std::min(c.second, other.end);
+            if (hi - lo <= DELTA) {
+              continue;
+            }
+            if (hi - std::max(lo, item.start) > DELTA) {
+              right = std::min(right, std::max(lo, item.end));
+            }
+            if ((this->mtype == Heuristic::AM3) && (std::min(hi, item.end) - lo > DELTA)) {
+              left = std::max(left, std::min(hi, item.start));
+            }
+          }
+        }
+      }
+      // up to where k other intervals overlap, the item itself does not reach beyond its ends
+      if (this->k > 0) {
+        if (right > item.end) {
+          right = this->overlaps.firstReaching(item.end, right, this->k);
+        }
+        if ((this->mtype == Heuristic::AM3) && (left < item.start)) {
+          left = this->overlaps.lastReaching(item.start, left, this->k);
+        }
+      }
+      // back to the nearest points the model allows, so that the item stays a vertex of the graph
+      auto lastEnd = std::upper_bound(presence.ends.begin(), presence.ends.end(), right);
+      right = (lastEnd != presence.ends.begin()) ? *(lastEnd - 1) : item.end;
+      auto firstBegin = std::lower_bound(presence.begins.begin(), presence.begins.end(), left);
+      left = (firstBegin != presence.begins.end()) ? *firstBegin : item.start;
+
+      double start = item.start;
+      double end = item.end;
+      if (right - item.end > DELTA) {
+        this->score += right - item.end;
+        item.end = right;
+        this->moves++;
+        improved = true;
+      }
+      if ((this->mtype == Heuristic::AM3) && (item.start - left > DELTA)) {
+        this->score += item.start - left;
+        item.start = left;
+        this->moves++;
+        improved = true;
+      }
+      if ((this->k > 0) && ((item.start != start) || (item.end != end))) {
+        this->overlaps.add(start, end, -1);
+        this->overlaps.add(item.start, item.end, 1);
+      }
+    }
+    return improved;
+  }
+
+  /* Inserts every candidate that fits into the selection */
+  bool insertFree() {
+    bool improved = false;
+    std::vector<size_t> blocking;
+    for (const LSCandidate &c : this->candidates) {
+      if (this->expired()) {
+        break;
+      }
+      if ((c.presence == NONE) || (this->presences[c.presence].item != NONE)) {
+        continue;
+      }
+      this->blockers(c, 1, blocking);
+      if (blocking.empty() && this->fitsK({std::make_pair(c.start, c.end)}, NONE)) {
+        this->insert(LSItem{c.poi, c.presence, c.start, c.end, true});
+        this->moves++;
+        improved = true;
+      }
+    }
+    return improved;
+  }
+
+  /* Replaces single items by one or two heavier candidates that are only blocked by them */
+  bool swap() {
+    std::vector<std::vector<size_t>> blocked(this->items.size());
+    std::vector<size_t> blocking;
+    for (size_t v = 0; (v < this->candidates.size()) && !this->expired(); ++v) {
+      const LSCandidate &c = this->candidates[v];
+      if (c.presence == NONE) {
+        continue;
+      }
+      this->blockers(c, 2, blocking);
+      if ((blocking.size() == 1) && (this->items[blocking[0]].presence != NONE)) {
+        // candidates are sorted by weight, and so is every list
+        blocked[blocking[0]].push_back(v);
+      }
+    }
+
+    bool improved = false;
+    for (size_t a = 0; (a < blocked.size()) && !this->expired(); ++a) {
+      if (!this->items[a].alive || blocked[a].empty()) {
+        continue;
+      }
+      double weight = this->items[a].end - this->items[a].start;
+
+      // the lists were built before any move of this pass, so every candidate is checked again
+      std::vector<size_t> valid;
+      for (size_t v : blocked[a]) {
+        if (valid.size() >= SWAP_CANDIDATES) {
+          break;
+        }
+        this->blockers(this->candidates[v], 2, blocking);
+        if ((blocking.size() == 1) && (blocking[0] == a)) {
+          valid.push_back(v);
+        }
+      }
+
+      bool done = false;
+      for (size_t i = 0; (i < valid.size()) && !done; ++i) {
+        const LSCandidate &c = this->candidates[valid[i]];
+        if ((c.end - c.start > weight + DELTA) && this->fitsK({std::make_pair(c.start, c.end)}, a)) {
+          this->replace(a, {valid[i]});
+          done = true;
+        }
+      }
+      for (size_t i = 0; (i < valid.size()) && !done; ++i) {
+        const LSCandidate &c1 = this->candidates[valid[i]];
+        for (size_t j = i + 1; (j < valid.size()) && !done; ++j) {
+          const LSCandidate &c2 = this->candidates[valid[j]];
+          if ((c1.end - c1.start) + (c2.end - c2.start) <= weight + DELTA) {
+            break;
+          }
+          if ((c1.presence == c2.presence) || this->conflicting(c1.poi, c1.start, c1.end, c2.poi, c2.start, c2.end)) {
+            continue;
+          }
+          if (this->fitsK({std::make_pair(c1.start, c1.end), std::make_pair(c2.start, c2.end)}, a)) {
+            this->replace(a, {valid[i], valid[j]});
+            done = true;
+          }
+        }
+      }
+      improved |= done;
+    }
+    return improved;
+  }
+
+  void insert(const LSItem &item) {
+    size_t i = this->items.size();
+    this->items.push_back(item);
+    this->poiItems[item.poi].push_back(i);
+    if (item.presence != NONE) {
+      this->presences[item.presence].item = i;
+    }
+    if (this->k > 0) {
+      this->overlaps.add(item.start, item.end, 1);
+    }
+    this->score += item.end - item.start;
+  }
+
+  void replace(size_t a, const std::vector<size_t> &added) {
+    LSItem &item = this->items[a];
+    item.alive = false;
+    std::vector<size_t> &list = this->poiItems[item.poi];
+    list.erase(std::find(list.begin(), list.end(), a));
+    this->presences[item.presence].item = NONE;
+    if (this->k > 0) {
+      this->overlaps.add(item.start, item.end, -1);
+    }
+    this->score -= item.end - item.start;
+
+    for (size_t v : added) {
+      const LSCandidate &c = this->candidates[v];
+      this->insert(LSItem{c.poi, c.presence, c.start, c.end, true});
+    }
+    this->moves++;
+  }
+
+  Heuristic::ModelType mtype;
+  int k;
+  LSClock::time_point deadline;
+  std::function<bool()> cancelled;
+
+  std::map<POI *, size_t> index;
+  std::vector<POI *> pois;
+  std::vector<std::vector<size_t>> partners;
+  std::map<std::pair<size_t, size_t>, std::vector<std::pair<double, double>>> conflicts;
+
+  std::vector<LSPresence> presences;
+  std::vector<std::vector<size_t>> poiPresences;
+  std::vector<LSItem> items;
+  std::vector<std::vector<size_t>> poiItems;
+  std::vector<LSCandidate> candidates;
+  // the selected intervals, as open intervals, once run() has started
+  OverlapSegmentTree overlaps;
+
+  double score;
+  long moves;
+  long attempts;
+  bool timeout;
+};
+
+#ifdef CONSISTENCY_CHECKS
+/* The score after extending a selection of a and one of b, which are both present in [0, 10]
+ * and conflict in [4, 8] */
+double extended(Heuristic::ModelType mtype, double aStart, double aEnd, double bStart, double bEnd) {
+  POI a("a", Position(0, 0), {}, 0);
+  POI b("b", Position(0, 0), {}, 1);
+  LSState state(mtype, -1, LSClock::now() + std::chrono::seconds(1), []() { return false; });
+  size_t p = state.poiIndex(&a);
+  size_t q = state.poiIndex(&b);
+  state.addConflict(p, q, 4, 8);
+  state.addPresence(p, 0, 10);
+  state.addPresence(q, 0, 10);
+  state.addItem(p, aStart, aEnd);
+  state.addItem(q, bStart, bEnd);
+  state.run();
+  return state.getScore();
+}
+
+bool testExtend() {
+  // b starts within the conflict, so a may only end at its start 4, not at 5
+  assert(extended(Heuristic::AM2, 0, 2, 5, 10) == 9);
+  // b ends within the conflict, so a may only begin at its end 8, not at 5, and neither moves
+  assert(extended(Heuristic::AM3, 6, 10, 0, 5) == 9);
+  return true;
+}
+
+// runs the test directly after starting the program.
+bool extendTested = testExtend();
+#endif
+
+}
+
+LocalSearch::LocalSearch(SelectionIntervals *initial, const ExpandedConflictGraph &g, ConflictIntervals &conflicts, ModelType mtype, int k, double timeLimit):
+  initial(initial), graph(g), conflicts(conflicts), mtype(mtype), k(k), timeLimit(timeLimit), labelIntervals(nullptr), initialScore(0), score(0), moves(0)
+{
+}
+
+LocalSearch::~LocalSearch()
+{
+  if (this->labelIntervals != nullptr) {
+    delete this->labelIntervals;
+  }
+}
+
+SelectionIntervals *
+LocalSearch::getLabelIntervals()
+{
+  return this->labelIntervals;
+}
+
+double
+LocalSearch::getInitialScore() const
+{
+  return this->initialScore;
+}
+
+double
+LocalSearch::getScore() const
+{
+  return this->score;
+}
+
+long
+LocalSearch::getMoves() const
+{
+  return this->moves;
+}
+
+void
+LocalSearch::run()
+{
+  const ExpandedConflictGraph &g = this->graph;
+  this->startRun();
+  LSClock::time_point deadline = this->deadlineAfter(this->timeLimit);
+
+  if (this->labelIntervals != nullptr) {
+    delete this->labelIntervals;
+  }
+  this->labelIntervals = new SelectionIntervals();
+
+  LSState state(this->mtype, this->k, deadline, [this]() { return this->isCancelled(); });
+
+  auto all = bgi::satisfies([](Interval const &) { return true; });
+  for (auto conflict : this->conflicts.queryFull(all)) {
+    if (conflict.second.size() != 2) {
+      continue;
+    }
+    size_t p = state.poiIndex(*conflict.second.begin());
+    size_t q = state.poiIndex(*conflict.second.rbegin());
+    state.addConflict(p, q, bg::get<0>(conflict.first.first), bg::get<0>(conflict.first.second));
+  }
+
+  auto vertices = boost::vertices(g);
+  for (auto vit = vertices.first; vit != vertices.second; ++vit) {
+    const Interval &visibility = g[*vit].origVisibility;
+    state.addPresence(state.poiIndex(g[*vit].poi), bg::get<0>(visibility.first), bg::get<0>(visibility.second));
+  }
+  for (auto vit = vertices.first; vit != vertices.second; ++vit) {
+    state.addCandidate(state.poiIndex(g[*vit].poi), bg::get<0>(g[*vit].interval.first), bg::get<0>(g[*vit].interval.second));
+  }
+
+  if (this->initial != nullptr) {
+    for (auto selection : this->initial->queryFull(all)) {
+      state.addItem(state.poiIndex(selection.second), bg::get<0>(selection.first.first), bg::get<0>(selection.first.second));
+    }
+  }
+  this->initialScore = state.getScore();
+
+  state.run();
+
+  // records a cancellation or a passed deadline
+  this->shouldStop();
+
+  this->score = state.getScore();
+  this->moves = state.getMoves();
+  state.write(this->labelIntervals);
+}
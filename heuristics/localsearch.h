@@ -0,0 +1,51 @@
+#ifndef LOCALSEARCH_H
+#define LOCALSEARCH_H
+
+#include "heuristic.h"
+#include "conflicts/conflictgraph.h"
+
+/**
+ * Improves an existing selection (e.g. the result of the greedy or the interval graph
+ * heuristic) by local search, until no move improves it, the time budget runs out, or the
+ * deadline passes or the run is cancelled (see Heuristic).
+ *
+ * The moves are:
+ *  - extending a selected interval within its presence as far as conflicts and the
+ *    k-restriction allow (only the end for AM2, both sides for AM3, never for AM1),
+ *  - inserting a vertex of the expanded conflict graph that fits into the selection,
+ *  - (1,1)- and (1,2)-swaps, which replace one selected interval by one or two graph
+ *    vertices that are blocked by nothing but that interval.
+ *
+ * Validity is checked like the ResultConsistencyChecker does: two intervals conflict if
+ * they and a conflict interval share a part of positive length, and at most k intervals
+ * may overlap (touching intervals do not). The input must be valid in that sense. The
+ * overlaps are counted by an OverlapSegmentTree on the selected intervals.
+ */
+class LocalSearch : public Heuristic {
+public:
+  /* g must be the graph of the given model. timeLimit is the time budget in seconds. */
+  LocalSearch(SelectionIntervals *initial, const ExpandedConflictGraph &g, ConflictIntervals &conflicts, ModelType mtype, int k = -1, double timeLimit = 1.0);
+  ~LocalSearch();
+  virtual SelectionIntervals * getLabelIntervals();
+  void run();
+
+  // total length of the input and of the improved selection, and the number of improving moves, after run()
+  double getInitialScore() const;
+  double getScore() const;
+  long getMoves() const;
+
+private:
+  SelectionIntervals *initial;
+  const ExpandedConflictGraph &graph;
+  ConflictIntervals &conflicts;
+  ModelType mtype;
+  int k;
+  double timeLimit;
+
+  SelectionIntervals *labelIntervals;
+  double initialScore;
+  double score;
+  long moves;
+};
+
+#endif // LOCALSEARCH_H
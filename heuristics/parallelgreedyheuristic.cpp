@@ -0,0 +1,237 @@
+#include "parallelgreedyheuristic.h"
+
+#include "config.h"
+#include "util/segmenttree.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace {
+
+typedef ExpandedConflictGraph::vertex_t Vertex;
+
+// Phases with fewer items than this many per thread run on fewer threads
+const size_t PARALLEL_GRAIN = 4096;
+
+// BLOCKED vertices are neighbors of selected ones, DROPPED ones would have exceeded k
+enum State : unsigned char {ACTIVE, SELECTED, BLOCKED, DROPPED};
+
+/* Calls f(t, i) for all i < count, with the range split into contiguous chunks, one for each
+ * thread t. The first chunk runs on the calling thread. */
+template <typename F>
+void parallelFor(size_t count, int threads, F f)
+{
+  size_t chunks = std::max((size_t)1, std::min((size_t)threads, count / PARALLEL_GRAIN));
+  size_t chunkSize = (count + chunks - 1) / chunks;
+
+  auto work = [count, chunkSize, &f](size_t t) {
+    size_t end = std::min(count, (t + 1) * chunkSize);
+    for (size_t i = t * chunkSize; i < end; ++i) {
+      f(t, i);
+    }
+  };
+
+  std::vector<std::thread> pool;
+  for (size_t t = 1; t < chunks; ++t) {
+    pool.push_back(std::thread(work, t));
+  }
+  work(0);
+  for (std::thread &thread : pool) {
+    thread.join();
+  }
+}
+
+/* Appends all per-thread vectors to one, in thread order */
+void concat(std::vector<std::vector<Vertex>> &parts, std::vector<Vertex> &result)
+{
+  result.clear();
+  for (std::vector<Vertex> &part : parts) {
+    result.insert(result.end(), part.begin(), part.end());
+    part.clear();
+  }
+}
+
+}
+
+ParallelGreedyHeuristic::ParallelGreedyHeuristic(const ExpandedConflictGraph &g, int k, int threads):
+  graph(g), labelIntervals(nullptr), k(k), threads(threads), rounds(0)
+{
+}
+
+ParallelGreedyHeuristic::~ParallelGreedyHeuristic()
+{
+  if (this->labelIntervals != nullptr) {
+    delete this->labelIntervals;
+  }
+}
+
+SelectionIntervals *
+ParallelGreedyHeuristic::getLabelIntervals()
+{
+  return this->labelIntervals;
+}
+
+size_t
+ParallelGreedyHeuristic::getRounds() const
+{
+  return this->rounds;
+}
+
+void
+ParallelGreedyHeuristic::run()
+{
+  const ExpandedConflictGraph &g = this->graph;
+  this->startRun();
+
+  if (this->labelIntervals != nullptr) {
+    delete this->labelIntervals;
+  }
+  this->labelIntervals = new SelectionIntervals();
+  this->rounds = 0;
+
+  int threads = this->threads > 0 ? this->threads : std::max(num_threads, 1);
+  size_t n = boost::num_vertices(g);
+  bool compound = g.is_compound();
+
+  // value-initialized, i.e., all vertices are ACTIVE and unmarked
+  std::vector<std::atomic<unsigned char>> state(n);
+  std::vector<std::atomic<size_t>> candidateMark(n);
+  std::vector<std::atomic<size_t>> changedMark(n);
+  std::vector<double> key(n);
+  for (size_t v = 0; v < n; ++v) {
+    key[v] = g[v].weight;
+  }
+
+  auto beats = [&key](Vertex u, Vertex v) {
+    return (key[u] > key[v]) || ((key[u] == key[v]) && (u < v));
+  };
+
+  OverlapSegmentTree overlaps;
+  if (this->k > 0) {
+    std::vector<double> endpoints;
+    endpoints.reserve(2 * n);
+    for (size_t v = 0; v < n; ++v) {
+      endpoints.push_back(bg::get<0>(g[v].interval.first));
+      endpoints.push_back(bg::get<0>(g[v].interval.second));
+    }
+    overlaps.reset(endpoints);
+  }
+
+  std::vector<std::vector<Vertex>> perThread(threads), perThreadChanged(threads);
+  std::vector<Vertex> candidates(n);
+  for (size_t v = 0; v < n; ++v) {
+    candidates[v] = v;
+  }
+  std::vector<Vertex> picked, selected, removed, changed;
+
+  size_t done = 0;
+  double score = 0;
+  while (!candidates.empty() && !this->shouldStop()) {
+    size_t round = ++this->rounds;
+
+    // the candidates that beat all their remaining neighbors
+    parallelFor(candidates.size(), threads, [&](size_t t, size_t i) {
+      Vertex v = candidates[i];
+      if (state[v] != ACTIVE) {
+        return;
+      }
+      auto neighbors = boost::adjacent_vertices(v, g);
+      for (auto nit = neighbors.first; nit != neighbors.second; ++nit) {
+        if ((state[*nit] == ACTIVE) && beats(*nit, v)) {
+          return;
+        }
+      }
+      perThread[t].push_back(v);
+    });
+    concat(perThread, picked);
+
+    // they are independent of each other, only the k-restriction needs them one by one
+    selected.clear();
+    removed.clear();
+    if (this->k > 0) {
+      std::sort(picked.begin(), picked.end(), beats);
+    }
+    for (Vertex v : picked) {
+      double start = bg::get<0>(g[v].interval.first);
+      double end = bg::get<0>(g[v].interval.second);
+      if (this->k > 0) {
+        if (overlaps.max(start, end) >= this->k) {
+          state[v] = DROPPED;
+          removed.push_back(v);
+          continue;
+        }
+        overlaps.add(start, end, 1);
+      }
+      state[v] = SELECTED;
+      selected.push_back(v);
+      this->labelIntervals->insert(g[v].interval, g[v].poi);
+      score += end - start;
+    }
+
+    // remove the neighbors of the selected vertices
+    parallelFor(selected.size(), threads, [&](size_t t, size_t i) {
+      auto neighbors = boost::adjacent_vertices(selected[i], g);
+      for (auto nit = neighbors.first; nit != neighbors.second; ++nit) {
+        unsigned char expected = ACTIVE;
+        if (state[*nit].compare_exchange_strong(expected, BLOCKED)) {
+          perThread[t].push_back(*nit);
+        }
+      }
+    });
+    size_t dropped = removed.size();
+    for (std::vector<Vertex> &part : perThread) {
+      removed.insert(removed.end(), part.begin(), part.end());
+      part.clear();
+    }
+    done += selected.size() + removed.size();
+
+    // Remaining vertices next to removed ones may now beat all their neighbors. In compound
+    // graphs, the keys of those next to blocked ones decrease, which affects their neighbors.
+    parallelFor(removed.size(), threads, [&](size_t t, size_t i) {
+      bool blocked = i >= dropped;
+      auto neighbors = boost::adjacent_vertices(removed[i], g);
+      for (auto nit = neighbors.first; nit != neighbors.second; ++nit) {
+        if (state[*nit] != ACTIVE) {
+          continue;
+        }
+        if (compound && blocked && (changedMark[*nit].exchange(round) != round)) {
+          perThreadChanged[t].push_back(*nit);
+        }
+        if (candidateMark[*nit].exchange(round) != round) {
+          perThread[t].push_back(*nit);
+        }
+      }
+    });
+    concat(perThread, candidates);
+    concat(perThreadChanged, changed);
+
+    if (compound && !changed.empty()) {
+      parallelFor(changed.size(), threads, [&](size_t, size_t i) {
+        Vertex v = changed[i];
+        double weight = g[v].weight;
+        auto neighbors = boost::adjacent_vertices(v, g);
+        for (auto nit = neighbors.first; nit != neighbors.second; ++nit) {
+          if (state[*nit] == BLOCKED) {
+            weight -= g[*nit].weight;
+          }
+        }
+        key[v] = weight;
+      });
+      parallelFor(changed.size(), threads, [&](size_t t, size_t i) {
+        auto neighbors = boost::adjacent_vertices(changed[i], g);
+        for (auto nit = neighbors.first; nit != neighbors.second; ++nit) {
+          if ((state[*nit] == ACTIVE) && (candidateMark[*nit].exchange(round) != round)) {
+            perThread[t].push_back(*nit);
+          }
+        }
+      });
+      for (std::vector<Vertex> &part : perThread) {
+        candidates.insert(candidates.end(), part.begin(), part.end());
+        part.clear();
+      }
+    }
+
+    this->reportProgress(n > 0 ? (double)done / n : 1.0, score);
+  }
+}
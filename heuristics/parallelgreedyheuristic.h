@@ -0,0 +1,44 @@
+#ifndef PARALLELGREEDYHEURISTIC_H
+#define PARALLELGREEDYHEURISTIC_H
+
+#include "heuristic.h"
+#include "conflicts/conflictgraph.h"
+
+/**
+ * Greedy independent set in synchronous rounds (in the style of Luby's algorithm), for conflict
+ * graphs that are too large for the sequential GreedyHeuristic.
+ *
+ * Every vertex has the key GreedyHeuristic uses: its weight, minus the weight of all removed
+ * neighbors in compound graphs. Ties are broken by the smaller vertex id. In each round, all
+ * threads look for remaining vertices whose key is larger than the keys of all their remaining
+ * neighbors. These are added to the solution at once, and their neighbors are removed. Only
+ * vertices whose neighborhood changed are looked at again in the next round.
+ *
+ * The result does not depend on the number of threads. Without compound weights and
+ * k-restriction, it is the same as the one of the sequential greedy heuristic (up to ties).
+ * With a k-restriction, the vertices picked in a round are added in the order of their keys,
+ * and those that would exceed k are dropped.
+ *
+ * The graph is not copied, and must not change while the heuristic runs.
+ */
+class ParallelGreedyHeuristic : public Heuristic {
+public:
+  /* threads < 1 uses num_threads */
+  ParallelGreedyHeuristic(const ExpandedConflictGraph &g, int k = -1, int threads = 0);
+  ~ParallelGreedyHeuristic();
+  virtual SelectionIntervals * getLabelIntervals();
+  void run();
+
+  // after run(): number of rounds
+  size_t getRounds() const;
+
+private:
+  const ExpandedConflictGraph &graph;
+
+  SelectionIntervals *labelIntervals;
+  int k;
+  int threads;
+  size_t rounds;
+};
+
+#endif // PARALLELGREEDYHEURISTIC_H
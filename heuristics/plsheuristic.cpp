@@ -0,0 +1,490 @@
+#include "plsheuristic.h"
+
+#include "config.h"
+#include "util/segmenttree.h"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <thread>
+
+namespace {
+
+typedef std::chrono::steady_clock PLSClock;
+
+const size_t NONE = static_cast<size_t>(-1);
+
+// Number of iterations per phase, and the penalty delay of the penalty phase
+const int RANDOM_ITERATIONS = 50;
+const int PENALTY_ITERATIONS = 50;
+const int GREEDY_ITERATIONS = 100;
+const int PENALTY_DELAY = 2;
+
+// Candidates a pick looks at once it has one, and picks between two checks of the deadline
+const size_t SCAN_LIMIT = 64;
+const long CHECK_INTERVAL = 64;
+
+enum Phase {RANDOM, PENALTY, GREEDY};
+
+/* The graph in compressed form, shared read-only between the searches */
+struct PLSInstance {
+  size_t n;
+  std::vector<size_t> offsets;
+  std::vector<size_t> neighbors;
+  std::vector<double> weights;
+  std::vector<double> starts;
+  std::vector<double> ends;
+  std::vector<double> coordinates;
+  int k;
+};
+
+/* The best set found by any search */
+struct PLSShared {
+  std::mutex mutex;
+  std::atomic<double> weight;
+  std::vector<size_t> set;
+  std::atomic<long> iterations;
+
+  // polled by the searches, and called with the mutex held whenever the best set improves
+  std::function<bool()> cancelled;
+  std::function<void(double weight)> improved;
+};
+
+/* A subset of 0..n-1 with O(1) insertion, removal and uniform sampling */
+class IndexedSet {
+public:
+  IndexedSet(size_t n) : position(n, NONE) {}
+
+  bool contains(size_t v) const {
+    return this->position[v] != NONE;
+  }
+
+  void insert(size_t v) {
+    if (!this->contains(v)) {
+      this->position[v] = this->items.size();
+      this->items.push_back(v);
+    }
+  }
+
+  void erase(size_t v) {
+    if (this->contains(v)) {
+      size_t last = this->items.back();
+      this->items[this->position[v]] = last;
+      this->position[last] = this->position[v];
+      this->items.pop_back();
+      this->position[v] = NONE;
+    }
+  }
+
+  size_t size() const {
+    return this->items.size();
+  }
+
+  std::vector<size_t> items;
+
+private:
+  std::vector<size_t> position;
+};
+
+class PLSSearch {
+public:
+  PLSSearch(const PLSInstance &instance, PLSShared &shared, unsigned int seed)
+    : instance(instance), shared(shared), rng(seed), inSet(instance.n, false), conflicts(instance.n, 0),
+      tabu(instance.n, 0), penalties(instance.n, 0), members(instance.n), free(instance.n), single(instance.n),
+      weight(0), stamp(0)
+  {
+    if (this->instance.k > 0) {
+      this->overlaps.reset(this->instance.coordinates);
+    }
+    for (size_t v = 0; v < this->instance.n; ++v) {
+      if (this->eligible(v)) {
+        this->free.insert(v);
+      }
+    }
+  }
+
+  void run(PLSClock::time_point deadline) {
+    long iterations = 0;
+    long picks = 0;
+    double localBest = 0;
+
+    while ((PLSClock::now() < deadline) && !this->shared.cancelled()) {
+      int cycle = iterations % (RANDOM_ITERATIONS + PENALTY_ITERATIONS + GREEDY_ITERATIONS);
+      Phase phase = GREEDY;
+      if (cycle < RANDOM_ITERATIONS) {
+        phase = RANDOM;
+      } else if (cycle < RANDOM_ITERATIONS + PENALTY_ITERATIONS) {
+        phase = PENALTY;
+      }
+
+      if ((cycle == 0) && (this->shared.weight > localBest)) {
+        this->adoptShared();
+        localBest = this->weight;
+      }
+
+      this->stamp++;
+      while (true) {
+        if ((++picks % CHECK_INTERVAL == 0) && ((PLSClock::now() >= deadline) || this->shared.cancelled())) {
+          break;
+        }
+        size_t v = this->pickAdd(phase);
+        if (v != NONE) {
+          this->add(v);
+          continue;
+        }
+        size_t u;
+        v = this->pickSwap(phase, u);
+        if (v != NONE) {
+          this->remove(u);
+          this->tabu[u] = this->stamp;
+          this->add(v);
+          continue;
+        }
+        break;
+      }
+
+      if (this->weight > localBest) {
+        localBest = this->weight;
+        this->publish();
+      }
+
+      if (phase == PENALTY) {
+        for (size_t member : this->members.items) {
+          this->penalties[member]++;
+        }
+        if (cycle % PENALTY_DELAY == 0) {
+          for (unsigned int &penalty : this->penalties) {
+            if (penalty > 0) {
+              penalty--;
+            }
+          }
+        }
+      }
+
+      this->perturb(phase);
+      iterations++;
+    }
+
+    this->shared.iterations += iterations;
+  }
+
+private:
+  bool eligible(size_t v) const {
+    return this->instance.weights[v] > 0;
+  }
+
+  bool fitsK(size_t v) const {
+    return (this->instance.k <= 0) || (this->overlaps.max(this->instance.starts[v], this->instance.ends[v]) < this->instance.k);
+  }
+
+  // whether v fits the k-restriction once u is removed
+  bool fitsKSwap(size_t v, size_t u) {
+    if (this->instance.k <= 0) {
+      return true;
+    }
+    this->overlaps.add(this->instance.starts[u], this->instance.ends[u], -1);
+    bool fits = this->fitsK(v);
+    this->overlaps.add(this->instance.starts[u], this->instance.ends[u], 1);
+    return fits;
+  }
+
+  void classify(size_t v) {
+    this->free.erase(v);
+    this->single.erase(v);
+    if (this->inSet[v] || !this->eligible(v)) {
+      return;
+    }
+    if (this->conflicts[v] == 0) {
+      this->free.insert(v);
+    } else if (this->conflicts[v] == 1) {
+      this->single.insert(v);
+    }
+  }
+
+  void add(size_t v) {
+    this->inSet[v] = true;
+    this->members.insert(v);
+    this->weight += this->instance.weights[v];
+    this->classify(v);
+    for (size_t i = this->instance.offsets[v]; i < this->instance.offsets[v + 1]; ++i) {
+      size_t u = this->instance.neighbors[i];
+      this->conflicts[u]++;
+      if (this->conflicts[u] <= 2) {
+        this->classify(u);
+      }
+    }
+    if (this->instance.k > 0) {
+      this->overlaps.add(this->instance.starts[v], this->instance.ends[v], 1);
+    }
+  }
+
+  void remove(size_t v) {
+    this->inSet[v] = false;
+    this->members.erase(v);
+    this->weight -= this->instance.weights[v];
+    for (size_t i = this->instance.offsets[v]; i < this->instance.offsets[v + 1]; ++i) {
+      size_t u = this->instance.neighbors[i];
+      this->conflicts[u]--;
+      if (this->conflicts[u] <= 1) {
+        this->classify(u);
+      }
+    }
+    this->classify(v);
+    if (this->instance.k > 0) {
+      this->overlaps.add(this->instance.starts[v], this->instance.ends[v], -1);
+    }
+  }
+
+  // the single neighbor of v in the set
+  size_t blocker(size_t v) const {
+    for (size_t i = this->instance.offsets[v]; i < this->instance.offsets[v + 1]; ++i) {
+      if (this->inSet[this->instance.neighbors[i]]) {
+        return this->instance.neighbors[i];
+      }
+    }
+    return NONE;
+  }
+
+  // true if candidate should be preferred over best in the given phase
+  bool better(Phase phase, size_t candidate, size_t best) const {
+    if (best == NONE) {
+      return true;
+    }
+    if (phase == PENALTY) {
+      return this->penalties[candidate] < this->penalties[best];
+    }
+    return this->instance.weights[candidate] > this->instance.weights[best];
+  }
+
+  // Both picks start at a random candidate and stop after SCAN_LIMIT candidates once they have
+  // found one, so the greedy and penalty phases choose the best of a sample. Only a pick that
+  // finds nothing looks at all candidates.
+  size_t pickAdd(Phase phase) {
+    const std::vector<size_t> &candidates = this->free.items;
+    if (candidates.empty()) {
+      return NONE;
+    }
+    size_t offset = this->rng() % candidates.size();
+    size_t best = NONE;
+    for (size_t i = 0; (i < candidates.size()) && ((best == NONE) || (i < SCAN_LIMIT)); ++i) {
+      size_t v = candidates[(offset + i) % candidates.size()];
+      if ((this->tabu[v] == this->stamp) || !this->better(phase, v, best) || !this->fitsK(v)) {
+        continue;
+      }
+      best = v;
+      if (phase == RANDOM) {
+        break;
+      }
+    }
+    return best;
+  }
+
+  size_t pickSwap(Phase phase, size_t &removed) {
+    const std::vector<size_t> &candidates = this->single.items;
+    removed = NONE;
+    if (candidates.empty()) {
+      return NONE;
+    }
+    size_t offset = this->rng() % candidates.size();
+    size_t best = NONE;
+    for (size_t i = 0; (i < candidates.size()) && ((best == NONE) || (i < SCAN_LIMIT)); ++i) {
+      size_t v = candidates[(offset + i) % candidates.size()];
+      if ((this->tabu[v] == this->stamp) || !this->better(phase, v, best)) {
+        continue;
+      }
+      size_t u = this->blocker(v);
+      // swaps must not lose weight, otherwise the plateau search does not settle
+      if ((this->instance.weights[v] < this->instance.weights[u]) || !this->fitsKSwap(v, u)) {
+        continue;
+      }
+      best = v;
+      removed = u;
+      if (phase == RANDOM) {
+        break;
+      }
+    }
+    return best;
+  }
+
+  void perturb(Phase phase) {
+    if (this->members.size() == 0) {
+      return;
+    }
+
+    if (phase == PENALTY) {
+      // restart from a single vertex of the current set
+      size_t keep = this->members.items[this->rng() % this->members.size()];
+      std::vector<size_t> others = this->members.items;
+      for (size_t v : others) {
+        if (v != keep) {
+          this->remove(v);
+        }
+      }
+      return;
+    }
+
+    // force a random vertex into the set and remove what it conflicts with
+    size_t v = this->rng() % this->instance.n;
+    for (size_t tries = 0; (tries < 16) && (this->inSet[v] || !this->eligible(v)); ++tries) {
+      v = this->rng() % this->instance.n;
+    }
+    if (this->inSet[v] || !this->eligible(v)) {
+      return;
+    }
+    for (size_t i = this->instance.offsets[v]; i < this->instance.offsets[v + 1]; ++i) {
+      size_t u = this->instance.neighbors[i];
+      if (this->inSet[u]) {
+        this->remove(u);
+      }
+    }
+    while (!this->fitsK(v)) {
+      std::vector<size_t> overlapping;
+      for (size_t u : this->members.items) {
+        if ((this->instance.starts[u] <= this->instance.ends[v]) && (this->instance.ends[u] >= this->instance.starts[v])) {
+          overlapping.push_back(u);
+        }
+      }
+      this->remove(overlapping[this->rng() % overlapping.size()]);
+    }
+    this->add(v);
+  }
+
+  void publish() {
+    if (this->weight <= this->shared.weight) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(this->shared.mutex);
+    if (this->weight > this->shared.weight) {
+      this->shared.weight = this->weight;
+      this->shared.set = this->members.items;
+      this->shared.improved(this->weight);
+    }
+  }
+
+  void adoptShared() {
+    std::vector<size_t> set;
+    {
+      std::lock_guard<std::mutex> lock(this->shared.mutex);
+      set = this->shared.set;
+    }
+    std::vector<size_t> current = this->members.items;
+    for (size_t v : current) {
+      this->remove(v);
+    }
+    for (size_t v : set) {
+      this->add(v);
+    }
+  }
+
+  const PLSInstance &instance;
+  PLSShared &shared;
+  std::mt19937 rng;
+
+  std::vector<char> inSet;
+  std::vector<unsigned int> conflicts; // number of neighbors in the set
+  std::vector<unsigned long> tabu;     // removed by a swap in the iteration with this stamp
+  std::vector<unsigned int> penalties;
+
+  IndexedSet members;
+  IndexedSet free;   // vertices without neighbors in the set
+  IndexedSet single; // vertices with exactly one neighbor in the set
+
+  OverlapSegmentTree overlaps;
+  double weight;
+  unsigned long stamp;
+};
+
+}
+
+PLSHeuristic::PLSHeuristic(ExpandedConflictGraph g, int k, double timeLimit, unsigned int seed, int threads):
+  graph(g), labelIntervals(nullptr), k(k), timeLimit(timeLimit), seed(seed), threads(threads), weight(0), iterations(0)
+{
+}
+
+SelectionIntervals *
+PLSHeuristic::getLabelIntervals()
+{
+  return this->labelIntervals;
+}
+
+double
+PLSHeuristic::getWeight() const
+{
+  return this->weight;
+}
+
+long
+PLSHeuristic::getIterations() const
+{
+  return this->iterations;
+}
+
+void
+PLSHeuristic::run()
+{
+  const ExpandedConflictGraph &g = this->graph;
+  this->startRun();
+  PLSClock::time_point start = PLSClock::now();
+  PLSClock::time_point deadline = this->deadlineAfter(this->timeLimit);
+
+  if (this->labelIntervals != nullptr) {
+    delete this->labelIntervals;
+  }
+  this->labelIntervals = new SelectionIntervals();
+
+  PLSInstance instance;
+  instance.n = boost::num_vertices(g);
+  instance.k = this->k;
+  instance.offsets.push_back(0);
+  for (size_t v = 0; v < instance.n; ++v) {
+    auto neighbors = boost::adjacent_vertices(v, g);
+    for (auto nit = neighbors.first; nit != neighbors.second; ++nit) {
+      instance.neighbors.push_back(*nit);
+    }
+    instance.offsets.push_back(instance.neighbors.size());
+    instance.weights.push_back(g[v].weight);
+    instance.starts.push_back(bg::get<0>(g[v].interval.first));
+    instance.ends.push_back(bg::get<0>(g[v].interval.second));
+    instance.coordinates.push_back(instance.starts.back());
+    instance.coordinates.push_back(instance.ends.back());
+  }
+
+  PLSShared shared;
+  shared.weight = 0;
+  shared.iterations = 0;
+  shared.cancelled = [this]() { return this->isCancelled(); };
+  shared.improved = [this, start, deadline](double weight) {
+    double total = std::chrono::duration<double>(deadline - start).count();
+    double elapsed = std::chrono::duration<double>(PLSClock::now() - start).count();
+    this->reportProgress(total > 0 ? std::min(elapsed / total, 1.0) : 1.0, weight);
+  };
+
+  if (instance.n > 0) {
+    int threads = this->threads > 0 ? this->threads : std::max(num_threads, 1);
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; ++t) {
+      pool.push_back(std::thread([&instance, &shared, deadline, t, this]() {
+        PLSSearch search(instance, shared, this->seed + 7919 * t);
+        search.run(deadline);
+      }));
+    }
+    PLSSearch search(instance, shared, this->seed);
+    search.run(deadline);
+    for (std::thread &thread : pool) {
+      thread.join();
+    }
+  }
+
+  // records a cancellation, reaching the deadline is the normal end of the search
+  if (this->isCancelled()) {
+    this->shouldStop();
+  }
+
+  this->weight = shared.weight;
+  this->iterations = shared.iterations;
+  for (size_t v : shared.set) {
+    this->labelIntervals->insert(g[v].interval, g[v].poi);
+  }
+}
@@ -0,0 +1,46 @@
+#ifndef PLSHEURISTIC_H
+#define PLSHEURISTIC_H
+
+#include "heuristic.h"
+#include "conflicts/conflictgraph.h"
+
+/**
+ * Phased Local Search (Pullan, 2006) for the maximum weight independent set on the expanded
+ * conflict graph, with the k-restriction checked by an OverlapSegmentTree.
+ *
+ * Each search alternates between adding vertices without neighbors in the current set and
+ * (1,1)-swaps with vertices that have exactly one such neighbor. When neither is possible, the
+ * set is perturbed. The phases differ in how vertices are chosen: uniformly at random, by
+ * smallest penalty (penalties grow for vertices that stay in the set), or by largest weight,
+ * the latter two among a random sample of the candidates. The deadline is checked between the
+ * moves as well, not only between the perturbations.
+ *
+ * Every thread runs an independent search with its own seed. The best set found so far is
+ * shared between them, and a search that falls behind it continues from the shared set at
+ * the start of its next phase cycle.
+ */
+class PLSHeuristic : public Heuristic {
+public:
+  /* timeLimit is the time budget in seconds, threads < 1 uses num_threads */
+  PLSHeuristic(ExpandedConflictGraph g, int k = -1, double timeLimit = 1.0, unsigned int seed = 0, int threads = 0);
+  virtual SelectionIntervals * getLabelIntervals();
+  void run();
+
+  // weight of the best set and number of iterations of all searches, after run()
+  double getWeight() const;
+  long getIterations() const;
+
+private:
+  const ExpandedConflictGraph graph;
+
+  SelectionIntervals *labelIntervals;
+  int k;
+  double timeLimit;
+  unsigned int seed;
+  int threads;
+
+  double weight;
+  long iterations;
+};
+
+#endif // PLSHEURISTIC_H
@@ -0,0 +1,231 @@
+#include "portfolio.h"
+
+#include "config.h"
+#include "cli/evaluator.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+typedef std::chrono::steady_clock PortfolioClock;
+
+// How often (in milliseconds) the deadline and the cancellation are checked while waiting
+const int POLL_INTERVAL = 50;
+
+}
+
+Portfolio::Portfolio(double timeLimit, int threads) :
+  timeLimit(timeLimit), threads(std::max(threads, 1)), initialBound(-1), cancel(false), winner(-1), score(0), bound(-1), winnerTime(0), time(0)
+{
+}
+
+SelectionIntervals *
+Portfolio::getLabelIntervals()
+{
+  if (this->winner < 0) {
+    return nullptr;
+  }
+  return this->entries[this->winner].solver->getLabelIntervals();
+}
+
+void
+Portfolio::add(const char *name, Heuristic *solver, int threads, BoundFunction bound)
+{
+  Entry entry;
+  entry.name = name;
+  entry.solver = solver;
+  entry.threads = std::max(threads, 1);
+  entry.bound = bound;
+  this->entries.push_back(entry);
+}
+
+void
+Portfolio::setBound(double bound)
+{
+  this->initialBound = bound;
+}
+
+double
+Portfolio::getScore() const
+{
+  return this->score;
+}
+
+double
+Portfolio::getBound() const
+{
+  return this->bound;
+}
+
+bool
+Portfolio::isOptimal() const
+{
+  return (this->winner >= 0) && this->proven();
+}
+
+const std::string &
+Portfolio::getWinner() const
+{
+  return this->winnerName;
+}
+
+double
+Portfolio::getWinnerTime() const
+{
+  return this->winnerTime;
+}
+
+double
+Portfolio::getTime() const
+{
+  return this->time;
+}
+
+bool
+Portfolio::proven() const
+{
+  return (this->bound >= 0) && (this->score >= this->bound * (1 - PORTFOLIO_OPTIMALITY_GAP));
+}
+
+void
+Portfolio::improve(double score)
+{
+  if (score <= this->score) {
+    return;
+  }
+  this->score = score;
+  this->reportProgress(this->bound > 0 ? std::min(score / this->bound, 1.0) : 0.0, score);
+  if (this->proven()) {
+    this->cancel = true;
+  }
+}
+
+void
+Portfolio::finish(Entry &entry, double now)
+{
+  entry.done = true;
+
+  SelectionIntervals *selection = entry.solver->getLabelIntervals();
+  if (selection != nullptr) {
+    Evaluator eval(selection, entry.name.c_str());
+    entry.score = eval.getTotalDisplayTime();
+    // the solution was found when the solver first reported its score, if it did
+    bool reported = (entry.reported >= 0) && (entry.reported >= entry.score * (1 - PORTFOLIO_OPTIMALITY_GAP));
+    entry.foundAt = reported ? entry.reportedAt : now;
+  }
+
+  if (entry.bound) {
+    double bound = entry.bound();
+    if ((bound >= 0) && ((this->bound < 0) || (bound < this->bound))) {
+      this->bound = bound;
+    }
+  }
+
+  if (entry.score >= 0) {
+    this->improve(entry.score);
+  }
+  if (this->proven()) {
+    this->cancel = true;
+  }
+}
+
+void
+Portfolio::run()
+{
+  this->startRun();
+  PortfolioClock::time_point start = PortfolioClock::now();
+  Deadline deadline = this->deadlineAfter(this->timeLimit);
+  auto elapsed = [start]() {
+    return std::chrono::duration<double>(PortfolioClock::now() - start).count();
+  };
+
+  this->cancel = false;
+  this->winner = -1;
+  this->winnerName.clear();
+  this->score = 0;
+  this->bound = this->initialBound;
+  this->winnerTime = 0;
+
+  std::mutex mutex;
+  std::condition_variable finished;
+  int busy = 0;
+  int running = 0;
+
+  for (Entry &entry : this->entries) {
+    entry.done = false;
+    entry.score = -1;
+    entry.reported = -1;
+    entry.reportedAt = 0;
+    entry.foundAt = 0;
+
+    Entry *current = &entry;
+    entry.solver->setDeadline(deadline);
+    entry.solver->setCancellationToken(&this->cancel);
+    entry.solver->setProgressCallback([this, current, &mutex, elapsed](double, double score) {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (score > current->reported) {
+        current->reported = score;
+        current->reportedAt = elapsed();
+      }
+      this->improve(score);
+    });
+  }
+
+  std::vector<std::thread> pool;
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    size_t next = 0;
+    while (true) {
+      if (this->shouldStop() || (PortfolioClock::now() >= deadline)) {
+        this->cancel = true;
+      }
+
+      while (!this->cancel && (next < this->entries.size()) && ((busy == 0) || (busy + this->entries[next].threads <= this->threads))) {
+        Entry *entry = &this->entries[next++];
+        busy += entry->threads;
+        running++;
+        pool.push_back(std::thread([this, entry, &mutex, &finished, &busy, &running, elapsed]() {
+          entry->solver->run();
+
+          std::lock_guard<std::mutex> lock(mutex);
+          this->finish(*entry, elapsed());
+          busy -= entry->threads;
+          running--;
+          finished.notify_all();
+        }));
+      }
+
+      if ((running == 0) && (this->cancel || (next == this->entries.size()))) {
+        break;
+      }
+      finished.wait_for(lock, std::chrono::milliseconds(POLL_INTERVAL));
+    }
+  }
+  for (std::thread &thread : pool) {
+    thread.join();
+  }
+
+  // the best final solution, the earliest found one among equal ones
+  this->score = 0;
+  for (size_t i = 0; i < this->entries.size(); ++i) {
+    const Entry &entry = this->entries[i];
+    if (!entry.done || (entry.score < 0)) {
+      continue;
+    }
+    if ((this->winner < 0) || (entry.score > this->score) || ((entry.score == this->score) && (entry.foundAt < this->winnerTime))) {
+      this->winner = i;
+      this->winnerName = entry.name;
+      this->score = entry.score;
+      this->winnerTime = entry.foundAt;
+    }
+  }
+  this->time = elapsed();
+
+  for (Entry &entry : this->entries) {
+    entry.solver->setCancellationToken(nullptr);
+    entry.solver->setProgressCallback(ProgressCallback());
+  }
+}
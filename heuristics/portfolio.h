@@ -0,0 +1,84 @@
+#ifndef PORTFOLIO_H
+#define PORTFOLIO_H
+
+#include "heuristic.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * Runs several solvers for the same instance at the same time and keeps the best solution.
+ *
+ * The solvers start in the order they were added, each as soon as its threads fit into the
+ * thread budget (a solver that needs more than the whole budget runs alone). All of them get
+ * the deadline of the portfolio and a shared cancellation token. Once the best solution
+ * reaches the smallest upper bound known (of a finished solver, or given via setBound()) up to
+ * PORTFOLIO_OPTIMALITY_GAP, the remaining solvers are cancelled and the others are not
+ * started anymore. At the deadline, every running solver stops with its best solution so far.
+ *
+ * The progress callbacks of the solvers are used to tell when the winning solution was found;
+ * the progress callback of the portfolio receives every improvement of the best score. Both are
+ * called from the solver threads, one at a time.
+ */
+class Portfolio : public Heuristic {
+public:
+  /* Upper bound on the optimum after the solver is done, or a negative value if there is none */
+  typedef std::function<double()> BoundFunction;
+
+  /* timeLimit is the total time budget in seconds, threads the number of threads to share */
+  Portfolio(double timeLimit, int threads);
+  virtual SelectionIntervals *getLabelIntervals();
+  void run();
+
+  /* The solver is not owned, and must be set up to use the given number of threads */
+  void add(const char *name, Heuristic *solver, int threads = 1, BoundFunction bound = BoundFunction());
+
+  /* An upper bound on the optimum that is known beforehand */
+  void setBound(double bound);
+
+  // after run(): the best score, the smallest bound (negative if none), and whether they match
+  double getScore() const;
+  double getBound() const;
+  bool isOptimal() const;
+
+  // after run(): the name of the solver with the best solution (empty if there is none), the
+  // seconds after the start at which it had found it, and the total time
+  const std::string &getWinner() const;
+  double getWinnerTime() const;
+  double getTime() const;
+
+private:
+  struct Entry {
+    std::string name;
+    Heuristic *solver;
+    int threads;
+    BoundFunction bound;
+
+    bool done;
+    double score;
+    double reported;
+    double reportedAt;
+    double foundAt;
+  };
+
+  void improve(double score);
+  void finish(Entry &entry, double now);
+  bool proven() const;
+
+  double timeLimit;
+  int threads;
+  double initialBound;
+
+  std::vector<Entry> entries;
+  CancellationToken cancel;
+
+  int winner;
+  std::string winnerName;
+  double score;
+  double bound;
+  double winnerTime;
+  double time;
+};
+
+#endif // PORTFOLIO_H
@@ -7,6 +7,13 @@
 #include <vector>
 #include <cassert>
 #include <iostream>
+#include <algorithm>
+#include <limits>
+#include <cstring>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <random>
 
 /**
  * The end point of an interval.
@@ -154,7 +161,10 @@ std::vector<int> computeMWIS(std::vector<IntervalEnd> &startEvents,
     return result;
 }
 
-std::vector<int> computeMWIS(std::vector<WeightedInterval> &intervals){
+/**
+ * The original implementation of computeMWIS, kept as a reference for MWISSolver.
+ */
+std::vector<int> computeMWISLegacy(std::vector<WeightedInterval> &intervals){
     std::vector<IntervalEnd> endEvents, startEvents;
     std::vector<double> weights;
     for(size_t i=0; i < intervals.size(); ++i){
@@ -171,6 +181,302 @@ std::vector<int> computeMWIS(std::vector<WeightedInterval> &intervals){
 
 }
 
+std::vector<int> computeMWIS(std::vector<WeightedInterval> &intervals){
+    static thread_local MWISSolver solver;
+    return solver.compute(intervals);
+}
+
+std::vector<std::vector<int>> computeMWISBatch(const std::vector<std::vector<WeightedInterval>> &sets, int threads){
+    std::vector<std::vector<int>> results(sets.size());
+    std::atomic<size_t> next(0);
+
+    auto worker = [&sets, &results, &next](){
+        MWISSolver solver;
+        for(size_t i = next++; i < sets.size(); i = next++){
+            solver.compute(sets[i], results[i]);
+        }
+    };
+
+    size_t helpers = std::min((size_t)std::max(threads, 1), sets.size());
+    std::vector<std::thread> pool;
+    for(size_t t = 1; t < helpers; ++t){
+        pool.push_back(std::thread(worker));
+    }
+    worker();
+    for(std::thread & thread : pool){
+        thread.join();
+    }
+
+    return results;
+}
+
+namespace {
+
+/**
+ * Maps a double to an unsigned integer with the same order, i.e., a < b iff key(a) < key(b).
+ */
+inline uint64_t radixKey(double value){
+    if(value == 0){
+        value = 0; // -0.0 == 0.0
+    }
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const uint64_t sign = 0x8000000000000000ULL;
+    return (bits & sign) ? ~bits : (bits | sign);
+}
+
+// Below this many end points, insertion sort beats the radix passes.
+const size_t RADIX_THRESHOLD = 64;
+
+}
+
+std::vector<int> MWISSolver::compute(const std::vector<WeightedInterval> &intervals){
+    std::vector<int> result;
+    compute(intervals, result);
+    return result;
+}
+
+void MWISSolver::compute(const std::vector<WeightedInterval> &intervals, std::vector<int> &result){
+    result.clear();
+    size_t n = intervals.size();
+    if(n == 0){
+        return;
+    }
+
+    size_t count = 2*n;
+    keys_.resize(count);
+    slots_.resize(count);
+    for(size_t i=0; i < n; ++i){
+        const WeightedInterval & wi = intervals[i];
+        assert(wi.start() <= wi.end());
+        keys_[2*i] = radixKey(wi.start());
+        keys_[2*i+1] = radixKey(wi.end());
+        slots_[2*i] = 2*i;
+        slots_[2*i+1] = 2*i+1;
+    }
+    sort(count);
+
+    // Walk over the groups of equal coordinates, i.e., the ranks. Within a group, the ends lie to
+    // the left of the starts, and the ends are ordered by id, just like in IntervalEnd. Intervals
+    // of length zero are put behind the other ends of their group, so that they can be combined
+    // with all of them.
+    ends_.resize(n);
+    last_.resize(n);
+    size_t endCount = 0;
+    for(size_t group = 0; group < count; ){
+        size_t next = group;
+        for(; next < count && keys_[next] == keys_[group]; ++next){
+            int id = slots_[next] >> 1;
+            if((slots_[next] & 1) && intervals[id].length() > 0){
+                ends_[endCount++] = id;
+            }
+        }
+        for(size_t i = group; i < next; ++i){
+            int id = slots_[i] >> 1;
+            if((slots_[i] & 1) && intervals[id].length() == 0){
+                last_[id] = endCount;
+                ends_[endCount++] = id;
+            }
+        }
+        for(size_t i = group; i < next; ++i){
+            int id = slots_[i] >> 1;
+            if(!(slots_[i] & 1) && intervals[id].length() > 0){
+                last_[id] = endCount;
+            }
+        }
+        group = next;
+    }
+    assert(endCount == n);
+
+    table_.resize(n+1);
+    taken_.resize(n+1);
+    table_[0] = 0;
+    for(size_t e = 1; e < n+1; ++e){
+        int id = ends_[e-1];
+        double weight = intervals[id].weight();
+        if(table_[e-1] > weight+table_[last_[id]]){
+            table_[e] = table_[e-1];
+            taken_[e] = false;
+        }else{
+            table_[e] = table_[last_[id]]+weight;
+            taken_[e] = true;
+        }
+    }
+
+    size_t entry = n;
+    while(entry != 0){
+        int id = ends_[entry-1];
+        if(taken_[entry]){
+            result.push_back(id);
+            entry = last_[id];
+        }else{
+            entry--;
+        }
+    }
+}
+
+void MWISSolver::sort(size_t count){
+    if(count < RADIX_THRESHOLD){
+        for(size_t i = 1; i < count; ++i){
+            uint64_t key = keys_[i];
+            uint32_t slot = slots_[i];
+            size_t j = i;
+            for(; j > 0 && keys_[j-1] > key; --j){
+                keys_[j] = keys_[j-1];
+                slots_[j] = slots_[j-1];
+            }
+            keys_[j] = key;
+            slots_[j] = slot;
+        }
+        return;
+    }
+
+    // one histogram per byte, all filled in a single pass
+    size_t histogram[8][256];
+    std::memset(histogram, 0, sizeof(histogram));
+    for(size_t i = 0; i < count; ++i){
+        uint64_t key = keys_[i];
+        for(int pass = 0; pass < 8; ++pass){
+            histogram[pass][(key >> (8*pass)) & 0xff]++;
+        }
+    }
+
+    keysTmp_.resize(count);
+    slotsTmp_.resize(count);
+    for(int pass = 0; pass < 8; ++pass){
+        size_t *counts = histogram[pass];
+        int shift = 8*pass;
+        // all keys share this byte, e.g., the sign and exponent of nearby coordinates
+        if(counts[(keys_[0] >> shift) & 0xff] == count){
+            continue;
+        }
+        size_t offset = 0;
+        for(int digit = 0; digit < 256; ++digit){
+            size_t c = counts[digit];
+            counts[digit] = offset;
+            offset += c;
+        }
+        for(size_t i = 0; i < count; ++i){
+            size_t pos = counts[(keys_[i] >> shift) & 0xff]++;
+            keysTmp_[pos] = keys_[i];
+            slotsTmp_[pos] = slots_[i];
+        }
+        keys_.swap(keysTmp_);
+        slots_.swap(slotsTmp_);
+    }
+}
+
+const size_t IncrementalMWIS::NONE;
+
+IncrementalMWIS::IncrementalMWIS(size_t n) : start_(n,0), end_(n,0), weight_(n,0), alive_(n,false),
+    version_(n,0), slot_(n,NONE), table_(1,0), last_(1,0), taken_(1,false), dirty_(0), size_(0){
+}
+
+void IncrementalMWIS::invalidate(int id){
+    version_[id]++;
+    if(slot_[id] != NONE){
+        dirty_ = std::min(dirty_, slot_[id]);
+        slot_[id] = NONE;
+    }
+}
+
+void IncrementalMWIS::update(int id, double start, double end, double weight){
+    assert(start <= end);
+    invalidate(id);
+    if(!alive_[id]){
+        alive_[id] = true;
+        size_++;
+    }
+    start_[id] = start;
+    end_[id] = end;
+    weight_[id] = weight;
+    pending_.push_back(id);
+}
+
+void IncrementalMWIS::remove(int id){
+    if(!alive_[id]){
+        return;
+    }
+    invalidate(id);
+    alive_[id] = false;
+    size_--;
+}
+
+std::vector<int> IncrementalMWIS::compute(){
+    // collect the new entries. An id may have been changed several times.
+    merged_.clear();
+    for(int id : pending_){
+        if(alive_[id] && slot_[id] == NONE){
+            Entry entry = {end_[id], start_[id] == end_[id], id, version_[id]};
+            merged_.push_back(entry);
+            slot_[id] = 0; // mark as handled, the actual slot is set below
+        }
+    }
+    pending_.clear();
+    std::sort(merged_.begin(), merged_.end());
+
+    // everything left of the first new or invalidated entry stays untouched
+    size_t first = dirty_;
+    if(!merged_.empty()){
+        first = std::min(first, (size_t)(std::lower_bound(entries_.begin(), entries_.end(), merged_.front()) - entries_.begin()));
+    }
+    first = std::min(first, entries_.size());
+
+    // merge the new entries with the still valid old ones right of first
+    size_t newCount = merged_.size();
+    for(size_t i = first; i < entries_.size(); ++i){
+        const Entry & entry = entries_[i];
+        if(alive_[entry.id] && version_[entry.id] == entry.version){
+            merged_.push_back(entry);
+        }
+    }
+    std::inplace_merge(merged_.begin(), merged_.begin()+newCount, merged_.end());
+
+    entries_.resize(first);
+    for(const Entry & entry : merged_){
+        slot_[entry.id] = entries_.size();
+        entries_.push_back(entry);
+    }
+    assert(entries_.size() == size_);
+
+    // recompute the dynamic program right of first
+    table_.resize(entries_.size()+1);
+    last_.resize(entries_.size()+1);
+    taken_.resize(entries_.size()+1);
+    for(size_t e = first+1; e < entries_.size()+1; ++e){
+        const Entry & entry = entries_[e-1];
+
+        // number of intervals that end before the current one starts. On ties the end lies
+        // to the left of the start.
+        Entry startKey = {start_[entry.id], true, std::numeric_limits<int>::max(), 0};
+        size_t last = std::upper_bound(entries_.begin(), entries_.begin()+(e-1), startKey) - entries_.begin();
+
+        double weight = weight_[entry.id];
+        if(table_[e-1] > weight+table_[last]){
+            table_[e] = table_[e-1];
+            taken_[e] = false;
+        }else{
+            table_[e] = table_[last]+weight;
+            taken_[e] = true;
+        }
+        last_[e] = last;
+    }
+    dirty_ = entries_.size();
+
+    std::vector<int> result;
+    size_t entry = entries_.size();
+    while(entry != 0){
+        if(taken_[entry]){
+            result.push_back(entries_[entry-1].id);
+            entry = last_[entry];
+        }else{
+            entry--;
+        }
+    }
+
+    return result;
+}
+
 double check(const std::vector<WeightedInterval> & intervals, const std::vector<int> & mwis);
 
 bool areIndependent(const std::vector<WeightedInterval> & intervals, const std::vector<int> & set){
@@ -308,6 +614,23 @@ void test9(){
     assert(s < e);
 }
 
+// the radix kernel and the batch against the original implementation, once on random intervals
+void test10(){
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> pos(0, 1000), len(0, 30), weight(0, 100);
+    std::vector<WeightedInterval> intervals;
+    for(int i = 0; i < 2000; ++i){
+        double start = pos(rng);
+        intervals.push_back(WeightedInterval(start, start+len(rng), weight(rng)));
+    }
+    std::vector<int> legacy = computeMWISLegacy(intervals);
+    assert(computeMWIS(intervals) == legacy);
+    std::vector<std::vector<WeightedInterval>> batch(4, intervals);
+    for(const std::vector<int> & result : computeMWISBatch(batch, 2)){
+        assert(result == legacy);
+    }
+}
+
 
 double check(const std::vector<WeightedInterval> & intervals, const std::vector<int> & mwis){
    double weight =0;
@@ -329,6 +652,72 @@ double check(const std::vector<WeightedInterval> & intervals, const std::vector<
    return weight;
 }
 
+void benchmarkMWIS(){
+    std::vector<std::vector<WeightedInterval>> sets;
+    sets.push_back({WeightedInterval(0,1,1), WeightedInterval(2,3,1), WeightedInterval(4,5,1),
+                    WeightedInterval(6,7,1), WeightedInterval(8,9,1), WeightedInterval(10,11,1)});
+    sets.push_back({WeightedInterval(2,3,1), WeightedInterval(4,5,1), WeightedInterval(6,7,1),
+                    WeightedInterval(8,9,1), WeightedInterval(0,10,1)});
+    sets.push_back({WeightedInterval(2,3,1), WeightedInterval(4,5,1), WeightedInterval(6,7,1),
+                    WeightedInterval(8,9,1), WeightedInterval(0,10,5)});
+    sets.push_back({WeightedInterval(0,1,1), WeightedInterval(0,2,1), WeightedInterval(0,3,1),
+                    WeightedInterval(0,4,1), WeightedInterval(0,5,1)});
+    sets.push_back({WeightedInterval(0,1,1), WeightedInterval(1,2,1), WeightedInterval(2,3,1),
+                    WeightedInterval(4,5,1), WeightedInterval(6,7,1)});
+    sets.push_back({WeightedInterval(0,1,1), WeightedInterval(1,2,1), WeightedInterval(2,3,1),
+                    WeightedInterval(0.5,2.5,1), WeightedInterval(2.8,7,1)});
+    sets.push_back({WeightedInterval(0,1,1), WeightedInterval(1,2,1), WeightedInterval(2,3,1),
+                    WeightedInterval(0.5,2.5,1), WeightedInterval(2.8,7,0.5)});
+    sets.push_back({WeightedInterval(0,1,1), WeightedInterval(1,2,1), WeightedInterval(0.5,1.5,10),
+                    WeightedInterval(0.5,1.5,10)});
+    // the end points of test9
+    sets.push_back({WeightedInterval(4000,4799.943587124837,1), WeightedInterval(4799.943587124837,5000,1)});
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> pos(0, 10000), len(0, 300), weight(0, 100);
+    std::vector<WeightedInterval> large;
+    for(int i = 0; i < 20000; ++i){
+        double start = pos(rng);
+        large.push_back(WeightedInterval(start, start+len(rng), weight(rng)));
+    }
+
+    auto run = [](std::vector<WeightedInterval> & intervals, int repetitions, bool legacy){
+        MWISSolver solver;
+        std::vector<int> result;
+        auto begin = std::chrono::steady_clock::now();
+        for(int r = 0; r < repetitions; ++r){
+            if(legacy){
+                result = computeMWISLegacy(intervals);
+            }else{
+                solver.compute(intervals, result);
+            }
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+        return std::make_pair(result, elapsed.count());
+    };
+
+    double legacyTime = 0, radixTime = 0;
+    for(std::vector<WeightedInterval> & intervals : sets){
+        auto legacy = run(intervals, 100000, true);
+        auto radix = run(intervals, 100000, false);
+        assert(legacy.first == radix.first);
+        legacyTime += legacy.second;
+        radixTime += radix.second;
+    }
+    std::cout << "MWIS on test1..test9, 100000 times each: legacy " << legacyTime << "s, radix " << radixTime << "s" << std::endl;
+
+    auto legacy = run(large, 20, true);
+    auto radix = run(large, 20, false);
+    assert(legacy.first == radix.first);
+    std::cout << "MWIS on 20000 random intervals, 20 times: legacy " << legacy.second << "s, radix " << radix.second << "s" << std::endl;
+
+    std::vector<std::vector<WeightedInterval>> batch(64, large);
+    std::vector<std::vector<int>> results = computeMWISBatch(batch, 4);
+    for(const std::vector<int> & result : results){
+        assert(result == legacy.first);
+    }
+}
+
 bool testMWISAlgo(){
 #ifdef CONSISTENCY_CHECKS
     std::cout << "Run tests on algorithm for computing weight independent set on interval graphs." << std::endl;
@@ -341,6 +730,7 @@ bool testMWISAlgo(){
     test7();
     test8();
    // test9();
+    test10();
     std::cout << "Tests have been passed" << std::endl;
 #endif
     return true;
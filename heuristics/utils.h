@@ -3,6 +3,8 @@
 
 #include <vector>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
 
 class WeightedInterval{
 private:
@@ -43,6 +45,47 @@ public:
  */
 std::vector<int> computeMWIS(std::vector<WeightedInterval> &intervals);
 
+/**
+ * Solves many independent instances of computeMWIS (e.g., one per component) on the given number
+ * of threads. The i-th result belongs to the i-th set of intervals.
+ */
+std::vector<std::vector<int>> computeMWISBatch(const std::vector<std::vector<WeightedInterval>> &sets, int threads = 1);
+
+/**
+ * The kernel behind computeMWIS. It gives the same result, but keeps its scratch buffers between
+ * calls, so that repeated calls do not allocate once the buffers have grown to the largest instance.
+ *
+ * The end points are sorted by an LSD radix sort on the bit patterns of their coordinates, and
+ * compressed into ranks by one scan over the sorted end points. An instance must not be used by
+ * several threads at the same time.
+ */
+class MWISSolver{
+public:
+    std::vector<int> compute(const std::vector<WeightedInterval> &intervals);
+    /**
+     * Like above, but writes into the given vector, which keeps its capacity.
+     */
+    void compute(const std::vector<WeightedInterval> &intervals, std::vector<int> &result);
+
+private:
+    // sorts keys_ / slots_ by key, equal keys in the order of their slots
+    void sort(size_t count);
+
+    std::vector<uint64_t> keys_, keysTmp_;
+    std::vector<uint32_t> slots_, slotsTmp_; // end point 2i is the start, 2i+1 the end of interval i
+
+    std::vector<int> ends_;    // interval ids, ordered by their ends
+    std::vector<size_t> last_; // per interval: number of intervals ending before it starts
+    std::vector<double> table_;
+    std::vector<char> taken_;
+};
+
+/**
+ * Compares MWISSolver against the original implementation on the test cases of the self-test
+ * and on a larger random instance, and prints the running times of both (--benchmark-mwis).
+ */
+void benchmarkMWIS();
+
 /**
  * Checks for a subset of intervals whether they are independent, i.e., whether they do not intersect
  * pairwise.
@@ -50,6 +93,76 @@ std::vector<int> computeMWIS(std::vector<WeightedInterval> &intervals);
  */
 bool areIndependent(const std::vector<WeightedInterval> & intervals, const std::vector<int> & set);
 
+/**
+ * Maintains the maximum weight independent set of a set of weighted intervals that changes
+ * over time, e.g., between the rounds of the interval graph heuristic.
+ *
+ * Intervals are identified by dense ids 0..n-1. The end points stay sorted across calls to
+ * compute(): removed or changed intervals only invalidate their old position, and the
+ * dynamic program is only recomputed from the leftmost changed position onward.
+ * The result is the same as that of computeMWIS on the current set of intervals, including
+ * how intervals of length zero combine with those that end at the same point.
+ */
+class IncrementalMWIS{
+public:
+    IncrementalMWIS(size_t n);
+
+    /**
+     * Inserts the interval with the given id, or replaces it if it is already contained.
+     */
+    void update(int id, double start, double end, double weight);
+    void remove(int id);
+
+    bool contains(int id) const {return alive_[id];}
+    bool empty() const {return size_ == 0;}
+    size_t size() const {return size_;}
+
+    WeightedInterval interval(int id) const {
+        return WeightedInterval(id, start_[id], end_[id], weight_[id]);
+    }
+
+    /**
+     * Applies all changes since the last call and returns the ids of the intervals in a
+     * maximum weight independent set, from right to left.
+     */
+    std::vector<int> compute();
+
+private:
+    // ordered like the ends in MWISSolver: by end, those of length zero behind the others of
+    // the same end, then by id
+    struct Entry{
+        double end;
+        bool point;
+        int id;
+        unsigned int version;
+
+        bool operator < (const Entry & e) const{
+            return end < e.end || (end == e.end && (point < e.point || (point == e.point && id < e.id)));
+        }
+    };
+
+    void invalidate(int id);
+
+    std::vector<double> start_, end_, weight_;
+    std::vector<bool> alive_;
+    std::vector<unsigned int> version_;
+    std::vector<size_t> slot_;   // position of the current entry of an id, or NONE
+    std::vector<int> pending_;   // ids that need a new entry
+
+    std::vector<Entry> entries_; // sorted by end point
+    std::vector<Entry> merged_;  // scratch space for rebuilding the suffix
+
+    // The dynamic program, 1-based: table_[i] is the best weight using the first i entries
+    std::vector<double> table_;
+    std::vector<size_t> last_;
+    std::vector<bool> taken_;
+
+    size_t dirty_; // leftmost entry that changed since the last call
+    size_t size_;
+
+    static const size_t NONE = static_cast<size_t>(-1);
+};
+
 
 
 #endif // UTILS_H
@@ -0,0 +1,93 @@
+/*
+ * Coarsening.cpp
+ *
+ * Reducing the number of events of an instance before its model is built.
+ */
+#include <algorithm>
+#include <cassert>
+#include <set>
+#include "Coarsening.h"
+
+namespace ILP {
+
+namespace {
+
+/* All endpoints of the intervals, together with 0 and 1 */
+set<double> collectEvents(Instance * instance){
+	set<double> events;
+	for(Intervals *intervals : *instance->intervalsOfLabels){
+		events.insert(intervals->begin(), intervals->end());
+	}
+	for(Intervals *intervals : *instance->intervalsOfConflicts){
+		events.insert(intervals->begin(), intervals->end());
+	}
+	events.insert(0.0);
+	events.insert(1.0);
+	return events;
+}
+
+}
+
+int coarsenInstance(Instance * instance, double tolerance){
+	if(tolerance <= 0){
+		return 0;
+	}
+
+	set<double> eventSet = collectEvents(instance);
+	vector<double> events(eventSet.begin(), eventSet.end());
+
+	// the first and the last endpoint of the cluster of every event
+	vector<double> first(events.size());
+	vector<double> last(events.size());
+	for(size_t begin=0; begin < events.size();){
+		size_t end = begin;
+		while(end+1 < events.size() && events[end+1] - events[begin] < tolerance){
+			++end;
+		}
+		for(size_t i=begin; i <= end; ++i){
+			first[i] = events[begin];
+			last[i] = events[end];
+		}
+		begin = end+1;
+	}
+
+	auto snap = [&events](const vector<double> &targets, double value){
+		if(value == 0.0 || value == 1.0){
+			return value;
+		}
+		vector<double>::const_iterator it = lower_bound(events.begin(), events.end(), value);
+		assert(it != events.end() && *it == value);
+		return targets[it - events.begin()];
+	};
+
+	for(Intervals *presences : *instance->intervalsOfLabels){
+		Intervals coarse(presences->getId());
+		for(int i=0; i < presences->getNumberOfIntervals(); ++i){
+			double begin = snap(last, presences->at(2*i));
+			double end = snap(first, presences->at(2*i+1));
+			if(begin < end){
+				coarse.add(begin, end);
+			}
+		}
+		*presences = coarse;
+	}
+
+	for(Intervals *conflict : *instance->intervalsOfConflicts){
+		Intervals coarse(conflict->getId());
+		for(int i=0; i < conflict->getNumberOfIntervals(); ++i){
+			double begin = snap(first, conflict->at(2*i));
+			double end = snap(last, conflict->at(2*i+1));
+			// a gap below the tolerance is closed
+			if(coarse.getNumberOfIntervals() > 0 && begin - coarse.back() < tolerance){
+				coarse.back() = max(coarse.back(), end);
+			}else{
+				coarse.add(begin, end);
+			}
+		}
+		*conflict = coarse;
+	}
+
+	return eventSet.size() - collectEvents(instance).size();
+}
+
+} // namespace ILP
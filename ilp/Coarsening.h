@@ -0,0 +1,34 @@
+/*
+ * Coarsening.h
+ *
+ * Reducing the number of events of an instance before its model is built.
+ */
+
+#ifndef COARSENING_H_
+#define COARSENING_H_
+
+#include "Instance.h"
+#include "Intervals.h"
+
+namespace ILP {
+
+/**
+ * Snaps endpoints that lie closer together than the tolerance onto common events, and merges
+ * the intervals of a conflict that are separated by less than the tolerance.
+ *
+ * The endpoints are grouped from left to right into clusters that span less than the
+ * tolerance. A presence interval begins at the last endpoint of its cluster and ends at the
+ * first one, a conflict interval begins at the first and ends at the last one. Thus presence
+ * intervals only shrink (those that become empty are removed, so a label may be left without
+ * any, and is then never selected) and conflict intervals only grow, so a conflict-free
+ * selection of the coarsened instance is also conflict-free under the original intervals.
+ * The rules of the models hold at the coarsened endpoints, i.e., up to the tolerance. 0 and 1
+ * are never moved.
+ *
+ * Returns the number of events that were removed.
+ */
+int coarsenInstance(Instance * instance, double tolerance);
+
+} // namespace ILP
+
+#endif /* COARSENING_H_ */
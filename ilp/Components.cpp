@@ -0,0 +1,135 @@
+/*
+ * Components.cpp
+ *
+ * Splitting an instance into independent parts, moved here from Main.cpp.
+ */
+#include <cassert>
+#include <list>
+#include "Components.h"
+#include "config.h"
+
+namespace ILP {
+
+void findComponents(Instance * instance,vector<Instance*>& instances){
+	vector<vector<int> > graph = vector<vector<int> >();
+	int * component = new int[instance->intervalsOfLabels->size()];
+
+	for(unsigned int i=0; i < instance->intervalsOfLabels->size(); i++){
+		graph.push_back(vector<int>());
+		component[i]=0;
+	}
+
+	for(vector<Conflict*>::iterator it = instance->conflicts->begin() ;
+			it != instance->conflicts->end(); ++it){
+		Conflict * c = *it;
+		graph[c->getLabel1()].push_back(c->getLabel2());
+		graph[c->getLabel2()].push_back(c->getLabel1());
+	}
+
+	list<int> queue = list<int>();
+
+	int index =1;
+
+	for(unsigned int i=0; i < instance->intervalsOfLabels->size(); i++){
+		if(component[i]==0){
+
+			queue.push_back(i);
+			component[i] = index;
+			while(!queue.empty()){
+				int label = queue.front();
+				queue.pop_front();
+				for(vector<int>::iterator it =  graph[label].begin(); it != graph[label].end(); ++it){
+					int opponent = *it;
+					if(component[opponent]== 0){
+					    component[opponent] = index;
+					   	queue.push_back(opponent);
+
+					}else if(component[opponent]!= index){
+						throw "error!!!!";
+					}
+				}
+			}
+
+			index++;
+		}
+
+	}
+
+
+
+	for(int i=0; i < index-1; i++){
+		instances.push_back(new Instance());
+		instances.back()->ownsIntervals = false;
+		instances.back()->originalMax = instance->originalMax;
+	}
+
+	int * newIds = new int[instance->intervalsOfLabels->size()];
+
+	for(unsigned int i=0; i < instance->intervalsOfLabels->size(); i++){
+		newIds[i] = instances[component[i]-1]->intervalsOfLabels->size();
+		instances[component[i]-1]->intervalsOfLabels->push_back(instance->intervalsOfLabels->at(i));
+	}
+
+
+
+	for(unsigned int i=0; i < instance->conflicts->size(); i++){
+		Conflict *c = instance->conflicts->at(i);
+		if(component[c->label1] != component[c->label2]){
+			throw "Wrong components";
+		}
+		int comp = component[c->label1];
+		instances[comp-1]->conflicts->push_back(new Conflict(newIds[c->label1],newIds[c->label2]));
+
+		instances[comp-1]->intervalsOfConflicts->push_back(instance->intervalsOfConflicts->at(i));
+	}
+//
+//	cout << newIds[36] << " " << newIds[37] << endl;
+//		cout << component[36] << " " << component[37] << endl;
+//		Instance * test = instances[32];
+//		for(int i=0; i  < test->intervalsOfLabels->size(); i++){
+//			cout << test->intervalsOfLabels->at(i)->getId() << endl;
+//		}
+//		for(int i=0; i  < test->conflicts->size(); i++){
+//			cout << test->intervalsOfConflicts->at(i)->getId() << endl;
+//			cout << test->conflicts->at(i)->label1 << " " <<test->conflicts->at(i)->label2  << endl;
+//		}
+		//throw "check";
+
+	delete [] component;
+	delete [] newIds;
+
+}
+
+void solveSingleLabel(Instance * instance, vector<Intervals>& result){
+	assert(instance->intervalsOfLabels->size() == 1);
+	Intervals * presences = instance->intervalsOfLabels->at(0);
+	int count = presences->getNumberOfIntervals();
+
+	// A presence shorter than the minimum selection length cannot end a selection (see the
+	// constraints c7_ and the minimum length constraint of the ILP), but it may be part of one
+	// that continues into the next presence or reaches the end of the instance.
+	vector<bool> selected(count, false);
+	for(int presence = count-1; presence >= 0; --presence){
+		double begin = presences->at(presence*2);
+		double end = presences->at(presence*2+1);
+		bool longEnough = (end - begin) >= (MINIMUM_SELECTION_LENGTH / instance->originalMax);
+		bool continues = (presence+1 < count) && selected[presence+1] && (presences->at(presence*2+2) == end);
+		selected[presence] = longEnough || (end == 1.0) || continues;
+	}
+
+	Intervals intervals = Intervals(presences->getId());
+	for(int presence = 0; presence < count; ++presence){
+		if(!selected[presence]){
+			continue;
+		}
+		double begin = presences->at(presence*2);
+		// adjacent selected presences are one selection
+		while(presence+1 < count && selected[presence+1] && presences->at(presence*2+2) == presences->at(presence*2+1)){
+			presence++;
+		}
+		intervals.add(begin, presences->at(presence*2+1));
+	}
+	result.push_back(intervals);
+}
+
+} // namespace ILP
@@ -0,0 +1,38 @@
+/*
+ * Components.h
+ *
+ * Splitting an instance into independent parts, moved here from Main.cpp.
+ */
+
+#ifndef COMPONENTS_H_
+#define COMPONENTS_H_
+
+#include <vector>
+#include "Instance.h"
+#include "Intervals.h"
+
+using namespace std;
+
+namespace ILP {
+
+/**
+ * Splits the instance into the connected components of its conflict graph, one new instance
+ * for each. Labels and conflicts are renumbered within a component, the intervals keep their
+ * ids. The components share the intervals of the instance, which stays their owner, so they
+ * must be deleted before it.
+ *
+ * Without a k-restriction, the optimum of the instance is the union of the optima of the
+ * components. A k-restriction couples all labels, so it has to be solved as a whole.
+ */
+void findComponents(Instance * instance,vector<Instance*>& instances);
+
+/**
+ * The optimal selection of an instance with a single label (and thus no conflicts), the same
+ * that ILP::execute() would find: every presence interval is selected as a whole if it is long
+ * enough, reaches the end of the instance, or continues into a selected adjacent presence.
+ */
+void solveSingleLabel(Instance * instance, vector<Intervals>& result);
+
+} // namespace ILP
+
+#endif /* COMPONENTS_H_ */
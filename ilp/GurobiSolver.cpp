@@ -0,0 +1,281 @@
+/*
+ * GurobiSolver.cpp
+ *
+ * The Gurobi backend of the MIP layer.
+ */
+#include <cmath>
+#include <mutex>
+#include <vector>
+#include <gurobi_c++.h>
+#include "GurobiSolver.h"
+#include "config.h"
+
+namespace MIP {
+
+namespace {
+
+/* The errors of Gurobi as the ones of the MIP layer */
+Error convert(const GRBException &e) {
+	return Error(e.getMessage(), e.getErrorCode(), e.getErrorCode() == GRB_ERROR_OUT_OF_MEMORY);
+}
+
+/**
+ * Passes the incumbent and the bound of a running optimization on, and stops the
+ * optimization once it is interrupted.
+ */
+class Callback : public GRBCallback {
+public:
+	Callback(const Solver::Progress &progress, const Solver::Interrupt &interrupt) : progress(progress), interrupt(interrupt) {}
+
+protected:
+	void callback() {
+		if (where == GRB_CB_MIP && this->progress) {
+			this->progress(getDoubleInfo(GRB_CB_MIP_OBJBST), getDoubleInfo(GRB_CB_MIP_OBJBND));
+		}
+		if (this->interrupt && this->interrupt()) {
+			abort();
+		}
+	}
+
+private:
+	const Solver::Progress &progress;
+	const Solver::Interrupt &interrupt;
+};
+
+/**
+ * The environments of all solvers of the process. Starting an environment checks out the
+ * licence, which takes a while, so they are kept for the next solver once they are free. An
+ * environment must only be used by one thread at a time, so there are as many as there were
+ * solvers at the same time. Every model gets its own copy of the parameters.
+ */
+class EnvironmentPool {
+public:
+	~EnvironmentPool() {
+		for (GRBEnv *env : this->idle) {
+			delete env;
+		}
+	}
+
+	GRBEnv *take() {
+		{
+			std::lock_guard<std::mutex> lock(this->mutex);
+			if (!this->idle.empty()) {
+				GRBEnv *env = this->idle.back();
+				this->idle.pop_back();
+				return env;
+			}
+		}
+
+		GRBEnv *env = new GRBEnv();
+		env->set(GRB_IntParam_PrePasses, PRESOLVE_ITERATIONS);
+		env->set(GRB_IntParam_LogToConsole, 1);
+
+		env->set(GRB_IntParam_Presolve, 1);
+
+		/* This is necessary because of a bug in Gurobi up to version 6.5. Supposedly it
+		 * will be fixed in later versions, see:
+		 * https://groups.google.com/forum/#!topic/gurobi/JJl0ptJZwzE
+		 */
+		env->set(GRB_IntParam_Aggregate, 0);
+		return env;
+	}
+
+	void give(GRBEnv *env) {
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->idle.push_back(env);
+	}
+
+private:
+	std::mutex mutex;
+	std::vector<GRBEnv *> idle;
+};
+
+EnvironmentPool &environments() {
+	static EnvironmentPool pool;
+	return pool;
+}
+
+}
+
+GurobiSolver::GurobiSolver(int threads) : threads(threads), env(nullptr), model(nullptr), vars(nullptr), constrs(nullptr), numberOfVars(0) {
+}
+
+GurobiSolver::~GurobiSolver() {
+	clear();
+}
+
+void GurobiSolver::clear() {
+	delete[] this->vars;
+	delete[] this->constrs;
+	// the model must be gone before its environment is used again
+	delete this->model;
+	if (this->env != nullptr) {
+		environments().give(this->env);
+	}
+	this->vars = nullptr;
+	this->constrs = nullptr;
+	this->model = nullptr;
+	this->env = nullptr;
+	this->numberOfVars = 0;
+}
+
+void GurobiSolver::load(const Model &model) {
+	clear();
+	try {
+		this->env = environments().take();
+		this->model = new GRBModel(*this->env);
+		this->model->getEnv().set(GRB_IntParam_Threads, this->threads);
+		this->numberOfVars = model.getNumberOfVars();
+		std::vector<double> upper(this->numberOfVars, 1.0);
+		std::vector<char> types(this->numberOfVars, GRB_BINARY);
+		this->vars = this->model->addVars(nullptr, upper.data(), model.getObjective().data(), types.data(), nullptr, this->numberOfVars);
+		this->model->set(GRB_IntAttr_ModelSense, model.getObjectiveSense() == MAXIMIZE ? GRB_MAXIMIZE : GRB_MINIMIZE);
+		this->model->update();
+
+		// the rows are added empty, and then filled from the compressed rows in one call
+		const std::vector<int> &begins = model.getRowBegins();
+		const std::vector<int> &columns = model.getColumns();
+		int count = model.getNumberOfConstrs();
+		this->constrs = this->model->addConstrs(count);
+		this->model->update();
+		this->model->set(GRB_CharAttr_Sense, this->constrs, model.getSenses().data(), count);
+		this->model->set(GRB_DoubleAttr_RHS, this->constrs, model.getRhs().data(), count);
+		if (model.isNamed()) {
+			this->model->set(GRB_StringAttr_ConstrName, this->constrs, model.getNames().data(), count);
+		}
+		std::vector<GRBConstr> entryConstrs(columns.size());
+		std::vector<GRBVar> entryVars(columns.size());
+		for (int row = 0; row < count; ++row) {
+			for (int entry = begins[row]; entry < begins[row+1]; ++entry) {
+				entryConstrs[entry] = this->constrs[row];
+				entryVars[entry] = this->vars[columns[entry]];
+			}
+		}
+		this->model->chgCoeffs(entryConstrs.data(), entryVars.data(), model.getValues().data(), columns.size());
+		if (!model.getLazy().empty()) {
+			// Gurobi keeps lazy constraints out of the relaxation, and adds them in its callback
+			std::vector<int> lazy(model.getLazy().begin(), model.getLazy().end());
+			this->model->set(GRB_IntAttr_Lazy, this->constrs, lazy.data(), count);
+		}
+
+		if (!model.getStart().empty()) {
+			setStart(model.getStart());
+		}
+		this->model->update();
+	} catch (GRBException e) {
+		throw convert(e);
+	}
+}
+
+void GurobiSolver::setStart(const std::vector<double> &values) {
+	std::vector<double> start(values);
+	for (double &value : start) {
+		if (std::isnan(value)) {
+			value = GRB_UNDEFINED;
+		}
+	}
+	try {
+		this->model->set(GRB_DoubleAttr_Start, this->vars, start.data(), this->numberOfVars);
+	} catch (GRBException e) {
+		throw convert(e);
+	}
+}
+
+void GurobiSolver::changeCoefficient(Constr constr, Var var, double value) {
+	try {
+		this->model->chgCoeff(this->constrs[constr.index], this->vars[var.index], value);
+	} catch (GRBException e) {
+		throw convert(e);
+	}
+}
+
+void GurobiSolver::changeRhs(Constr constr, double rhs) {
+	try {
+		this->constrs[constr.index].set(GRB_DoubleAttr_RHS, rhs);
+	} catch (GRBException e) {
+		throw convert(e);
+	}
+}
+
+void GurobiSolver::setTimeLimit(double seconds) {
+	try {
+		this->model->getEnv().set(GRB_DoubleParam_TimeLimit, seconds);
+	} catch (GRBException e) {
+		throw convert(e);
+	}
+}
+
+void GurobiSolver::setThreads(int threads) {
+	this->threads = threads;
+	if (this->model == nullptr) {
+		return;
+	}
+	try {
+		this->model->getEnv().set(GRB_IntParam_Threads, threads);
+	} catch (GRBException e) {
+		throw convert(e);
+	}
+}
+
+Solver::Status GurobiSolver::optimize(const Progress &progress, const Interrupt &interrupt) {
+	try {
+		Callback callback(progress, interrupt);
+		if (progress || interrupt) {
+			this->model->setCallback(&callback);
+		}
+		this->model->optimize();
+		this->model->setCallback(nullptr);
+
+		int status = this->model->get(GRB_IntAttr_Status);
+		return (status == GRB_TIME_LIMIT || status == GRB_INTERRUPTED) ? STOPPED : FINISHED;
+	} catch (GRBException e) {
+		this->model->setCallback(nullptr);
+		throw convert(e);
+	}
+}
+
+bool GurobiSolver::hasSolution() const {
+	try {
+		return this->model->get(GRB_IntAttr_SolCount) > 0;
+	} catch (GRBException e) {
+		throw convert(e);
+	}
+}
+
+std::vector<double> GurobiSolver::getValues() const {
+	try {
+		double *values = this->model->get(GRB_DoubleAttr_X, this->vars, this->numberOfVars);
+		std::vector<double> result(values, values + this->numberOfVars);
+		delete[] values;
+		return result;
+	} catch (GRBException e) {
+		throw convert(e);
+	}
+}
+
+double GurobiSolver::getBound() const {
+	try {
+		return this->model->get(GRB_DoubleAttr_ObjBound);
+	} catch (GRBException e) {
+		throw convert(e);
+	}
+}
+
+double GurobiSolver::getGap() const {
+	try {
+		return this->model->get(GRB_DoubleAttr_MIPGap);
+	} catch (GRBException e) {
+		throw convert(e);
+	}
+}
+
+void GurobiSolver::write(const char *filename) {
+	try {
+		this->model->update();
+		this->model->write(filename);
+	} catch (GRBException e) {
+		throw convert(e);
+	}
+}
+
+} // namespace MIP
@@ -0,0 +1,59 @@
+/*
+ * GurobiSolver.h
+ *
+ * The Gurobi backend of the MIP layer.
+ */
+
+#ifndef GUROBISOLVER_H_
+#define GUROBISOLVER_H_
+
+#include "MIP.h"
+
+class GRBEnv;
+class GRBModel;
+class GRBVar;
+class GRBConstr;
+
+namespace MIP {
+
+/**
+ * Solves the models with Gurobi, which needs a licence on every machine it runs on.
+ */
+class GurobiSolver : public Solver {
+public:
+	GurobiSolver(int threads);
+	~GurobiSolver();
+
+	void load(const Model &model);
+	void setStart(const std::vector<double> &values);
+	void changeCoefficient(Constr constr, Var var, double value);
+	void changeRhs(Constr constr, double rhs);
+
+	void setTimeLimit(double seconds);
+	void setThreads(int threads);
+	Status optimize(const Progress &progress, const Interrupt &interrupt);
+
+	bool hasSolution() const;
+	std::vector<double> getValues() const;
+	double getBound() const;
+	double getGap() const;
+
+	void write(const char *filename);
+
+private:
+	void clear();
+
+	int threads;
+	GRBEnv *env;
+	GRBModel *model;
+	GRBVar *vars;
+	GRBConstr *constrs;
+	int numberOfVars;
+
+	GurobiSolver(const GurobiSolver &) = delete;
+	GurobiSolver &operator=(const GurobiSolver &) = delete;
+};
+
+} // namespace MIP
+
+#endif /* GUROBISOLVER_H_ */
@@ -0,0 +1,171 @@
+/*
+ * HighsSolver.cpp
+ *
+ * The HiGHS backend of the MIP layer.
+ */
+#include <cmath>
+#include <new>
+#include <Highs.h>
+#include "HighsSolver.h"
+
+namespace MIP {
+
+namespace {
+
+/* Throws if HiGHS reports an error, warnings are only logged by HiGHS itself */
+void check(HighsStatus status, const char *what) {
+	if (status == HighsStatus::kError) {
+		throw Error(std::string("HiGHS failed to ") + what);
+	}
+}
+
+/* What the callback needs to know during optimize() */
+struct CallbackData {
+	const Solver::Progress *progress;
+	const Solver::Interrupt *interrupt;
+	int objectiveSense;
+};
+
+void callback(const int type, const std::string &, const HighsCallbackDataOut *out, HighsCallbackDataIn *in, void *data) {
+	const CallbackData &callbackData = *static_cast<const CallbackData *>(data);
+	if (*callbackData.progress) {
+		// HiGHS reports infinity if there is no solution yet
+		double best = out->mip_primal_bound;
+		if (std::abs(best) >= kHighsInf) {
+			best = callbackData.objectiveSense * INFINITE;
+		}
+		(*callbackData.progress)(best, out->mip_dual_bound);
+	}
+	if (type == kCallbackMipInterrupt && *callbackData.interrupt && (*callbackData.interrupt)()) {
+		in->user_interrupt = true;
+	}
+}
+
+}
+
+HighsSolver::HighsSolver(int) : highs(new Highs()), objectiveSense(MINIMIZE) {
+}
+
+HighsSolver::~HighsSolver() {
+	delete this->highs;
+}
+
+void HighsSolver::load(const Model &model) {
+	try {
+		int columns = model.getNumberOfVars();
+		int rows = model.getNumberOfConstrs();
+
+		HighsLp lp;
+		lp.num_col_ = columns;
+		lp.num_row_ = rows;
+		lp.sense_ = model.getObjectiveSense() == MAXIMIZE ? ObjSense::kMaximize : ObjSense::kMinimize;
+		lp.col_cost_ = model.getObjective();
+		lp.col_lower_.assign(columns, 0.0);
+		lp.col_upper_.assign(columns, 1.0);
+		lp.integrality_.assign(columns, HighsVarType::kInteger);
+
+		lp.row_lower_.resize(rows);
+		lp.row_upper_.resize(rows);
+		for (int row = 0; row < rows; ++row) {
+			double rhs = model.getRhs()[row];
+			char sense = model.getSenses()[row];
+			lp.row_lower_[row] = (sense == LESS_EQUAL) ? -kHighsInf : rhs;
+			lp.row_upper_[row] = (sense == GREATER_EQUAL) ? kHighsInf : rhs;
+		}
+		if (model.isNamed()) {
+			lp.row_names_ = model.getNames();
+		}
+
+		lp.a_matrix_.format_ = MatrixFormat::kRowwise;
+		lp.a_matrix_.num_col_ = columns;
+		lp.a_matrix_.num_row_ = rows;
+		lp.a_matrix_.start_.assign(model.getRowBegins().begin(), model.getRowBegins().end());
+		lp.a_matrix_.index_.assign(model.getColumns().begin(), model.getColumns().end());
+		lp.a_matrix_.value_ = model.getValues();
+
+		check(this->highs->clearModel(), "clear the model");
+		check(this->highs->setOptionValue("output_flag", true), "set the output");
+		check(this->highs->setOptionValue("presolve", "on"), "set the presolve");
+		check(this->highs->passModel(lp), "load the model");
+		this->objectiveSense = model.getObjectiveSense();
+
+		if (!model.getStart().empty()) {
+			setStart(model.getStart());
+		}
+	} catch (std::bad_alloc &) {
+		throw Error("HiGHS is out of memory", 0, true);
+	}
+}
+
+void HighsSolver::setStart(const std::vector<double> &values) {
+	// only the variables with a value, HiGHS completes the rest
+	std::vector<HighsInt> indices;
+	std::vector<double> known;
+	for (unsigned int i = 0; i < values.size(); ++i) {
+		if (!std::isnan(values[i])) {
+			indices.push_back(i);
+			known.push_back(values[i]);
+		}
+	}
+	check(this->highs->setSolution(indices.size(), indices.data(), known.data()), "set the start");
+}
+
+void HighsSolver::changeCoefficient(Constr constr, Var var, double value) {
+	check(this->highs->changeCoeff(constr.index, var.index, value), "change a coefficient");
+}
+
+void HighsSolver::changeRhs(Constr constr, double rhs) {
+	// HiGHS bounds the rows from both sides, the infinite one stays
+	const HighsLp &lp = this->highs->getLp();
+	double lower = (lp.row_lower_[constr.index] <= -kHighsInf) ? -kHighsInf : rhs;
+	double upper = (lp.row_upper_[constr.index] >= kHighsInf) ? kHighsInf : rhs;
+	check(this->highs->changeRowBounds(constr.index, lower, upper), "change a right-hand side");
+}
+
+void HighsSolver::setTimeLimit(double seconds) {
+	check(this->highs->setOptionValue("time_limit", seconds), "set the time limit");
+}
+
+void HighsSolver::setThreads(int) {
+	// the branch and bound runs on one thread anyway
+}
+
+Solver::Status HighsSolver::optimize(const Progress &progress, const Interrupt &interrupt) {
+	CallbackData data = {&progress, &interrupt, this->objectiveSense};
+	try {
+		check(this->highs->setCallback(callback, &data), "set the callback");
+		check(this->highs->startCallback(kCallbackMipImprovingSolution), "start the callback");
+		check(this->highs->startCallback(kCallbackMipInterrupt), "start the callback");
+		HighsStatus status = this->highs->run();
+		this->highs->stopCallback(kCallbackMipImprovingSolution);
+		this->highs->stopCallback(kCallbackMipInterrupt);
+		check(status, "solve the model");
+	} catch (std::bad_alloc &) {
+		throw Error("HiGHS is out of memory", 0, true);
+	}
+
+	HighsModelStatus status = this->highs->getModelStatus();
+	return (status == HighsModelStatus::kTimeLimit || status == HighsModelStatus::kInterrupt) ? STOPPED : FINISHED;
+}
+
+bool HighsSolver::hasSolution() const {
+	return this->highs->getInfo().primal_solution_status == kSolutionStatusFeasible;
+}
+
+std::vector<double> HighsSolver::getValues() const {
+	return this->highs->getSolution().col_value;
+}
+
+double HighsSolver::getBound() const {
+	return this->highs->getInfo().mip_dual_bound;
+}
+
+double HighsSolver::getGap() const {
+	return this->highs->getInfo().mip_gap;
+}
+
+void HighsSolver::write(const char *filename) {
+	check(this->highs->writeModel(filename), "write the model");
+}
+
+} // namespace MIP
@@ -0,0 +1,53 @@
+/*
+ * HighsSolver.h
+ *
+ * The HiGHS backend of the MIP layer.
+ */
+
+#ifndef HIGHSSOLVER_H_
+#define HIGHSSOLVER_H_
+
+#include "MIP.h"
+
+class Highs;
+
+namespace MIP {
+
+/**
+ * Solves the models with the open-source solver HiGHS, which needs no licence. Its branch and
+ * bound runs on one thread, so models only run in parallel as the components of the adapter.
+ * It has no lazy constraints, they are loaded like all others.
+ */
+class HighsSolver : public Solver {
+public:
+	/* threads is ignored, see above */
+	HighsSolver(int threads);
+	~HighsSolver();
+
+	void load(const Model &model);
+	void setStart(const std::vector<double> &values);
+	void changeCoefficient(Constr constr, Var var, double value);
+	void changeRhs(Constr constr, double rhs);
+
+	void setTimeLimit(double seconds);
+	void setThreads(int threads);
+	Status optimize(const Progress &progress, const Interrupt &interrupt);
+
+	bool hasSolution() const;
+	std::vector<double> getValues() const;
+	double getBound() const;
+	double getGap() const;
+
+	void write(const char *filename);
+
+private:
+	Highs *highs;
+	int objectiveSense;
+
+	HighsSolver(const HighsSolver &) = delete;
+	HighsSolver &operator=(const HighsSolver &) = delete;
+};
+
+} // namespace MIP
+
+#endif /* HIGHSSOLVER_H_ */
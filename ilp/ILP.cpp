@@ -5,7 +5,9 @@
  *      Author: benjamin
  */
 #include <set>
-#include <gurobi_c++.h>
+#include <algorithm>
+#include <cstring>
+#include <string>
 #include <sys/time.h>
 #include "Intervals.h"
 #include "ILP.h"
@@ -21,13 +23,14 @@ using namespace std;
 
 namespace ILP {
 
-ILP::ILP() {
-	// TODO Auto-generated constructor stub
+Options::Options() : sparse(ILP_SPARSE), solver(ILP_SOLVER), lazyConflicts(ILP_LAZY_CONFLICTS) {
+}
 
+ILP::ILP(Options options) : options(options), threads(0), timeLimit(0), solver(nullptr), instance(nullptr), events(nullptr), modelType(AM1), k(-1) {
 }
 
 ILP::~ILP() {
-	// TODO Auto-generated destructor stub
+	clear();
 }
 
 /**
@@ -62,43 +65,428 @@ string convert(double number)
 }
 
 bool ILP::execute(Instance* instance, ModelType modelType, vector<Intervals> & result,
-							double &resultBound, double &gap, Clock & clock, int k, ILPAdapter *adapter, const char *dbg_filename) {
+							double &resultBound, double &gap, Clock & clock, int k, ILPAdapter *adapter, const char *dbg_filename, int component) {
 
 	clock.start();
+	build(instance, modelType, k, dbg_filename);
+	return solve(result, resultBound, gap, clock, adapter, component);
+}
 
-	vector<double>* events = createEvents(instance);
+void ILP::clear() {
+	for(unsigned int i=0; i < this->B.size(); ++i){
+		delete[] this->B[i];
+		delete[] this->X[i];
+		delete[] this->E[i];
+		delete[] this->V[i];
+	}
+	this->B.clear();
+	this->X.clear();
+	this->E.clear();
+	this->V.clear();
+	this->segments.clear();
+	this->endWitnesses.clear();
+	this->beginWitnesses.clear();
+	this->kConstrs.clear();
+	this->k = -1;
+
+	delete this->solver;
+	delete this->events;
+	this->solver = nullptr;
+	this->events = nullptr;
+}
 
-	GRBEnv env = GRBEnv();
-  env.set(GRB_DoubleParam_TimeLimit, TIME_LIMIT);
-	env.set(GRB_IntParam_PrePasses, PRESOLVE_ITERATIONS);
-  env.set(GRB_IntParam_Threads,num_threads);
-	env.set(GRB_IntParam_LogToConsole, 1);
+void ILP::build(Instance *instance, ModelType modelType, int k, const char *dbg_filename) {
+	clear();
+	this->instance = instance;
+	this->events = createEvents(instance);
+	this->modelType = modelType;
+	this->k = k;
+
+	// names are only needed to write the model
+	MIP::Model model(dbg_filename != nullptr);
+
+	// The variables (see createDenseModel()), with the atomic segments they exist for
+	if (this->options.sparse) {
+		createSparseModel(model, instance, modelType, *this->events, k, B, X, E, V, segments);
+	} else {
+		createDenseModel(model, instance, modelType, this->events, k, B, X, E, V, segments);
+	}
 
-	env.set(GRB_IntParam_Presolve, 1);
+	if (!instance->boundaries.empty()) {
+		applyBoundaries(model, instance, B, X, segments);
+	}
+	if (!this->start.empty()) {
+		applyStart(model, instance, *this->events, B, X, E, V, segments);
+	}
 
-	/* This is necessary because of a bug in Gurobi up to version 6.5. Supposedly it
-	 * will be fixed in later versions, see:
-	 * https://groups.google.com/forum/#!topic/gurobi/JJl0ptJZwzE
-	 */
-	env.set(GRB_IntParam_Aggregate, 0);
+	if (!model.getLazy().empty()) {
+		std::cout << "ILP: " << (model.getNumberOfConstrs() - std::count(model.getLazy().begin(), model.getLazy().end(), MIP::EAGER))
+				<< " of " << model.getNumberOfConstrs() << " constraints are lazy\n";
+	}
+
+	this->solver = MIP::createSolver(this->options.solver, this->threads > 0 ? this->threads : num_threads);
+	this->solver->load(model);
+
+	if (dbg_filename != nullptr) {
+		this->solver->write(dbg_filename);
+	}
+}
+
+void ILP::changeModel(ModelType modelType) {
+	MIP::Solver &solver = *this->solver;
+	this->modelType = modelType;
+
+	// the last solution is feasible for all less restrictive models. It is taken before and
+	// passed after the changes, as changing the model may discard the solution of the solver.
+	bool restart = solver.hasSolution();
+	vector<double> values;
+	if (restart) {
+		values = solver.getValues();
+	}
+
+	// E <= sum of witnesses is E - sum <= 0
+	double endCoefficient = (modelType == AM2 || modelType == AM3) ? -1.0 : 0.0;
+	double beginCoefficient = (modelType == AM3) ? -1.0 : 0.0;
+	for(const Witness &witness : this->endWitnesses){
+		for(const MIP::Var &var : witness.vars){
+			solver.changeCoefficient(witness.constr, var, endCoefficient);
+		}
+	}
+	for(const Witness &witness : this->beginWitnesses){
+		for(const MIP::Var &var : witness.vars){
+			solver.changeCoefficient(witness.constr, var, beginCoefficient);
+		}
+	}
+
+	if (restart) {
+		solver.setStart(values);
+	}
+}
+
+void ILP::changeK(int k) {
+	MIP::Solver &solver = *this->solver;
+	assert(k < 0 || (this->k >= 0 && k >= this->k));
+
+	// the last solution, repaired to fit k, like in changeModel()
+	bool restart = solver.hasSolution();
+	vector<double> values;
+	if (restart) {
+		values = solver.getValues();
+		if (k >= 0) {
+			repairStart(values, k);
+		}
+	}
+
+	// no k-restriction is one that allows all labels
+	double rhs = (k >= 0) ? k : (double)this->X.size();
+	for(const MIP::Constr &constr : this->kConstrs){
+		solver.changeRhs(constr, rhs);
+	}
+
+	if (restart) {
+		solver.setStart(values);
+	}
+}
+
+/**
+ * A selection is a maximal run of atomic segments where X is 1, removing it sets its B, X
+ * and E to 0, which keeps condition (D). Where more than k selections overlap, the shortest
+ * ones are removed first. A selection that continues from before a window (see
+ * applyBoundaries()) stays. Removing selections creates no new begins or ends, but may take
+ * away the witness of one (c_9 and c_10 in the models that use them), so those selections are
+ * removed, too, until every begin and end has its witness again.
+ */
+void ILP::repairStart(vector<double> &values, int k) const {
+	int numberOfSegments = this->events->size()-1;
+
+	struct Selection {
+		int label;
+		int first;
+		int last;
+		bool removed;
+	};
+	vector<Selection> selections;
+	// the selections of every label in order, and the ones on every atomic segment
+	vector<vector<int> > ofLabel(this->X.size());
+	vector<vector<int> > onSegment(numberOfSegments);
+	for(unsigned int label=0; label < this->X.size(); ++label){
+		for(int range=0; range < this->segments[label].getNumberOfRanges(); ++range){
+			int first = this->segments[label].getFirst(range);
+			int last = this->segments[label].getLast(range);
+			int offset = this->segments[label].at(first);
+			for(int event=first; event <= last; ++event){
+				if(values[this->X[label][offset+event-first].index] < 0.5){
+					continue;
+				}
+				// ranges may be adjacent, and a selection may go on from one to the next
+				if(!ofLabel[label].empty() && selections[ofLabel[label].back()].last == event-1){
+					selections[ofLabel[label].back()].last = event;
+				}else{
+					ofLabel[label].push_back(selections.size());
+					selections.push_back({(int)label, event, event, false});
+				}
+				onSegment[event].push_back(ofLabel[label].back());
+			}
+		}
+	}
+
+	auto remove = [this, &values, &selections](int selection){
+		Selection &removed = selections[selection];
+		removed.removed = true;
+		for(int event=removed.first; event <= removed.last; ++event){
+			int index = this->segments[removed.label].at(event);
+			values[this->B[removed.label][index].index] = 0.0;
+			values[this->X[removed.label][index].index] = 0.0;
+			values[this->E[removed.label][index].index] = 0.0;
+		}
+	};
+	auto pinned = [this, &selections](int selection){
+		const Selection &candidate = selections[selection];
+		return candidate.first == 0 && candidate.label < (int)this->instance->boundaries.size()
+				&& this->instance->boundaries[candidate.label].state == Boundary::OPEN;
+	};
+	auto length = [this, &selections](int selection){
+		return this->events->at(selections[selection].last+1) - this->events->at(selections[selection].first);
+	};
+
+	for(int event=0; event < numberOfSegments; ++event){
+		vector<int> candidates;
+		int selected = 0;
+		for(int selection : onSegment[event]){
+			if(!selections[selection].removed){
+				selected++;
+				if(!pinned(selection)){
+					candidates.push_back(selection);
+				}
+			}
+		}
+		std::sort(candidates.begin(), candidates.end(), [&length](int a, int b){
+			return length(a) < length(b);
+		});
+		for(unsigned int i=0; selected > k && i < candidates.size(); ++i, --selected){
+			remove(candidates[i]);
+		}
+	}
+
+	// the selection of the label that begins or ends at the witnessed atomic segment
+	auto lostWitness = [this, &values, &selections, &ofLabel](const Witness &witness, const vector<MIP::Var *> &vars) {
+		int index = this->segments[witness.label].at(witness.event);
+		if(values[vars[witness.label][index].index] < 0.5){
+			return -1;
+		}
+		for(const MIP::Var &var : witness.vars){
+			if(values[var.index] > 0.5){
+				return -1;
+			}
+		}
+		for(int selection : ofLabel[witness.label]){
+			if(!selections[selection].removed && selections[selection].first <= witness.event && witness.event <= selections[selection].last){
+				return selection;
+			}
+		}
+		return -1;
+	};
+	bool endsWitnessed = this->modelType == AM2 || this->modelType == AM3;
+	bool beginsWitnessed = this->modelType == AM3;
+	bool changed = true;
+	while(changed){
+		changed = false;
+		for(const Witness &witness : this->endWitnesses){
+			int selection = endsWitnessed ? lostWitness(witness, this->E) : -1;
+			if(selection >= 0 && !pinned(selection)){
+				remove(selection);
+				changed = true;
+			}
+		}
+		for(const Witness &witness : this->beginWitnesses){
+			int selection = beginsWitnessed ? lostWitness(witness, this->B) : -1;
+			if(selection >= 0 && !pinned(selection)){
+				remove(selection);
+				changed = true;
+			}
+		}
+	}
+}
+
+bool ILP::solve(vector<Intervals> &result, double &resultBound, double &gap, Clock &clock, ILPAdapter *adapter, int component) {
+	MIP::Solver &solver = *this->solver;
+	Instance *instance = this->instance;
+	vector<double> *events = this->events;
+
+	// a deadline of the adapter may shorten the time limit
+	double timeLimit = TIME_LIMIT;
+	if (adapter != nullptr) {
+		timeLimit = adapter->solveTimeLeft();
+	}
+	if (this->timeLimit > 0) {
+		timeLimit = std::min(timeLimit, this->timeLimit);
+	}
+	solver.setTimeLimit(timeLimit);
+	// the threads may have changed since the model was built
+	solver.setThreads(this->threads > 0 ? this->threads : num_threads);
+
+	MIP::Solver::Progress progress;
+	MIP::Solver::Interrupt interrupt;
+	if (adapter != nullptr && component >= 0) {
+		progress = [adapter, component](double best, double bound) {
+			// the empty selection is always feasible, so the incumbent is never worse
+			adapter->reportComponent(component, std::max(best, 0.0), bound);
+		};
+	}
+	if (adapter != nullptr) {
+		// the deadline is part of the time limit
+		interrupt = [adapter]() {
+			return adapter->stopComponents();
+		};
+	}
+
+	std::cout << "Starting to optimize...\n";
+	MIP::Solver::Status status = solver.optimize(progress, interrupt);
+	std::cout << "Optimization done...\n";
+
+	clock.stop();
+
+//	for(unsigned int i=0; i < X.size(); i++){
+//		cout << "Label " << i << ": ";
+//		for(unsigned int j=0; j < events->size()-1; j++){
+//			cout << X[i][j].get(GRB_DoubleAttr_X) << " ";
+//		}
+//		cout << endl;
+//	}
+
+	// Also keep the incumbent if the optimization was stopped early
+	if (solver.hasSolution()){
+	vector<double> values = solver.getValues();
+	//result->reserve(instance->intervalsOfLabels->size());
+	for(unsigned int i =0; i < instance->intervalsOfLabels->size(); ++i){
+		double begin =0.0;
+		int state =0;
+		Intervals intervals = Intervals(instance->intervalsOfLabels->at(i)->getId());
+		// X is 0 on the atomic segments without variables
+		for(int range=0; range < segments[i].getNumberOfRanges(); ++range){
+			int first = segments[i].getFirst(range);
+			int last = segments[i].getLast(range);
+			int offset = segments[i].at(first);
+			for(int event=first; event <= last; ++event){
+				double value = values[X[i][offset+event-first].index];
+				if(state != 1 && value > 0.5){
+					begin = events->at(event);
+					state = 1;
+				}
+				if(state != 0 && value < 0.5){
+					intervals.add(begin,events->at(event));
+					state =0;
+				}
+			}
+			if(state == 1){
+				intervals.add(begin,events->at(last+1));
+				state =0;
+			}
+		}
+		result.push_back(intervals);
+	}
+	}
+	resultBound = solver.getBound();
+	gap = solver.getGap();
+
+	return status == MIP::Solver::FINISHED;
+
+}
+
+/**
+ * The index of the given value in the sorted events. The value must be one of them, as
+ * every endpoint of an interval is an event.
+ */
+int eventIndex(const vector<double> &events, double value){
+	vector<double>::const_iterator it = lower_bound(events.begin(), events.end(), value);
+	assert(it != events.end() && *it == value);
+	return it - events.begin();
+}
 
-	//env.set(GRB_StringParam_LogFile, "/tmp/gurobi.log");
+/**
+ * The labels whose presence intervals contain the atomic segment, for the atomic segments
+ * with more than k of them at which a selection may begin. Only there the k-restriction can
+ * be violated, so ck_ is only added for these segments, over these labels; all other X are 0
+ * anyway. A selection may only begin with its presence interval, or (in AM3) where one of
+ * its conflicts ends. Elsewhere X of every label is at most the one of the segment before
+ * (condition (D)), so ck_ there follows from the one before, and of consecutive segments
+ * with the same labels only the first one gets ck_.
+ */
+vector<vector<int> > crowdedSegments(Instance *instance, const vector<double> &events, int k){
+	int numberOfSegments = events.size()-1;
+	vector<vector<int> > crowded(numberOfSegments);
+
+	// the number of presence intervals that contain each atomic segment
+	vector<int> coverage(numberOfSegments+1, 0);
+	for(Intervals *intervals : *instance->intervalsOfLabels){
+		for(int presence=0; presence < (int)intervals->getNumberOfIntervals(); ++presence){
+			coverage[eventIndex(events, intervals->at(presence*2))]++;
+			coverage[eventIndex(events, intervals->at(presence*2+1))]--;
+		}
+	}
+	for(int event=1; event < numberOfSegments; ++event){
+		coverage[event] += coverage[event-1];
+	}
 
-	GRBModel model = GRBModel(env);
+	// the segments at which a selection may begin, for any model, as the model may change
+	vector<bool> begins(numberOfSegments+1, false);
+	for(int label=0; label < (int)instance->intervalsOfLabels->size(); ++label){
+		Intervals *intervals = instance->intervalsOfLabels->at(label);
+		for(int presence=0; presence < (int)intervals->getNumberOfIntervals(); ++presence){
+			begins[eventIndex(events, intervals->at(presence*2))] = true;
+		}
+	}
+	// the labels whose conflicts end at each event
+	vector<vector<int> > conflictEnds(numberOfSegments+1);
+	for(int conflict=0; conflict < (int)instance->intervalsOfConflicts->size(); ++conflict){
+		Intervals *intervals = instance->intervalsOfConflicts->at(conflict);
+		for(int i=0; i < (int)intervals->getNumberOfIntervals(); ++i){
+			int event = eventIndex(events, intervals->at(i*2+1));
+			conflictEnds[event].push_back(instance->conflicts->at(conflict)->getLabel1());
+			conflictEnds[event].push_back(instance->conflicts->at(conflict)->getLabel2());
+		}
+	}
 
-	// Variables indicating where a visibility begins
-	vector<GRBVar *> B = vector<GRBVar*>();
-	// Variables indicating where a visibility is switched on
-	vector<GRBVar *> X = vector<GRBVar*>();
-	// Varibales indicating where a visibility ends
-	vector<GRBVar *> E = vector<GRBVar*>();
-	// Variables indicating whether a presence is selected at all
-	vector<GRBVar *> V = vector<GRBVar*>();
+	for(int label=0; label < (int)instance->intervalsOfLabels->size(); ++label){
+		Intervals *intervals = instance->intervalsOfLabels->at(label);
+		for(int presence=0; presence < (int)intervals->getNumberOfIntervals(); ++presence){
+			int first = eventIndex(events, intervals->at(presence*2));
+			int last = eventIndex(events, intervals->at(presence*2+1)) - 1;
+			for(int event=first+1; event <= last; ++event){
+				if(!begins[event] && find(conflictEnds[event].begin(), conflictEnds[event].end(), label) != conflictEnds[event].end()){
+					begins[event] = true;
+				}
+			}
+		}
+	}
+
+	for(int label=0; label < (int)instance->intervalsOfLabels->size(); ++label){
+		Intervals *intervals = instance->intervalsOfLabels->at(label);
+		for(int presence=0; presence < (int)intervals->getNumberOfIntervals(); ++presence){
+			int first = eventIndex(events, intervals->at(presence*2));
+			int last = eventIndex(events, intervals->at(presence*2+1)) - 1;
+			for(int event=first; event <= last; ++event){
+				if(coverage[event] > k && begins[event]){
+					crowded[event].push_back(label);
+				}
+			}
+		}
+	}
+	return crowded;
+}
+
+/**
+ * The B, X and E variables exist for every label and atomic segment, the ones outside the
+ * presence intervals of a label are fixed to 0 by the constraints c1_-c3_.
+ */
+void ILP::createDenseModel(MIP::Model &model, Instance *instance, ModelType modelType, vector<double> *events, int k,
+		vector<MIP::Var *> &B, vector<MIP::Var *> &X, vector<MIP::Var *> &E, vector<MIP::Var *> &V, vector<SegmentIndex> &segments) {
+
+	// B: Variables indicating where a visibility begins
+	// X: Variables indicating where a visibility is switched on
+	// E: Varibales indicating where a visibility ends
+	// V: Variables indicating whether a presence is selected at all
 
-	vector<GRBLinExpr *> constraints = vector<GRBLinExpr*>();
-	vector<char *> sense = vector<char*>();
-	vector<double *> rhs = vector<double*>();
-	vector<const string *> names = vector<const string*>();
 
 
 
@@ -111,17 +499,22 @@ bool ILP::execute(Instance* instance, ModelType modelType, vector<Intervals> & r
 
 
 
-	createVariables(model,instance->intervalsOfLabels->size(),events->size()-1, B, X, E, V, constraints,sense,rhs,names, instance);
-
+	createVariables(model,instance->intervalsOfLabels->size(),events->size()-1, B, X, E, V, instance);
 
 
-	for(unsigned int event=0; k>=0&&event < events->size()-1; ++event){
-		GRBLinExpr expr;
-		for(vector<GRBVar *>::iterator label = X.begin(); label != X.end(); ++label ){
-			expr += (*label)[event];
 
+	if(k >= 0){
+		vector<vector<int> > crowded = crowdedSegments(instance, *events, k);
+		for(unsigned int event=0; event < crowded.size(); ++event){
+			if(crowded[event].empty()){
+				continue;
+			}
+			MIP::LinExpr expr;
+			for(int label : crowded[event]){
+				expr += X[label][event];
+			}
+			this->kConstrs.push_back(model.addConstr(expr,MIP::LESS_EQUAL,k,"ck_"+convert((int)event)));
 		}
-		model.addConstr(expr,GRB_LESS_EQUAL,k,"ck_"+convert((int)event));
 	}
 
 	cerr << "Passed Checkpoint 1.1\n";
@@ -138,7 +531,7 @@ bool ILP::execute(Instance* instance, ModelType modelType, vector<Intervals> & r
 		double endConflict  = intervals->at(conflictEvent*2+1);
 
 
-		GRBLinExpr sumB, sumE;
+		MIP::LinExpr sumB, sumE;
 		int state =0;
 
 
@@ -166,8 +559,11 @@ bool ILP::execute(Instance* instance, ModelType modelType, vector<Intervals> & r
 				int label2 = conflict->getLabel2();
 
 
-				model.addConstr((X.at(label1)[event]+X.at(label2)[event])<=1,
+				MIP::Constr constr = model.addConstr((X.at(label1)[event]+X.at(label2)[event])<=1,
 								 "c8_"+convert(conflictIndex)+"_"+convert(label1)+"_"+convert(label2));
+				if(this->options.lazyConflicts != MIP::EAGER){
+					model.setLazy(constr, this->options.lazyConflicts);
+				}
 
 
 			}
@@ -199,15 +595,20 @@ bool ILP::execute(Instance* instance, ModelType modelType, vector<Intervals> & r
 
 		Intervals * intervals = (*it);
 		int presence = 0;
-		double beginPresence = intervals->at(presence*2);
-		double endPresence = intervals->at(presence*2+1);
+		// a label without presence intervals (see coarsenInstance()) is left of them everywhere
+		double beginPresence = 2.0;
+		double endPresence = 2.0;
+		if(presence < (int)intervals->getNumberOfIntervals()){
+			beginPresence = intervals->at(presence*2);
+			endPresence = intervals->at(presence*2+1);
+		}
 
 		//cout << "#########LABEL " << adapter->poiForId(label)->getId() << endl;
 		//cout << "#########Interal ID " << label << endl;
 
 		//cout << "Presence is now " << beginPresence << " / " << endPresence << "\n";
 
-		GRBLinExpr sumB, sumE, minLengthConstr;
+		MIP::LinExpr sumB, sumE, minLengthConstr;
 		int state =0;
 
 		for(unsigned int event=0; event < events->size()-1; ++event) {
@@ -216,7 +617,6 @@ bool ILP::execute(Instance* instance, ModelType modelType, vector<Intervals> & r
 			double endSegment   = events->at(event+1);
 
 			string name = convert(label)+"_"+convert((int)event);
-			int index = event*NC;
 
 			// condition (D)
 
@@ -236,9 +636,6 @@ bool ILP::execute(Instance* instance, ModelType modelType, vector<Intervals> & r
 
 
 
-			rhs[label][index+3] = 0.0;
-
-			sense[label][index+3] = GRB_EQUAL;
 		//	const string temp = name + "_D";
 			//names[label][index+3] = name;
 			//names[label][index+3] = "D";
@@ -251,11 +648,12 @@ bool ILP::execute(Instance* instance, ModelType modelType, vector<Intervals> & r
 					state =1;
 				}
 				if(beginSegment == beginPresence){
-					sumB = GRBLinExpr();
-					sumE = GRBLinExpr();
+					sumB = MIP::LinExpr();
+					sumE = MIP::LinExpr();
 					sumE += V[label][presence];
-					minLengthConstr = GRBLinExpr();
+					minLengthConstr = MIP::LinExpr();
 					minLengthConstr += V[label][presence] * (MINIMUM_SELECTION_LENGTH + 1.0);
+					minLengthConstr += instance->getLengthBefore(label, presence);
 					//minLengthConstr += (MINIMUM_SELECTION_LENGTH + 1.0);
 				}
 
@@ -270,38 +668,51 @@ bool ILP::execute(Instance* instance, ModelType modelType, vector<Intervals> & r
 					model.addConstr(sumE <= 1, "c7_"+name);
 				}
 				if( endSegment != endPresence){
-					GRBLinExpr witnessEnd   = GRBLinExpr();
+					MIP::LinExpr witnessEnd   = MIP::LinExpr();
 					witnessEnd   += 0;
 
-
-					if(modelType == AM2 || modelType == AM3){
-						for(unsigned int i=0; i< beginOfConflicts[event+1].size(); ++i){
-							Conflict *conflict = instance->conflicts->at(beginOfConflicts[event+1][i]);
-							if(conflict->involves(label)){
+					Witness witness;
+					witness.label = label;
+					witness.event = event;
+					for(unsigned int i=0; i< beginOfConflicts[event+1].size(); ++i){
+						Conflict *conflict = instance->conflicts->at(beginOfConflicts[event+1][i]);
+						if(conflict->involves(label)){
+							witness.vars.push_back(X[conflict->getOpponent(label)][event+1]);
+							if(modelType == AM2 || modelType == AM3){
 								witnessEnd += X[conflict->getOpponent(label)][event+1];
 							}
 						}
 					}
-					model.addConstr(E[label][event]<=witnessEnd  , "c_10"+name);
+					witness.constr = model.addConstr(E[label][event]<=witnessEnd  , "c_10"+name);
+					if(!witness.vars.empty()){
+						this->endWitnesses.push_back(witness);
+					}
 
 				}
 
 
 				if(beginSegment != beginPresence){
-					GRBLinExpr witnessBegin = GRBLinExpr();
+					MIP::LinExpr witnessBegin = MIP::LinExpr();
 
 					witnessBegin += 0;
 
-                                        if(modelType == AM3){
-					 for(unsigned int i=0; i< endOfConflicts[event-1].size(); ++i){
+					Witness witness;
+					witness.label = label;
+					witness.event = event;
+					for(unsigned int i=0; i< endOfConflicts[event-1].size(); ++i){
 						Conflict *conflict = instance->conflicts->at(endOfConflicts[event-1][i]);
 						if(conflict->involves(label)){
-							witnessBegin += X[conflict->getOpponent(label)][event-1];
-					 	}
-					 }
+							witness.vars.push_back(X[conflict->getOpponent(label)][event-1]);
+							if(modelType == AM3){
+								witnessBegin += X[conflict->getOpponent(label)][event-1];
+							}
+						}
 					}
 
-					model.addConstr(B[label][event]<=witnessBegin  , "c_9"+name);
+					witness.constr = model.addConstr(B[label][event]<=witnessBegin  , "c_9"+name);
+					if(!witness.vars.empty()){
+						this->beginWitnesses.push_back(witness);
+					}
 				}
 
 
@@ -329,7 +740,7 @@ bool ILP::execute(Instance* instance, ModelType modelType, vector<Intervals> & r
 				//std::cout << "Begin: " << beginPresence << " -- Ende: " << endPresence << "\n";
 				//std::cout << minLengthConstr << " >= " << (MINIMUM_SELECTION_LENGTH / instance->originalMax) << "\n";
 				model.addConstr(minLengthConstr >= (MINIMUM_SELECTION_LENGTH / instance->originalMax));
-				minLengthConstr = GRBLinExpr();
+				minLengthConstr = MIP::LinExpr();
 
 				presence+=1;
 
@@ -357,9 +768,9 @@ bool ILP::execute(Instance* instance, ModelType modelType, vector<Intervals> & r
 	 * objective function
 	 */
 	label=0;
-	GRBLinExpr linExpr = GRBLinExpr();
+	MIP::LinExpr linExpr = MIP::LinExpr();
 	for(unsigned int i=0; i < instance->intervalsOfLabels->size(); ++i){
-		//GRBLinExpr minLengthConstr;
+		//MIP::LinExpr minLengthConstr;
 		for(unsigned int event=0; event < events->size()-1; ++event){
 			double beginSegment = events->at(event);
 			double endSegment   = events->at(event+1);
@@ -370,60 +781,410 @@ bool ILP::execute(Instance* instance, ModelType modelType, vector<Intervals> & r
 		//minLengthConstr += V[i][0] * MINIMUM_SELECTION_LENGTH;
 		//model.addConstr(minLengthConstr >= (MINIMUM_SELECTION_LENGTH / instance->originalMax), "minlength_" + i);
 	}
-	model.setObjective(linExpr,GRB_MAXIMIZE);
+	model.setObjective(linExpr,MIP::MAXIMIZE);
 
+	segments.assign(instance->intervalsOfLabels->size(), SegmentIndex());
+	for(unsigned int i=0; i < segments.size(); ++i){
+		segments[i].addRange(0, events->size()-2);
+	}
+}
 
-	if (dbg_filename != nullptr) {
-		model.update();
-		model.write(dbg_filename);
+namespace {
+
+/**
+ * Linear constraints in compressed sparse rows, which are added to the model in one call.
+ * Names are only built if asked for, as that takes longer than everything else.
+ */
+class RowBuffer {
+public:
+	RowBuffer(bool named) : named(named) {
+		this->begins.push_back(0);
 	}
 
-	std::cout << "Starting to optimize...\n";
-	model.optimize();
-	std::cout << "Optimization done...\n";
+	/* Adds a term to the current row */
+	void add(const MIP::Var &var, double coefficient) {
+		this->columns.push_back(var.index);
+		this->coefficients.push_back(coefficient);
+	}
 
-	clock.stop();
+	/* Finishes the current row and returns its index. The name is the prefix followed by the
+	 * non-negative numbers, separated by "_"; there is none without a prefix. */
+	int close(char sense, double rhs, const char *prefix = nullptr, int first = -1, int second = -1, int third = -1) {
+		this->begins.push_back(this->columns.size());
+		this->senses.push_back(sense);
+		this->rhs.push_back(rhs);
+		if (this->named) {
+			string name;
+			if (prefix != nullptr) {
+				name = prefix;
+				for (int number : {first, second, third}) {
+					if (number >= 0) {
+						name += (name.size() > strlen(prefix) ? "_" : "") + to_string(number);
+					}
+				}
+			}
+			this->names.push_back(name);
+		}
+		return this->senses.size() - 1;
+	}
 
-//	for(unsigned int i=0; i < X.size(); i++){
-//		cout << "Label " << i << ": ";
-//		for(unsigned int j=0; j < events->size()-1; j++){
-//			cout << X[i][j].get(GRB_DoubleAttr_X) << " ";
-//		}
-//		cout << endl;
-//	}
+	/* Adds all rows to the model and returns the constraint of the first one, the others
+	 * follow it */
+	MIP::Constr addTo(MIP::Model &model) const {
+		return model.appendRows(this->begins, this->columns, this->coefficients, this->senses, this->rhs, this->named ? &this->names : nullptr);
+	}
 
-	if (model.get(GRB_IntAttr_Status) == GRB_OPTIMAL){
-	//result->reserve(instance->intervalsOfLabels->size());
-	for(unsigned int i =0; i < instance->intervalsOfLabels->size(); ++i){
-		double begin =0.0;
-		int state =0;
-		Intervals intervals = Intervals(instance->intervalsOfLabels->at(i)->getId());
-		for(unsigned int event=0; event < events->size()-1; ++event){
-			if(state != 1 && X[i][event].get(GRB_DoubleAttr_X)==1){
-				begin = events->at(event);
-				state = 1;
+private:
+	bool named;
+	vector<int> begins;
+	vector<int> columns;
+	vector<double> coefficients;
+	vector<char> senses;
+	vector<double> rhs;
+	vector<string> names;
+};
+
+}
+
+/**
+ * Same model as createDenseModel(), but without the variables that the dense one fixes to 0
+ * (those of the atomic segments outside the presence intervals of a label). Wherever the dense
+ * model uses such a variable, it is left out, i.e., the constraints c1_-c3_ vanish, and the
+ * other ones only refer to existing variables. The optimum is the same.
+ */
+void ILP::createSparseModel(MIP::Model &model, Instance *instance, ModelType modelType, const vector<double> &events, int k,
+		vector<MIP::Var *> &B, vector<MIP::Var *> &X, vector<MIP::Var *> &E, vector<MIP::Var *> &V, vector<SegmentIndex> &segments) {
+
+	int numberOfLabels = instance->intervalsOfLabels->size();
+	int numberOfSegments = events.size()-1;
+
+	B.assign(numberOfLabels, nullptr);
+	X.assign(numberOfLabels, nullptr);
+	E.assign(numberOfLabels, nullptr);
+	V.assign(numberOfLabels, nullptr);
+	segments.assign(numberOfLabels, SegmentIndex());
+
+	// the atomic segments within the presence intervals, i.e., [first, last] of every presence
+	vector<vector<pair<int, int> > > presences(numberOfLabels);
+	for(int label=0; label < numberOfLabels; ++label){
+		Intervals *intervals = instance->intervalsOfLabels->at(label);
+		for(int presence=0; presence < (int)intervals->getNumberOfIntervals(); ++presence){
+			int first = eventIndex(events, intervals->at(presence*2));
+			int last = eventIndex(events, intervals->at(presence*2+1)) - 1;
+			presences[label].push_back(make_pair(first, last));
+			if(last >= first){
+				segments[label].addRange(first, last);
 			}
-			if(state != 0 && X[i][event].get(GRB_DoubleAttr_X)==0){
-				intervals.add(begin,events->at(event));
-				state =0;
+		}
+
+		B[label] = model.addVars(segments[label].size());
+		X[label] = model.addVars(segments[label].size());
+		E[label] = model.addVars(segments[label].size());
+		V[label] = model.addVars(intervals->getNumberOfIntervals());
+	}
+	RowBuffer rows(model.isNamed());
+
+	// adds the variable of the label for the atomic segment to the row, if it exists
+	auto addTerm = [&segments, &rows](const vector<MIP::Var *> &vars, int label, int event, double coefficient){
+		int index = segments[label].at(event);
+		if(index >= 0){
+			rows.add(vars[label][index], coefficient);
+		}
+	};
+	// the X variable of an opponent as witness, in the row only if the model uses it
+	auto addWitness = [&segments, &X, &rows](Witness &witness, bool used, int opponent, int event){
+		int index = segments[opponent].at(event);
+		if(index >= 0){
+			witness.vars.push_back(X[opponent][index]);
+			if(used){
+				rows.add(X[opponent][index], -1.0);
 			}
 		}
-		if(state == 1){
-			intervals.add(begin,1.0);
+	};
+
+	// the rows of ck_, which changeK() changes once the rows are added
+	vector<int> kRows;
+	if(k >= 0){
+		vector<vector<int> > crowded = crowdedSegments(instance, events, k);
+		for(int event=0; event < numberOfSegments; ++event){
+			if(!crowded[event].empty()){
+				for(int label : crowded[event]){
+					addTerm(X, label, event, 1.0);
+				}
+				kRows.push_back(rows.close(MIP::LESS_EQUAL, k, "ck_", event));
+			}
+		}
+	}
+
+	/**
+	 * conditions only based on conflict intervals
+	 */
+	vector<vector<int> > beginOfConflicts = vector<vector<int> >(numberOfSegments);
+	vector<vector<int> > endOfConflicts = vector<vector<int> >(numberOfSegments);
+	// the rows of c8_, they become lazy once the rows are added
+	vector<int> conflictRows;
+	for(int conflictIndex=0; conflictIndex < (int)instance->intervalsOfConflicts->size(); ++conflictIndex){
+		Intervals *intervals = instance->intervalsOfConflicts->at(conflictIndex);
+		Conflict *conflict = instance->conflicts->at(conflictIndex);
+		int label1 = conflict->getLabel1();
+		int label2 = conflict->getLabel2();
+
+		for(int conflictEvent=0; conflictEvent < (int)intervals->getNumberOfIntervals(); ++conflictEvent){
+			int first = eventIndex(events, intervals->at(conflictEvent*2));
+			int last = eventIndex(events, intervals->at(conflictEvent*2+1)) - 1;
+			// like the dense model, an empty conflict interval only ends at the event before
+			if(last >= first){
+				beginOfConflicts[first].push_back(conflictIndex);
+			}
+			if(last >= 0){
+				endOfConflicts[last].push_back(conflictIndex);
+			}
+
+			for(int event=first; event <= last; ++event){
+				int index1 = segments[label1].at(event);
+				int index2 = segments[label2].at(event);
+				if(index1 >= 0 && index2 >= 0){
+					rows.add(X[label1][index1], 1.0);
+					rows.add(X[label2][index2], 1.0);
+					conflictRows.push_back(rows.close(MIP::LESS_EQUAL, 1.0, "c8_", conflictIndex, label1, label2));
+				}
+			}
+		}
+	}
+
+	/**
+	 * conditions only based on presence intervals.
+	 */
+	assert(instance->originalMax >= 1.0);
+	// the witness constraints get their rows now, and their constraints once the rows are added
+	vector<int> endRows, beginRows;
+	for(int label=0; label < numberOfLabels; ++label){
+		for(int presence=0; presence < (int)presences[label].size(); ++presence){
+			int first = presences[label][presence].first;
+			int last = presences[label][presence].second;
+			double length = instance->getLengthBefore(label, presence);
+
+			for(int event=first; event <= last; ++event){
+				int index = segments[label].at(event);
+
+				// condition (D), without the variables of the previous segment if there are none
+				rows.add(B[label][index], 1.0);
+				rows.add(X[label][index], -1.0);
+				if(event > 0){
+					addTerm(X, label, event-1, 1.0);
+					addTerm(E, label, event-1, -1.0);
+					rows.close(MIP::EQUAL, 0.0, "c5_", label, event);
+				}else{
+					rows.close(MIP::EQUAL, 0.0, "c4_", label, event);
+				}
+
+				length += (events[event+1] - events[event]);
+
+				if(event != last){
+					Witness witness;
+					witness.label = label;
+					witness.event = event;
+					rows.add(E[label][index], 1.0);
+					for(unsigned int i=0; i< beginOfConflicts[event+1].size(); ++i){
+						Conflict *conflict = instance->conflicts->at(beginOfConflicts[event+1][i]);
+						if(conflict->involves(label)){
+							addWitness(witness, modelType == AM2 || modelType == AM3, conflict->getOpponent(label), event+1);
+						}
+					}
+					int row = rows.close(MIP::LESS_EQUAL, 0.0, "c_10", label, event);
+					if(!witness.vars.empty()){
+						this->endWitnesses.push_back(witness);
+						endRows.push_back(row);
+					}
+				}
+
+				if(event != first){
+					Witness witness;
+					witness.label = label;
+					witness.event = event;
+					rows.add(B[label][index], 1.0);
+					for(unsigned int i=0; i< endOfConflicts[event-1].size(); ++i){
+						Conflict *conflict = instance->conflicts->at(endOfConflicts[event-1][i]);
+						if(conflict->involves(label)){
+							addWitness(witness, modelType == AM3, conflict->getOpponent(label), event-1);
+						}
+					}
+					int row = rows.close(MIP::LESS_EQUAL, 0.0, "c_9", label, event);
+					if(!witness.vars.empty()){
+						this->beginWitnesses.push_back(witness);
+						beginRows.push_back(row);
+					}
+				}
+			}
+
+			if(last >= first){
+				// the variables of a presence are consecutive
+				int offset = segments[label].at(first);
+				for(int index=offset; index <= offset+last-first; ++index){
+					rows.add(B[label][index], 1.0);
+				}
+				rows.close(MIP::LESS_EQUAL, 1.0, "c6_", label, last);
+				rows.add(V[label][presence], 1.0);
+				for(int index=offset; index <= offset+last-first; ++index){
+					rows.add(E[label][index], 1.0);
+				}
+				rows.close(MIP::LESS_EQUAL, 1.0, "c7_", label, last);
+			}
+
+			// condition (D) for the first atomic segment after the presence, if it has no variables
+			if(last >= first && last+1 < numberOfSegments && segments[label].at(last+1) < 0){
+				int index = segments[label].at(last);
+				rows.add(X[label][index], 1.0);
+				rows.add(E[label][index], -1.0);
+				rows.close(MIP::EQUAL, 0.0, "c5_", label, last+1);
+			}
+
+			rows.add(V[label][presence], MINIMUM_SELECTION_LENGTH + 1.0);
+			rows.close(MIP::GREATER_EQUAL, (MINIMUM_SELECTION_LENGTH / instance->originalMax) - length, "", -1);
+		}
+	}
+
+	int firstRow = rows.addTo(model).index;
+	for(unsigned int i=0; i < endRows.size(); ++i){
+		this->endWitnesses[i].constr = MIP::Constr(firstRow + endRows[i]);
+	}
+	for(unsigned int i=0; i < beginRows.size(); ++i){
+		this->beginWitnesses[i].constr = MIP::Constr(firstRow + beginRows[i]);
+	}
+	for(int row : kRows){
+		this->kConstrs.push_back(MIP::Constr(firstRow + row));
+	}
+	if(this->options.lazyConflicts != MIP::EAGER){
+		for(int row : conflictRows){
+			model.setLazy(MIP::Constr(firstRow + row), this->options.lazyConflicts);
+		}
+	}
+
+	/**
+	 * objective function
+	 */
+	vector<MIP::Var> objectiveVars;
+	vector<double> objectiveCoefficients;
+	for(int label=0; label < numberOfLabels; ++label){
+		for(int range=0; range < segments[label].getNumberOfRanges(); ++range){
+			int first = segments[label].getFirst(range);
+			int offset = segments[label].at(first);
+			for(int event=first; event <= segments[label].getLast(range); ++event){
+				objectiveVars.push_back(X[label][offset+event-first]);
+				objectiveCoefficients.push_back(events[event+1]-events[event]);
+			}
 		}
-		result.push_back(intervals);
 	}
+	MIP::LinExpr linExpr = MIP::LinExpr();
+	linExpr.addTerms(objectiveCoefficients.data(), objectiveVars.data(), objectiveVars.size());
+	model.setObjective(linExpr,MIP::MAXIMIZE);
+}
+
+void ILP::setStart(const vector<Intervals> &start) {
+	this->start = start;
+}
+
+void ILP::setThreads(int threads) {
+	this->threads = threads;
+}
+
+void ILP::setTimeLimit(double seconds) {
+	this->timeLimit = seconds;
+}
+
+/**
+ * The first presence interval of a label that continues from before the window begins with
+ * the first atomic segment. An open selection continues there, and a waiting label must not
+ * begin there, as that is no begin of a presence interval in the whole instance.
+ */
+void ILP::applyBoundaries(MIP::Model &model, Instance *instance, vector<MIP::Var *> &B, vector<MIP::Var *> &X,
+		vector<SegmentIndex> &segments) {
+	for(unsigned int label=0; label < instance->boundaries.size(); ++label){
+		const Boundary &boundary = instance->boundaries[label];
+		int index = segments[label].at(0);
+		if(boundary.state == Boundary::FREE || index < 0){
+			continue;
+		}
+		if(boundary.state == Boundary::OPEN){
+			model.addConstr(X[label][index] == 1, "cw_" + convert((int)label));
+		}else{
+			model.addConstr(B[label][index] == 0, "cw_" + convert((int)label));
+		}
 	}
-	resultBound = model.get(GRB_DoubleAttr_ObjBound);
-	gap = model.get(GRB_DoubleAttr_MIPGap);
+}
 
-  if (model.get(GRB_IntAttr_Status) == GRB_TIME_LIMIT){
-		return false;
+/**
+ * An atomic segment is selected if its middle lies within a selected interval. B and E are set
+ * where the selection of a label begins and ends, and V wherever a presence is too short to be
+ * selected on its own.
+ */
+void ILP::applyStart(MIP::Model &model, Instance *instance, const vector<double> &events, vector<MIP::Var *> &B, vector<MIP::Var *> &X,
+		vector<MIP::Var *> &E, vector<MIP::Var *> &V, vector<SegmentIndex> &segments) {
+	int numberOfSegments = events.size()-1;
+
+	for(unsigned int label=0; label < segments.size() && label < this->start.size(); ++label){
+		const Intervals &selected = this->start[label];
+
+		for(int range=0; range < segments[label].getNumberOfRanges(); ++range){
+			int first = segments[label].getFirst(range);
+			int last = segments[label].getLast(range);
+			int offset = segments[label].at(first);
+
+			vector<bool> on(last-first+1, false);
+			for(int event=first; event <= last; ++event){
+				double middle = (events[event] + events[event+1]) / 2;
+				for(unsigned int i=0; i+1 < selected.size(); i+=2){
+					if(selected[i] <= middle && middle <= selected[i+1]){
+						on[event-first] = true;
+						break;
+					}
+				}
+			}
+
+			// X is 0 before and after the range, but nothing has to end at the very end
+			for(int event=first; event <= last; ++event){
+				int i = event-first;
+				bool previous = i > 0 && on[i-1];
+				bool next = (event < last) ? on[i+1] : (event+1 == numberOfSegments);
+				model.setStart(B[label][offset+i], (on[i] && !previous) ? 1.0 : 0.0);
+				model.setStart(X[label][offset+i], on[i] ? 1.0 : 0.0);
+				model.setStart(E[label][offset+i], (on[i] && !next) ? 1.0 : 0.0);
+			}
+		}
+
+		Intervals *presences = instance->intervalsOfLabels->at(label);
+		for(int presence=0; presence < presences->getNumberOfIntervals(); ++presence){
+			double length = presences->at(presence*2+1) - presences->at(presence*2) + instance->getLengthBefore(label, presence);
+			bool tooShort = length < (MINIMUM_SELECTION_LENGTH / instance->originalMax);
+			model.setStart(V[label][presence], tooShort ? 1.0 : 0.0);
+		}
 	}
-	return true;
+}
 
+void SegmentIndex::addRange(int first, int last) {
+	assert(first <= last);
+	assert(this->lasts.empty() || this->lasts.back() < first);
+	if(!this->lasts.empty() && this->lasts.back() + 1 == first){
+		this->lasts.back() = last;
+	}else{
+		this->firsts.push_back(first);
+		this->lasts.push_back(last);
+		this->offsets.push_back(this->count);
+	}
+	this->count += last - first + 1;
 }
 
+int SegmentIndex::at(int segment) const {
+	vector<int>::const_iterator it = upper_bound(this->firsts.begin(), this->firsts.end(), segment);
+	if(it == this->firsts.begin()){
+		return -1;
+	}
+	int range = (it - this->firsts.begin()) - 1;
+	if(segment > this->lasts[range]){
+		return -1;
+	}
+	return this->offsets[range] + segment - this->firsts[range];
+}
 
 
 void add(vector<Intervals*> * container,set<double>& events ){
@@ -451,36 +1212,23 @@ vector<double>* ILP::createEvents(Instance* instance) {
 	return events;
 }
 
-void ILP::createVariables(GRBModel& model, int numberOfLabels,
-		int numberOfSegments, vector<GRBVar*> &B, vector<GRBVar*>& X, vector<GRBVar*>& E, vector<GRBVar*>& V,
-		vector<GRBLinExpr *> & constraints,vector<char *>& sense,vector<double *>& rhs,vector<const string *>& names, Instance * instance) {
-	//B = new GRBVar[numberOfLabels][numberOfSegments];
-	//X = new GRBVar[numberOfLabels][numberOfSegments];
-	//E = new GRBVar[numberOfLabels][numberOfSegments];
+void ILP::createVariables(MIP::Model& model, int numberOfLabels,
+		int numberOfSegments, vector<MIP::Var*> &B, vector<MIP::Var*>& X, vector<MIP::Var*>& E, vector<MIP::Var*>& V, Instance * instance) {
+	//B = new MIP::Var[numberOfLabels][numberOfSegments];
+	//X = new MIP::Var[numberOfLabels][numberOfSegments];
+	//E = new MIP::Var[numberOfLabels][numberOfSegments];
 	B.resize(numberOfLabels);
 	X.resize(numberOfLabels);
 	E.resize(numberOfLabels);
 	V.resize(numberOfLabels);
-	constraints.resize(numberOfLabels*NC);
-	rhs.resize(numberOfLabels*NC);
-	names.resize(numberOfLabels*NC);
-	sense.resize(numberOfLabels*NC);
 
 
 	for(int i=0; i < numberOfLabels; i++){
-		B[i] = model.addVars(numberOfSegments,GRB_BINARY);
-		X[i] = model.addVars(numberOfSegments,GRB_BINARY);
-		E[i] = model.addVars(numberOfSegments,GRB_BINARY);
-		V[i] = model.addVars(instance->intervalsOfLabels->at(i)->size(), GRB_BINARY);
-		int number = numberOfSegments*NC;
-		constraints[i] = new GRBLinExpr[number];
-		rhs[i] = new double[number];
-		names[i] = new string[number];
-		sense[i] = new char[number];
+		B[i] = model.addVars(numberOfSegments);
+		X[i] = model.addVars(numberOfSegments);
+		E[i] = model.addVars(numberOfSegments);
+		V[i] = model.addVars(instance->intervalsOfLabels->at(i)->size());
 	}
-
-	model.update();
-
 }
 
 } // namespace ILP
@@ -9,7 +9,8 @@
 #define ILP_H_
 #include <vector>
 #include <set>
-#include <gurobi_c++.h>
+#include <string>
+#include "MIP.h"
 #include "util/clock.h"
 #include "Instance.h"
 #include "adapter.h"
@@ -27,21 +28,140 @@ inline long timevaldiff(struct timeval *starttime, struct timeval *finishtime)
   return msec;
 }
 	enum ModelType {AM1, AM2, AM3};
+
+/**
+ * Settings that change how the model is built, but not its optimum.
+ */
+struct Options {
+	Options();
+
+	// Only create variables for the atomic segments within the presence intervals of each
+	// label, instead of for all of them (defaults to ILP_SPARSE)
+	bool sparse;
+
+	// The MIP solver, see MIP::createSolver() (defaults to ILP_SOLVER)
+	std::string solver;
+
+	// How lazy the conflict constraints c8_ are, MIP::EAGER up to MIP::LAZY_RELAXATION
+	// (defaults to ILP_LAZY_CONFLICTS)
+	int lazyConflicts;
+};
+
+/**
+ * Maps the atomic segments of a label that have variables to their index in the variable
+ * arrays. The segments are kept as sorted ranges, adjacent ones are merged.
+ */
+class SegmentIndex {
+public:
+	SegmentIndex() : count(0) {}
+
+	/* [first, last] must lie after all ranges added before */
+	void addRange(int first, int last);
+	/* The index of the variables of the segment, -1 if it has none */
+	int at(int segment) const;
+	/* The number of segments with variables */
+	int size() const { return this->count; }
+
+	int getNumberOfRanges() const { return this->firsts.size(); }
+	int getFirst(int range) const { return this->firsts[range]; }
+	int getLast(int range) const { return this->lasts[range]; }
+
+private:
+	vector<int> firsts;
+	vector<int> lasts;
+	vector<int> offsets;
+	int count;
+};
+
 class ILP {
 public:
 
-	ILP();
+	ILP(Options options = Options());
 	virtual ~ILP();
 
-	bool execute(Instance * instance, ModelType modelType, vector<Intervals> & result, double &resultBound, double &gap, Clock & clock, int k, ILPAdapter *adapter, const char *dbg_filename);
+	bool execute(Instance * instance, ModelType modelType, vector<Intervals> & result, double &resultBound, double &gap, Clock & clock, int k, ILPAdapter *adapter, const char *dbg_filename, int component = 0);
+
+	/* execute() in two steps: build() creates the model, which solve() optimizes. The model is
+	 * kept until the ILP is destroyed or built again, so solve() can run again after
+	 * changeModel(). solve() stops the clock, but does not start it. It only reports its
+	 * progress to the adapter for a component that is not negative. */
+	void build(Instance *instance, ModelType modelType, int k, const char *dbg_filename);
+	bool solve(vector<Intervals> &result, double &resultBound, double &gap, Clock &clock, ILPAdapter *adapter, int component = 0);
+
+	/* Turns the built model into the one of the given type. The models only differ in which
+	 * witnesses c_9 and c_10 allow, so only their coefficients change. The last solution is the
+	 * start of the next solve(): it stays feasible from AM1 over AM2 to AM3. */
+	void changeModel(ModelType modelType);
+
+	/* Changes the k-restriction of the built model to k (none if negative), which must not be
+	 * below the one it was built with: only the right-hand sides of ck_ change. The last
+	 * solution is the start of the next solve(). If k got smaller, it is repaired first (see
+	 * repairStart()). */
+	void changeK(int k);
+
+	/* A MIP start for execute(): the selected intervals of every label of the instance (in the
+	 * same order and normalized like the instance). The solver may ignore it if it is
+	 * infeasible. */
+	void setStart(const vector<Intervals> &start);
+
+	/* The threads the solver may use in the next build() and solve(), num_threads if not
+	 * positive */
+	void setThreads(int threads);
+
+	/* A time limit for solve() that is shorter than the one of the adapter (or TIME_LIMIT), none
+	 * if not positive */
+	void setTimeLimit(double seconds);
 
 private:
 	vector<double>* createEvents(Instance * instance);
-	void createVariables(GRBModel& model, int numberOfLabels,
-			int numberOfSegments, vector<GRBVar*> &B, vector<GRBVar*>& X, vector<GRBVar*>& E, vector<GRBVar*>& V, vector<GRBLinExpr *> & constraints,
-			vector<char *>& sense, vector<double *> &rhs,vector<const string *>& names, Instance *instance);
+	/* Both fill the objective and all constraints, and return the X variables of every label
+	 * together with the atomic segments they belong to */
+	void createDenseModel(MIP::Model &model, Instance *instance, ModelType modelType, vector<double> *events, int k,
+			vector<MIP::Var *> &B, vector<MIP::Var *> &X, vector<MIP::Var *> &E, vector<MIP::Var *> &V, vector<SegmentIndex> &segments);
+	void createSparseModel(MIP::Model &model, Instance *instance, ModelType modelType, const vector<double> &events, int k,
+			vector<MIP::Var *> &B, vector<MIP::Var *> &X, vector<MIP::Var *> &E, vector<MIP::Var *> &V, vector<SegmentIndex> &segments);
+	/* Fixes the labels that continue from before a window, see Instance::boundaries */
+	void applyBoundaries(MIP::Model &model, Instance *instance, vector<MIP::Var *> &B, vector<MIP::Var *> &X,
+			vector<SegmentIndex> &segments);
+	void applyStart(MIP::Model &model, Instance *instance, const vector<double> &events, vector<MIP::Var *> &B, vector<MIP::Var *> &X,
+			vector<MIP::Var *> &E, vector<MIP::Var *> &V, vector<SegmentIndex> &segments);
+	/* Makes the values of a solution feasible for k: where more than k labels are selected,
+	 * the shortest selections are removed, and so are those that lose their witness */
+	void repairStart(vector<double> &values, int k) const;
+	void createVariables(MIP::Model& model, int numberOfLabels,
+			int numberOfSegments, vector<MIP::Var*> &B, vector<MIP::Var*>& X, vector<MIP::Var*>& E, vector<MIP::Var*>& V, Instance *instance);
+
+	void clear();
+
+	/* A c_9 or c_10 constraint, i.e., for the B or E of the label and atomic segment, with the
+	 * X variables of all opponents that may witness it in some model */
+	struct Witness {
+		MIP::Constr constr;
+		int label;
+		int event;
+		vector<MIP::Var> vars;
+	};
+
+	Options options;
+	vector<Intervals> start;
+	int threads;
+	double timeLimit;
 
+	// the model of the last build(), which the solver keeps
+	MIP::Solver *solver;
+	Instance *instance;
+	vector<double> *events;
+	vector<MIP::Var *> B, X, E, V;
+	vector<SegmentIndex> segments;
+	vector<Witness> endWitnesses;
+	vector<Witness> beginWitnesses;
+	ModelType modelType;
+	// the ck_ constraints, and the k they were built for
+	vector<MIP::Constr> kConstrs;
+	int k;
 
+	ILP(const ILP &) = delete;
+	ILP &operator=(const ILP &) = delete;
 };
 
 } // namespace ILP
@@ -13,15 +13,18 @@ Instance::Instance() {
 	  intervalsOfLabels = new vector<Intervals*>();
 	  intervalsOfConflicts = new vector<Intervals*>();
 	  conflicts = new vector<Conflict*>();
+	  ownsIntervals = true;
 
 }
 
 Instance::~Instance() {
-	for(vector<Intervals*>::iterator it = intervalsOfLabels->begin(); it != intervalsOfLabels->end(); ++it){
-		delete *it;
-	}
-	for(vector<Intervals*>::iterator it =intervalsOfConflicts->begin(); it != intervalsOfConflicts->end(); ++it){
-		delete *it;
+	if(ownsIntervals){
+		for(vector<Intervals*>::iterator it = intervalsOfLabels->begin(); it != intervalsOfLabels->end(); ++it){
+			delete *it;
+		}
+		for(vector<Intervals*>::iterator it =intervalsOfConflicts->begin(); it != intervalsOfConflicts->end(); ++it){
+			delete *it;
+		}
 	}
 	for(vector<Conflict*>::iterator it =conflicts->begin(); it != conflicts->end(); ++it){
 		delete *it;
@@ -15,6 +15,24 @@ using namespace std;
 namespace ILP {
 using namespace ILP;
 
+/**
+ * How a label enters a window of a longer instance (see RollingHorizon.h) whose first
+ * presence interval began before the window.
+ */
+struct Boundary {
+	enum State {
+		FREE,    // the first presence interval begins with the window
+		OPEN,    // selected when the window begins, the selection has to continue
+		WAITING  // not selected in the presence interval yet, a selection must not begin with the window
+	};
+
+	Boundary() : state(FREE), before(0.0) {}
+
+	State state;
+	// the length of the first presence interval before the window
+	double before;
+};
+
 class Instance {
 public:
 	Instance();
@@ -23,6 +41,15 @@ public:
 	vector<Intervals*> * intervalsOfConflicts;
 	vector<Conflict*> *  conflicts;
 	double originalMax;
+	// false if the intervals belong to another instance (see findComponents()), true by default
+	bool ownsIntervals;
+	// one for every label if the instance is a window of a longer one, empty otherwise
+	vector<Boundary> boundaries;
+
+	/* The length of the presence interval before the instance, 0 unless it is a window */
+	double getLengthBefore(int label, int presence) const {
+		return (presence == 0 && !boundaries.empty()) ? boundaries[label].before : 0.0;
+	}
 };
 
 } // namespace ILP
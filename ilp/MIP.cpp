@@ -0,0 +1,255 @@
+/*
+ * MIP.cpp
+ *
+ * A solver independent description of a mixed integer program, and the interface of the
+ * solvers that optimize it.
+ */
+#include <algorithm>
+#include <limits>
+#include "MIP.h"
+#ifdef WITH_GUROBI
+#include "GurobiSolver.h"
+#endif
+#ifdef WITH_HIGHS
+#include "HighsSolver.h"
+#endif
+
+namespace MIP {
+
+void LinExpr::addTerms(const double *coefficients, const Var *vars, int count) {
+	this->vars.reserve(this->vars.size() + count);
+	this->coefficients.reserve(this->coefficients.size() + count);
+	for(int i=0; i < count; ++i){
+		this->vars.push_back(vars[i].index);
+		this->coefficients.push_back(coefficients[i]);
+	}
+}
+
+LinExpr &LinExpr::operator+=(const LinExpr &expr) {
+	this->vars.insert(this->vars.end(), expr.vars.begin(), expr.vars.end());
+	this->coefficients.insert(this->coefficients.end(), expr.coefficients.begin(), expr.coefficients.end());
+	this->constant += expr.constant;
+	return *this;
+}
+
+LinExpr &LinExpr::operator-=(const LinExpr &expr) {
+	this->vars.insert(this->vars.end(), expr.vars.begin(), expr.vars.end());
+	for(double coefficient : expr.coefficients){
+		this->coefficients.push_back(-coefficient);
+	}
+	this->constant -= expr.constant;
+	return *this;
+}
+
+LinExpr &LinExpr::operator*=(double factor) {
+	for(double &coefficient : this->coefficients){
+		coefficient *= factor;
+	}
+	this->constant *= factor;
+	return *this;
+}
+
+LinExpr operator+(LinExpr left, const LinExpr &right) {
+	return left += right;
+}
+
+LinExpr operator-(LinExpr left, const LinExpr &right) {
+	return left -= right;
+}
+
+LinExpr operator*(Var var, double factor) {
+	return LinExpr(var, factor);
+}
+
+LinExpr operator*(double factor, Var var) {
+	return LinExpr(var, factor);
+}
+
+LinExpr operator*(LinExpr expr, double factor) {
+	return expr *= factor;
+}
+
+LinExpr operator*(double factor, LinExpr expr) {
+	return expr *= factor;
+}
+
+namespace {
+
+/* left - right (sense) 0, Model::addConstr() moves the constant to the right hand side */
+TempConstr compare(const LinExpr &left, char sense, const LinExpr &right) {
+	TempConstr constr;
+	constr.expr = left - right;
+	constr.sense = sense;
+	constr.rhs = 0.0;
+	return constr;
+}
+
+}
+
+TempConstr operator<=(const LinExpr &left, const LinExpr &right) {
+	return compare(left, LESS_EQUAL, right);
+}
+
+TempConstr operator>=(const LinExpr &left, const LinExpr &right) {
+	return compare(left, GREATER_EQUAL, right);
+}
+
+TempConstr operator==(const LinExpr &left, const LinExpr &right) {
+	return compare(left, EQUAL, right);
+}
+
+Model::Model(bool named) : named(named), rowBegins(1, 0), objectiveSense(MINIMIZE) {
+}
+
+Var *Model::addVars(int count) {
+	Var *vars = new Var[count];
+	for(int i=0; i < count; ++i){
+		vars[i] = Var(this->objective.size());
+		this->objective.push_back(0.0);
+	}
+	if(!this->start.empty()){
+		this->start.resize(this->objective.size(), std::numeric_limits<double>::quiet_NaN());
+	}
+	return vars;
+}
+
+Constr Model::addConstr(const LinExpr &expr, char sense, double rhs, const std::string &name) {
+	// the terms sorted by variable, so that duplicates are next to each other
+	std::vector<std::pair<int, double> > terms;
+	terms.reserve(expr.size());
+	for(int term=0; term < expr.size(); ++term){
+		terms.push_back(std::make_pair(expr.getVar(term), expr.getCoefficient(term)));
+	}
+	std::sort(terms.begin(), terms.end());
+
+	for(unsigned int i=0; i < terms.size(); ){
+		int var = terms[i].first;
+		double coefficient = 0.0;
+		for(; i < terms.size() && terms[i].first == var; ++i){
+			coefficient += terms[i].second;
+		}
+		if(coefficient != 0.0){
+			this->columns.push_back(var);
+			this->values.push_back(coefficient);
+		}
+	}
+	this->rowBegins.push_back(this->columns.size());
+	this->senses.push_back(sense);
+	this->rhs.push_back(rhs - expr.getConstant());
+	if(this->named){
+		this->names.push_back(name);
+	}
+	if(!this->lazy.empty()){
+		this->lazy.push_back(EAGER);
+	}
+	return Constr(this->senses.size() - 1);
+}
+
+Constr Model::addConstr(const TempConstr &constr, const std::string &name) {
+	return addConstr(constr.expr, constr.sense, constr.rhs, name);
+}
+
+Constr Model::appendRows(const std::vector<int> &begins, const std::vector<int> &columns, const std::vector<double> &values,
+		const std::vector<char> &senses, const std::vector<double> &rhs, const std::vector<std::string> *names) {
+	Constr first(this->senses.size());
+	int count = senses.size();
+	this->columns.reserve(this->columns.size() + columns.size());
+	this->values.reserve(this->values.size() + values.size());
+	// the last row of the variable and its entry there, so that duplicates are merged without sorting
+	std::vector<int> lastRow(this->objective.size(), -1);
+	std::vector<int> position(this->objective.size());
+	for(int row=0; row < count; ++row){
+		int rowBegin = this->columns.size();
+		for(int entry=begins[row]; entry < begins[row+1]; ++entry){
+			int var = columns[entry];
+			if(lastRow[var] == row){
+				this->values[position[var]] += values[entry];
+			}else{
+				lastRow[var] = row;
+				position[var] = this->columns.size();
+				this->columns.push_back(var);
+				this->values.push_back(values[entry]);
+			}
+		}
+		// zeros are rare, they only remain from merged duplicates
+		int end = rowBegin;
+		for(unsigned int entry=rowBegin; entry < this->columns.size(); ++entry){
+			if(this->values[entry] != 0.0){
+				this->columns[end] = this->columns[entry];
+				this->values[end] = this->values[entry];
+				++end;
+			}
+		}
+		this->columns.resize(end);
+		this->values.resize(end);
+		this->rowBegins.push_back(end);
+	}
+	this->senses.insert(this->senses.end(), senses.begin(), senses.end());
+	this->rhs.insert(this->rhs.end(), rhs.begin(), rhs.end());
+	if(this->named){
+		if(names != nullptr){
+			this->names.insert(this->names.end(), names->begin(), names->end());
+		}else{
+			this->names.resize(this->senses.size());
+		}
+	}
+	if(!this->lazy.empty()){
+		this->lazy.resize(this->senses.size(), EAGER);
+	}
+	return first;
+}
+
+void Model::setObjective(const LinExpr &expr, int sense) {
+	std::fill(this->objective.begin(), this->objective.end(), 0.0);
+	for(int term=0; term < expr.size(); ++term){
+		this->objective[expr.getVar(term)] += expr.getCoefficient(term);
+	}
+	this->objectiveSense = sense;
+}
+
+void Model::setStart(Var var, double value) {
+	if(this->start.empty()){
+		this->start.assign(this->objective.size(), std::numeric_limits<double>::quiet_NaN());
+	}
+	this->start[var.index] = value;
+}
+
+void Model::setLazy(Constr constr, int lazy) {
+	if(this->lazy.empty()){
+		this->lazy.assign(this->senses.size(), EAGER);
+	}
+	this->lazy[constr.index] = lazy;
+}
+
+std::vector<std::string> getSolverNames() {
+	std::vector<std::string> names;
+#ifdef WITH_GUROBI
+	names.push_back("gurobi");
+#endif
+#ifdef WITH_HIGHS
+	names.push_back("highs");
+#endif
+	return names;
+}
+
+Solver *createSolver(const std::string &name, int threads) {
+	std::vector<std::string> names = getSolverNames();
+	std::string solver = name;
+	if(solver.empty() && !names.empty()){
+		solver = names.front();
+	}
+#ifdef WITH_GUROBI
+	if(solver == "gurobi"){
+		return new GurobiSolver(threads);
+	}
+#endif
+#ifdef WITH_HIGHS
+	if(solver == "highs"){
+		return new HighsSolver(threads);
+	}
+#endif
+	(void)threads;
+	throw Error("The MIP solver '" + solver + "' is not part of this build (see MIP_BACKENDS in tmlframework.pro)");
+}
+
+} // namespace MIP
@@ -0,0 +1,234 @@
+/*
+ * MIP.h
+ *
+ * A solver independent description of a mixed integer program, and the interface of the
+ * solvers that optimize it.
+ */
+
+#ifndef MIP_H_
+#define MIP_H_
+
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace MIP {
+
+// the senses of the constraints (the same characters as in Gurobi)
+const char LESS_EQUAL    = '<';
+const char GREATER_EQUAL = '>';
+const char EQUAL         = '=';
+
+// the senses of the objective
+const int MINIMIZE = 1;
+const int MAXIMIZE = -1;
+
+// larger than any bound or gap the solvers report
+const double INFINITE = 1e100;
+
+// how lazy a constraint is (the values of the Lazy attribute of Gurobi): a lazy constraint is
+// left out of the model until a solution violates it
+const int EAGER = 0;
+const int LAZY_SOME = 1;       // one of the violated constraints is added to cut off a solution
+const int LAZY_ALL = 2;        // all that a solution violates are added
+const int LAZY_RELAXATION = 3; // also those that the relaxation at the root violates
+
+/* A variable of a Model, i.e., its column */
+struct Var {
+	Var() : index(-1) {}
+	explicit Var(int index) : index(index) {}
+
+	int index;
+};
+
+/* A constraint of a Model, i.e., its row */
+struct Constr {
+	Constr() : index(-1) {}
+	explicit Constr(int index) : index(index) {}
+
+	int index;
+};
+
+/**
+ * A linear expression, i.e., a weighted sum of variables and a constant. Terms of the same
+ * variable are only merged once the expression becomes part of a model.
+ */
+class LinExpr {
+public:
+	LinExpr(double constant = 0.0) : constant(constant) {}
+	LinExpr(Var var, double coefficient = 1.0) : vars(1, var.index), coefficients(1, coefficient), constant(0.0) {}
+
+	void addTerms(const double *coefficients, const Var *vars, int count);
+
+	LinExpr &operator+=(const LinExpr &expr);
+	LinExpr &operator-=(const LinExpr &expr);
+	LinExpr &operator*=(double factor);
+
+	int size() const { return this->vars.size(); }
+	int getVar(int term) const { return this->vars[term]; }
+	double getCoefficient(int term) const { return this->coefficients[term]; }
+	double getConstant() const { return this->constant; }
+
+private:
+	std::vector<int> vars;
+	std::vector<double> coefficients;
+	double constant;
+};
+
+LinExpr operator+(LinExpr left, const LinExpr &right);
+LinExpr operator-(LinExpr left, const LinExpr &right);
+LinExpr operator*(Var var, double factor);
+LinExpr operator*(double factor, Var var);
+LinExpr operator*(LinExpr expr, double factor);
+LinExpr operator*(double factor, LinExpr expr);
+
+/* A constraint that is not part of a model yet, the result of comparing two expressions */
+struct TempConstr {
+	LinExpr expr;
+	char sense;
+	double rhs;
+};
+
+TempConstr operator<=(const LinExpr &left, const LinExpr &right);
+TempConstr operator>=(const LinExpr &left, const LinExpr &right);
+TempConstr operator==(const LinExpr &left, const LinExpr &right);
+
+/**
+ * A program with binary variables, linear constraints and a linear objective. The constraints
+ * are kept in compressed sparse rows, without duplicate or zero entries. Names of the
+ * constraints are only kept if the model is named, they are only needed to write it.
+ */
+class Model {
+public:
+	Model(bool named = false);
+
+	/* Adds count binary variables. The caller owns the returned array (delete[]). */
+	Var *addVars(int count);
+
+	Constr addConstr(const LinExpr &expr, char sense, double rhs, const std::string &name = "");
+	Constr addConstr(const TempConstr &constr, const std::string &name = "");
+	/* Adds constraints that are already in compressed sparse rows (see getRowBegins()), the
+	 * entries of each row in any order. The names may be nullptr. Returns the first of the
+	 * new constraints, the others follow it. */
+	Constr appendRows(const std::vector<int> &begins, const std::vector<int> &columns, const std::vector<double> &values,
+			const std::vector<char> &senses, const std::vector<double> &rhs, const std::vector<std::string> *names);
+
+	/* sense is MINIMIZE or MAXIMIZE, the constant of the expression is ignored */
+	void setObjective(const LinExpr &expr, int sense);
+
+	/* A value of the variable in the MIP start. Variables without one are left to the solver. */
+	void setStart(Var var, double value);
+
+	/* How lazy the constraint is (EAGER, LAZY_SOME, LAZY_ALL or LAZY_RELAXATION). The
+	 * constraints are eager unless set otherwise; solvers without lazy constraints treat all
+	 * of them as eager. */
+	void setLazy(Constr constr, int lazy);
+
+	int getNumberOfVars() const { return this->objective.size(); }
+	int getNumberOfConstrs() const { return this->senses.size(); }
+	bool isNamed() const { return this->named; }
+
+	// the rows: the entries of row i are [rowBegins[i], rowBegins[i+1]) of columns and values
+	const std::vector<int> &getRowBegins() const { return this->rowBegins; }
+	const std::vector<int> &getColumns() const { return this->columns; }
+	const std::vector<double> &getValues() const { return this->values; }
+	const std::vector<char> &getSenses() const { return this->senses; }
+	const std::vector<double> &getRhs() const { return this->rhs; }
+	/* empty if the model is not named */
+	const std::vector<std::string> &getNames() const { return this->names; }
+	/* empty if all constraints are eager */
+	const std::vector<char> &getLazy() const { return this->lazy; }
+
+	const std::vector<double> &getObjective() const { return this->objective; }
+	int getObjectiveSense() const { return this->objectiveSense; }
+
+	/* NaN for the variables without start value, empty if there are none */
+	const std::vector<double> &getStart() const { return this->start; }
+
+private:
+	bool named;
+	std::vector<int> rowBegins;
+	std::vector<int> columns;
+	std::vector<double> values;
+	std::vector<char> senses;
+	std::vector<double> rhs;
+	std::vector<std::string> names;
+	std::vector<char> lazy;
+	std::vector<double> objective;
+	int objectiveSense;
+	std::vector<double> start;
+};
+
+/**
+ * An error of a solver. Code is the one of the solver, if it has any.
+ */
+class Error : public std::runtime_error {
+public:
+	Error(const std::string &message, int code = 0, bool outOfMemory = false) :
+		std::runtime_error(message), code(code), outOfMemory(outOfMemory) {}
+
+	int getCode() const { return this->code; }
+	bool isOutOfMemory() const { return this->outOfMemory; }
+
+private:
+	int code;
+	bool outOfMemory;
+};
+
+/**
+ * A MIP solver that optimizes one model at a time. Everything that goes wrong in the solver
+ * is thrown as Error.
+ */
+class Solver {
+public:
+	/* Called with the best objective value (-INFINITE or INFINITE if there is no solution yet)
+	 * and the best bound whenever the solver has news about them */
+	typedef std::function<void(double best, double bound)> Progress;
+	/* Polled during the optimization, which stops once it returns true */
+	typedef std::function<bool()> Interrupt;
+
+	enum Status {
+		FINISHED, // the search is complete, i.e., the model is solved or known to have no solution
+		STOPPED   // by the time limit or an interrupt
+	};
+
+	virtual ~Solver() {}
+
+	/* Replaces the model of the solver, including the MIP start */
+	virtual void load(const Model &model) = 0;
+	/* A MIP start with a value for every variable (NaN for those without one) */
+	virtual void setStart(const std::vector<double> &values) = 0;
+	/* Changes the coefficient of the variable in the constraint of the loaded model. Like
+	 * changeRhs(), this may discard the solution and the MIP start, so set the start after. */
+	virtual void changeCoefficient(Constr constr, Var var, double value) = 0;
+	/* Changes the right-hand side of the constraint of the loaded model */
+	virtual void changeRhs(Constr constr, double rhs) = 0;
+
+	virtual void setTimeLimit(double seconds) = 0;
+	/* For the next optimize(), the solver may ignore it */
+	virtual void setThreads(int threads) = 0;
+	virtual Status optimize(const Progress &progress = Progress(), const Interrupt &interrupt = Interrupt()) = 0;
+
+	// after optimize()
+	virtual bool hasSolution() const = 0;
+	/* The values of all variables in the best solution */
+	virtual std::vector<double> getValues() const = 0;
+	virtual double getBound() const = 0;
+	virtual double getGap() const = 0;
+
+	/* Writes the loaded model, the format depends on the file extension */
+	virtual void write(const char *filename) = 0;
+};
+
+/* The names of the solvers this build can create, the first one is the default */
+std::vector<std::string> getSolverNames();
+
+/* A solver by name (see getSolverNames(), the default one if the name is empty) that may use
+ * the given number of threads. The caller owns it. Throws Error if the solver is not part of
+ * this build. */
+Solver *createSolver(const std::string &name, int threads);
+
+} // namespace MIP
+
+#endif /* MIP_H_ */
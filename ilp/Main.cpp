@@ -16,13 +16,12 @@
 #include "Instance.h"
 #include "Import.h"
 #include "ILP.h"
+#include "Components.h"
 
 using namespace std;
 
 namespace ILP {
 
-void findComponents(Instance * instance,vector<Instance*>& instances);
-
 int
 main(int   argc,
      char *argv[])
@@ -199,92 +198,4 @@ main(int   argc,
   return 0;
 }
 
-void findComponents(Instance * instance,vector<Instance*>& instances){
-	vector<vector<int> > graph = vector<vector<int> >();
-	int * component = new int[instance->intervalsOfLabels->size()];
-
-	for(unsigned int i=0; i < instance->intervalsOfLabels->size(); i++){
-		graph.push_back(vector<int>());
-		component[i]=0;
-	}
-
-	for(vector<Conflict*>::iterator it = instance->conflicts->begin() ;
-			it != instance->conflicts->end(); ++it){
-		Conflict * c = *it;
-		graph[c->getLabel1()].push_back(c->getLabel2());
-		graph[c->getLabel2()].push_back(c->getLabel1());
-	}
-
-	list<int> queue = list<int>();
-
-	int index =1;
-
-	for(unsigned int i=0; i < instance->intervalsOfLabels->size(); i++){
-		if(component[i]==0){
-
-			queue.push_back(i);
-			component[i] = index;
-			while(!queue.empty()){
-				int label = queue.front();
-				queue.pop_front();
-				for(vector<int>::iterator it =  graph[label].begin(); it != graph[label].end(); ++it){
-					int opponent = *it;
-					if(component[opponent]== 0){
-					    component[opponent] = index;
-					   	queue.push_back(opponent);
-
-					}else if(component[opponent]!= index){
-						throw "error!!!!";
-					}
-				}
-			}
-
-			index++;
-		}
-
-	}
-
-
-
-	for(int i=0; i < index-1; i++){
-		instances.push_back(new Instance());
-	}
-
-	int * newIds = new int[instance->intervalsOfLabels->size()];
-
-	for(unsigned int i=0; i < instance->intervalsOfLabels->size(); i++){
-		newIds[i] = instances[component[i]-1]->intervalsOfLabels->size();
-		instances[component[i]-1]->intervalsOfLabels->push_back(instance->intervalsOfLabels->at(i));
-	}
-
-
-
-	for(unsigned int i=0; i < instance->conflicts->size(); i++){
-		Conflict *c = instance->conflicts->at(i);
-		if(component[c->label1] != component[c->label2]){
-			throw "Wrong components";
-		}
-		int comp = component[c->label1];
-		instances[comp-1]->conflicts->push_back(new Conflict(newIds[c->label1],newIds[c->label2]));
-
-		instances[comp-1]->intervalsOfConflicts->push_back(instance->intervalsOfConflicts->at(i));
-	}
-//
-//	cout << newIds[36] << " " << newIds[37] << endl;
-//		cout << component[36] << " " << component[37] << endl;
-//		Instance * test = instances[32];
-//		for(int i=0; i  < test->intervalsOfLabels->size(); i++){
-//			cout << test->intervalsOfLabels->at(i)->getId() << endl;
-//		}
-//		for(int i=0; i  < test->conflicts->size(); i++){
-//			cout << test->intervalsOfConflicts->at(i)->getId() << endl;
-//			cout << test->conflicts->at(i)->label1 << " " <<test->conflicts->at(i)->label2  << endl;
-//		}
-		//throw "check";
-
-	delete [] component;
-	delete [] newIds;
-
-}
-
 } // Namespace ILP
@@ -0,0 +1,272 @@
+/*
+ * RollingHorizon.cpp
+ *
+ * Solving instances that are too long for a single model in overlapping windows.
+ */
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <set>
+#include "RollingHorizon.h"
+#include "MIP.h"
+#include "adapter.h"
+#include "config.h"
+
+namespace ILP {
+
+namespace {
+
+/* The end of the presence interval of the label that contains the time, and of those that
+ * directly follow it, the time itself if there is none */
+double presenceEnd(const Intervals &presences, double time) {
+	double end = time;
+	for(int presence=0; presence < presences.getNumberOfIntervals(); ++presence){
+		double begin = presences[presence*2];
+		bool contains = (begin < end) || (begin == end && end > time);
+		if(contains && end < presences[presence*2+1]){
+			end = presences[presence*2+1];
+		}
+	}
+	return end;
+}
+
+double totalLength(const Intervals &intervals) {
+	double length = 0;
+	for(unsigned int i=0; i+1 < intervals.size(); i+=2){
+		length += intervals[i+1] - intervals[i];
+	}
+	return length;
+}
+
+}
+
+RollingHorizon::RollingHorizon(double length, int threads) : length(length), threads(threads), windows(0), cuts(0) {
+}
+
+void RollingHorizon::keep(int label, double begin, double end) {
+	Intervals &intervals = this->kept[label];
+	if(!intervals.empty() && intervals.back() == begin){
+		intervals.back() = end;
+	}else{
+		intervals.add(begin, end);
+	}
+}
+
+Instance *RollingHorizon::cutWindow(Instance *instance, double begin, double end, vector<int> &labels, map<double, double> &original) const {
+	Instance *window = new Instance();
+	window->originalMax = instance->originalMax * (end - begin);
+	original.clear();
+	original[0.0] = begin;
+	original[1.0] = end;
+	// the same endpoint always becomes the same event
+	auto stretch = [begin, end, &original](double time) {
+		if(time <= begin){
+			return 0.0;
+		}
+		if(time >= end){
+			return 1.0;
+		}
+		double stretched = (time - begin) / (end - begin);
+		original[stretched] = time;
+		return stretched;
+	};
+
+	labels.clear();
+	vector<int> index(instance->intervalsOfLabels->size(), -1);
+	for(unsigned int label=0; label < instance->intervalsOfLabels->size(); ++label){
+		Intervals *presences = instance->intervalsOfLabels->at(label);
+		Intervals *pieces = new Intervals(presences->getId());
+		Boundary boundary;
+		for(int presence=0; presence < presences->getNumberOfIntervals(); ++presence){
+			double first = presences->at(presence*2);
+			double last = presences->at(presence*2+1);
+			if(last <= begin || first >= end){
+				continue;
+			}
+			if(first < begin || (first == begin && this->open[label])){
+				// a presence interval can only hold one selection
+				const Intervals &kept = this->kept[label];
+				if(!this->open[label] && !kept.empty() && kept.back() > first){
+					continue;
+				}
+				boundary.state = this->open[label] ? Boundary::OPEN : Boundary::WAITING;
+				boundary.before = (begin - first) / (end - begin);
+			}
+			pieces->add(stretch(first), stretch(last));
+		}
+		if(pieces->getNumberOfIntervals() == 0){
+			delete pieces;
+			continue;
+		}
+		index[label] = labels.size();
+		labels.push_back(label);
+		window->intervalsOfLabels->push_back(pieces);
+		window->boundaries.push_back(boundary);
+	}
+
+	for(unsigned int conflict=0; conflict < instance->conflicts->size(); ++conflict){
+		int label1 = index[instance->conflicts->at(conflict)->getLabel1()];
+		int label2 = index[instance->conflicts->at(conflict)->getLabel2()];
+		if(label1 < 0 || label2 < 0){
+			continue;
+		}
+		Intervals *intervals = instance->intervalsOfConflicts->at(conflict);
+		Intervals *pieces = new Intervals(intervals->getId());
+		for(int i=0; i < intervals->getNumberOfIntervals(); ++i){
+			double first = intervals->at(i*2);
+			double last = intervals->at(i*2+1);
+			if(last > begin && first < end){
+				pieces->add(stretch(first), stretch(last));
+			}
+		}
+		if(pieces->getNumberOfIntervals() == 0){
+			delete pieces;
+			continue;
+		}
+		window->intervalsOfConflicts->push_back(pieces);
+		window->conflicts->push_back(new Conflict(label1, label2));
+	}
+	return window;
+}
+
+bool RollingHorizon::solve(Instance *instance, ModelType modelType, int k, vector<Intervals> &result, ILPAdapter *adapter, int component) {
+	int numberOfLabels = instance->intervalsOfLabels->size();
+	this->kept.clear();
+	for(int label=0; label < numberOfLabels; ++label){
+		this->kept.push_back(Intervals(instance->intervalsOfLabels->at(label)->getId()));
+	}
+	this->open.assign(numberOfLabels, false);
+	this->windows = 0;
+	this->cuts = 0;
+
+	double step = this->length * (1.0 - ILP_HORIZON_OVERLAP);
+	bool complete = true;
+	// all endpoints, the windows begin and end at them where they can
+	set<double> events;
+	events.insert(1.0);
+	for(Intervals *intervals : *instance->intervalsOfLabels){
+		events.insert(intervals->begin(), intervals->end());
+	}
+	for(Intervals *intervals : *instance->intervalsOfConflicts){
+		events.insert(intervals->begin(), intervals->end());
+	}
+	// the selection of the last window after its front part, kept if the next one fails
+	vector<pair<int, pair<double, double> > > rest;
+	double restEnd = 0.0;
+
+	double begin = 0.0;
+	while(begin < 1.0){
+		if(adapter != nullptr && (adapter->stopComponents() || adapter->solveTimeLeft() <= 0)){
+			complete = false;
+			break;
+		}
+
+		double nominalEnd = std::min(1.0, begin + this->length);
+		double end = nominalEnd;
+		for(Intervals *presences : *instance->intervalsOfLabels){
+			end = std::max(end, presenceEnd(*presences, nominalEnd));
+		}
+		// The end of a window is like the end of the instance, a selection may stop there
+		// without ending. Thus the presence intervals that reach it must not end there.
+		if(end < 1.0){
+			end = *events.upper_bound(end);
+		}
+		double front = 1.0;
+		if(end < 1.0){
+			front = std::min(begin + step, nominalEnd);
+			set<double>::iterator event = events.upper_bound(front);
+			if(*(--event) > begin){
+				front = *event;
+			}
+		}
+
+		vector<int> labels;
+		map<double, double> original;
+		Instance *window = cutWindow(instance, begin, end, labels, original);
+		vector<Intervals> selection;
+		bool solved = true;
+		if(!labels.empty()){
+			// the time left is shared evenly with the windows that are still to come
+			int windowsLeft = 1 + std::max(0, (int)std::ceil((1.0 - begin - this->length) / step));
+			double timeLeft = (adapter != nullptr) ? adapter->solveTimeLeft() : TIME_LIMIT;
+
+			ILP ilp;
+			ilp.setThreads(this->threads);
+			ilp.setTimeLimit(std::max(timeLeft / windowsLeft, 1.0));
+			ilp.build(window, modelType, k, nullptr);
+			double bound, gap;
+			Clock clock;
+			clock.start();
+			complete = ilp.solve(selection, bound, gap, clock, adapter, -1) && complete;
+			solved = !selection.empty();
+			this->windows++;
+		}
+		delete window;
+
+		if(!solved){
+			// the selection of the window before stays as it is, up to its end
+			std::cout << "Rolling horizon: no solution for the window from " << begin << " to " << end << "\n";
+			for(auto &part : rest){
+				keep(part.first, part.second.first, part.second.second);
+				if(part.second.second == restEnd && restEnd < 1.0){
+					this->cuts++;
+				}
+			}
+			rest.clear();
+			this->open.assign(numberOfLabels, false);
+			complete = false;
+			begin = std::max(restEnd, front);
+			continue;
+		}
+
+		rest.clear();
+		restEnd = end;
+		this->open.assign(numberOfLabels, false);
+		for(unsigned int i=0; i < selection.size(); ++i){
+			int label = labels[i];
+			const Intervals &intervals = selection[i];
+			for(unsigned int j=0; j+1 < intervals.size(); j+=2){
+				double first = original.at(intervals[j]);
+				double last = original.at(intervals[j+1]);
+				if(first < front){
+					keep(label, first, std::min(last, front));
+				}
+				// one that begins at the front as well, another one may end there because of it
+				if(first <= front && last > front){
+					this->open[label] = true;
+				}
+				if(last > front){
+					rest.push_back(make_pair(label, make_pair(std::max(first, front), last)));
+				}
+			}
+		}
+		begin = front;
+
+		if(adapter != nullptr){
+			double score = 0.0;
+			for(const Intervals &intervals : this->kept){
+				score += totalLength(intervals);
+			}
+			adapter->reportComponent(component, score, MIP::INFINITE);
+		}
+	}
+
+	// a stopped rolling horizon keeps what the last window found after its front part
+	if(begin < 1.0){
+		for(auto &part : rest){
+			keep(part.first, part.second.first, part.second.second);
+			if(part.second.second == restEnd && restEnd < 1.0){
+				this->cuts++;
+			}
+		}
+	}
+
+	if(this->cuts > 0){
+		std::cout << "Rolling horizon: " << this->cuts << " selections end where a window ended\n";
+	}
+	std::cout << "Rolling horizon: " << this->windows << " windows\n";
+	result.insert(result.end(), this->kept.begin(), this->kept.end());
+	return complete && this->cuts == 0;
+}
+
+} // namespace ILP
@@ -0,0 +1,72 @@
+/*
+ * RollingHorizon.h
+ *
+ * Solving instances that are too long for a single model in overlapping windows.
+ */
+
+#ifndef ROLLINGHORIZON_H_
+#define ROLLINGHORIZON_H_
+
+#include <map>
+#include <vector>
+#include "ILP.h"
+#include "Instance.h"
+#include "Intervals.h"
+
+class ILPAdapter;
+
+namespace ILP {
+
+/**
+ * Solves an instance window by window instead of as a whole. Every window is a model of its
+ * own: the part of the instance within the window, stretched to [0, 1]. Once it is solved,
+ * the selection within its front part (all but the last ILP_HORIZON_OVERLAP of the length)
+ * is kept, and the next window begins where the front part ends. Thus the overlap lets the
+ * decisions of the front part see what comes after it.
+ *
+ * The state at the beginning of a window is carried over as the boundaries of its instance
+ * (see Boundary): a selection that is open there (or begins there) continues, and a label
+ * whose presence interval began before the window, but that is not selected, must not begin
+ * with the window. A window ends at least at the given length, and after the presence
+ * intervals (and the adjacent ones after them) that contain its nominal end, since a
+ * selection may stop at the end of a model without ending.
+ * The k-restriction only concerns single atomic segments, so every window keeps it.
+ *
+ * The result is feasible for the whole instance, but not necessarily optimal. There is no
+ * bound besides the trivial one. If a window has no solution in its time, the selection of
+ * the window before is kept up to its end, and the selections that are open there end
+ * there (they are counted as cuts).
+ */
+class RollingHorizon {
+public:
+	/* Windows of at least the given length (normalized like the instance) */
+	RollingHorizon(double length, int threads = 0);
+
+	/* The selection of every label of the instance, in its order. Returns whether all windows
+	 * were solved completely. With an adapter, the windows share its deadline, and the score of
+	 * the selection kept so far is reported for the component. */
+	bool solve(Instance *instance, ModelType modelType, int k, vector<Intervals> &result, ILPAdapter *adapter = nullptr, int component = 0);
+
+	// after solve()
+	int getNumberOfWindows() const { return this->windows; }
+	int getNumberOfCuts() const { return this->cuts; }
+
+private:
+	/* The part of the instance within [begin, end]. original maps the new endpoints back. */
+	Instance *cutWindow(Instance *instance, double begin, double end, vector<int> &labels, map<double, double> &original) const;
+	/* Adds [begin, end] to the kept selection of the label, merged with one that ends at begin */
+	void keep(int label, double begin, double end);
+
+	double length;
+	int threads;
+	int windows;
+	int cuts;
+
+	// during solve(): the selection that is kept, and whether it is open at the current window
+	vector<Intervals> kept;
+	vector<bool> open;
+};
+
+} // namespace ILP
+
+#endif /* ROLLINGHORIZON_H_ */
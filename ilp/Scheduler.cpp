@@ -0,0 +1,129 @@
+/*
+ * Scheduler.cpp
+ *
+ * Sharing the threads of the process between the MIP solves that run at the same time.
+ */
+#include <algorithm>
+#include <cassert>
+#include "Scheduler.h"
+#include "config.h"
+
+namespace MIP {
+
+namespace {
+
+// How often (in milliseconds) a waiting solve checks whether it was cancelled
+const int POLL_INTERVAL = 50;
+
+}
+
+Scheduler::Lease::Lease(Lease &&other) : scheduler(other.scheduler), threads(other.threads) {
+	other.scheduler = nullptr;
+	other.threads = 0;
+}
+
+Scheduler::Lease &Scheduler::Lease::operator=(Lease &&other) {
+	if (this != &other) {
+		release();
+		this->scheduler = other.scheduler;
+		this->threads = other.threads;
+		other.scheduler = nullptr;
+		other.threads = 0;
+	}
+	return *this;
+}
+
+Scheduler::Lease::~Lease() {
+	release();
+}
+
+void Scheduler::Lease::release() {
+	if (this->scheduler != nullptr && this->threads > 0) {
+		this->scheduler->giveBack(this->threads);
+	}
+	this->scheduler = nullptr;
+	this->threads = 0;
+}
+
+Scheduler::Scheduler(int budget) : budget(std::max(budget, 1)), inUse(0), nextTicket(0), busyTime(0), capacityTime(0) {
+	this->lastChange = SchedulerClock::now();
+	this->statistics = Statistics();
+}
+
+Scheduler &Scheduler::global() {
+	static Scheduler scheduler(num_threads);
+	return scheduler;
+}
+
+void Scheduler::setBudget(int budget) {
+	std::lock_guard<std::mutex> lock(this->mutex);
+	account(SchedulerClock::now());
+	this->budget = std::max(budget, 1);
+	this->changed.notify_all();
+}
+
+void Scheduler::account(SchedulerClock::time_point now) {
+	double seconds = std::chrono::duration<double>(now - this->lastChange).count();
+	this->busyTime += seconds * std::min(this->inUse, this->budget);
+	this->capacityTime += seconds * this->budget;
+	this->lastChange = now;
+}
+
+Scheduler::Lease Scheduler::acquire(int wanted, const std::function<bool()> &cancelled) {
+	std::unique_lock<std::mutex> lock(this->mutex);
+	SchedulerClock::time_point arrival = SchedulerClock::now();
+	long ticket = this->nextTicket++;
+	this->line.push_back(ticket);
+	bool waited = false;
+
+	while ((this->line.front() != ticket) || (this->inUse >= this->budget)) {
+		if (!waited) {
+			waited = true;
+			this->statistics.waited++;
+		}
+		this->statistics.peakWaiting = std::max(this->statistics.peakWaiting, (int)this->line.size());
+		if (cancelled && cancelled()) {
+			this->line.erase(std::find(this->line.begin(), this->line.end(), ticket));
+			this->changed.notify_all();
+			return Lease();
+		}
+		this->changed.wait_for(lock, std::chrono::milliseconds(POLL_INTERVAL));
+	}
+	this->line.pop_front();
+
+	SchedulerClock::time_point now = SchedulerClock::now();
+	account(now);
+	int threads = std::max(1, std::min(wanted, this->budget - this->inUse));
+	this->inUse += threads;
+
+	double wait = std::chrono::duration<double>(now - arrival).count();
+	this->statistics.leases++;
+	this->statistics.waitTime += wait;
+	this->statistics.maxWaitTime = std::max(this->statistics.maxWaitTime, wait);
+	this->statistics.peakInUse = std::max(this->statistics.peakInUse, this->inUse);
+
+	// the next one in line may fit into what is left
+	this->changed.notify_all();
+	return Lease(this, threads);
+}
+
+void Scheduler::giveBack(int threads) {
+	std::lock_guard<std::mutex> lock(this->mutex);
+	account(SchedulerClock::now());
+	this->inUse -= threads;
+	assert(this->inUse >= 0);
+	this->changed.notify_all();
+}
+
+Scheduler::Statistics Scheduler::getStatistics() {
+	std::lock_guard<std::mutex> lock(this->mutex);
+	account(SchedulerClock::now());
+	Statistics statistics = this->statistics;
+	statistics.budget = this->budget;
+	statistics.inUse = this->inUse;
+	statistics.waiting = this->line.size();
+	statistics.utilisation = this->capacityTime > 0 ? this->busyTime / this->capacityTime : 0;
+	return statistics;
+}
+
+} // namespace MIP
@@ -0,0 +1,109 @@
+/*
+ * Scheduler.h
+ *
+ * Sharing the threads of the process between the MIP solves that run at the same time.
+ */
+
+#ifndef SCHEDULER_H_
+#define SCHEDULER_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+namespace MIP {
+
+/**
+ * A budget of threads that all solves of the process share. Before a solve starts, it asks for
+ * a number of threads, and gets as many of them as are free (at least one). If none are free,
+ * it waits in line until a running solve gives its threads back. Threads are given back as
+ * soon as a solve is done, so those that start later get the threads of those that ended
+ * early.
+ *
+ * All functions may be called from several threads.
+ */
+class Scheduler {
+public:
+	typedef std::chrono::steady_clock SchedulerClock;
+
+	/**
+	 * Threads of the budget, given back when the lease is destroyed or released.
+	 */
+	class Lease {
+	public:
+		Lease() : scheduler(nullptr), threads(0) {}
+		Lease(Lease &&other);
+		Lease &operator=(Lease &&other);
+		~Lease();
+
+		void release();
+		/* 0 if the lease is empty, i.e., the wait was given up */
+		int getThreads() const { return this->threads; }
+
+	private:
+		friend class Scheduler;
+		Lease(Scheduler *scheduler, int threads) : scheduler(scheduler), threads(threads) {}
+
+		Scheduler *scheduler;
+		int threads;
+
+		Lease(const Lease &) = delete;
+		Lease &operator=(const Lease &) = delete;
+	};
+
+	struct Statistics {
+		int budget;
+		int inUse;
+		int peakInUse;
+		// the solves that are waiting now, and the most that ever waited at once
+		int waiting;
+		int peakWaiting;
+		// the leases handed out, and how many of them had to wait
+		long leases;
+		long waited;
+		// the total and the longest wait, in seconds
+		double waitTime;
+		double maxWaitTime;
+		// the share of the budget in use since the scheduler was created
+		double utilisation;
+	};
+
+	Scheduler(int budget);
+
+	/* The scheduler of the process, with a budget of num_threads (at least 1) */
+	static Scheduler &global();
+
+	/* Changes the budget, leases handed out before keep their threads */
+	void setBudget(int budget);
+
+	/* At most wanted threads (at least one), once it is their turn. Gives up and returns an
+	 * empty lease once cancelled() returns true, which is checked while waiting. */
+	Lease acquire(int wanted, const std::function<bool()> &cancelled = std::function<bool()>());
+
+	Statistics getStatistics();
+
+private:
+	void giveBack(int threads);
+	/* Adds the time since the last change at the threads in use to the busy time */
+	void account(SchedulerClock::time_point now);
+
+	std::mutex mutex;
+	std::condition_variable changed;
+
+	int budget;
+	int inUse;
+	// the tickets of the waiting solves, in the order they arrived
+	std::deque<long> line;
+	long nextTicket;
+
+	SchedulerClock::time_point lastChange;
+	double busyTime;
+	double capacityTime;
+	Statistics statistics;
+};
+
+} // namespace MIP
+
+#endif /* SCHEDULER_H_ */
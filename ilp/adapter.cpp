@@ -1,10 +1,46 @@
 #include "adapter.h"
+#include "Coarsening.h"
+#include "Components.h"
+#include "MIP.h"
+#include "RollingHorizon.h"
+#include "Scheduler.h"
 #include "config.h"
 
-#include <gurobi_c++.h>
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <thread>
+
+namespace {
+
+/* The total length of the intervals */
+double totalLength(const ILP::Intervals &intervals)
+{
+  double length = 0;
+  for (size_t i = 0; i + 1 < intervals.size(); i += 2) {
+    length += intervals[i + 1] - intervals[i];
+  }
+  return length;
+}
+
+/* The length from the first begin to the last end of the presence intervals of an instance */
+double span(const ILP::Instance *instance)
+{
+  double first = std::numeric_limits<double>::max();
+  double last = -std::numeric_limits<double>::max();
+  for (ILP::Intervals *presences : *(instance->intervalsOfLabels)) {
+    if (!presences->empty()) {
+      first = std::min(first, presences->front());
+      last = std::max(last, presences->back());
+    }
+  }
+  return last > first ? last - first : 0;
+}
+
+}
 
 ILPAdapter::ILPAdapter(Map *map, VisibilityIntervals &visibilityIntervals, ConflictIntervals &conflicts, Heuristic::ModelType mtype, int k, const char* dbg_filename)
-  : map(map), vi(visibilityIntervals), ci(conflicts), labelIntervals(nullptr), mtype(mtype), k(k), dbg_filename(dbg_filename)
+  : map(map), vi(visibilityIntervals), ci(conflicts), start(nullptr), mtype(mtype), chained(false), removedEvents(0), k(k), dbg_filename(dbg_filename), threads(0), solvedScore(0), failed(false)
 {}
 
 POI *
@@ -104,7 +140,13 @@ void ILPAdapter::makeConflicts()
 VisibilityIntervals *
 ILPAdapter::getLabelIntervals()
 {
-  return this->labelIntervals;
+  return this->getLabelIntervals(this->mtype);
+}
+
+VisibilityIntervals *
+ILPAdapter::getLabelIntervals(Heuristic::ModelType model)
+{
+  return this->solutions[model].labelIntervals;
 }
 
 void
@@ -118,87 +160,399 @@ ILPAdapter::determineMax()
   }
 }
 
+void ILPAdapter::setThreads(int threads) {
+  this->threads = threads;
+}
+
+void ILPAdapter::setStart(SelectionIntervals *selection) {
+  this->start = selection;
+}
+
+void ILPAdapter::setChained(bool chained) {
+  this->chained = chained;
+}
+
+void ILPAdapter::setKSweep(const std::vector<int> &ks) {
+  this->kSweep.clear();
+  for (int k : ks) {
+    this->kSweep.push_back(std::max(k, -1));
+  }
+  // no k-restriction is the largest one
+  auto looseness = [](int k) {
+    return k < 0 ? std::numeric_limits<int>::max() : k;
+  };
+  std::sort(this->kSweep.begin(), this->kSweep.end(), [&looseness](int a, int b) {
+    return looseness(a) > looseness(b);
+  });
+  this->kSweep.erase(std::unique(this->kSweep.begin(), this->kSweep.end()), this->kSweep.end());
+}
+
+SelectionIntervals *ILPAdapter::getLabelIntervalsForK(int k) {
+  auto solution = this->sweepSolutions.find(std::max(k, -1));
+  return solution != this->sweepSolutions.end() ? solution->second.labelIntervals : nullptr;
+}
+
+double ILPAdapter::getBoundForK(int k) {
+  auto solution = this->sweepSolutions.find(std::max(k, -1));
+  return solution != this->sweepSolutions.end() ? solution->second.resBound * this->normalization_max : -1;
+}
+
+double ILPAdapter::getGapForK(int k) {
+  auto solution = this->sweepSolutions.find(std::max(k, -1));
+  return solution != this->sweepSolutions.end() ? solution->second.gap : -1;
+}
+
+double ILPAdapter::getTimeForK(int k) {
+  auto solution = this->sweepSolutions.find(std::max(k, -1));
+  return solution != this->sweepSolutions.end() ? solution->second.time : -1;
+}
+
 double ILPAdapter::getBound() {
-  return this->resBound * this->normalization_max;
+  return this->getBound(this->mtype);
+}
+
+double ILPAdapter::getBound(Heuristic::ModelType model) {
+  return this->solutions[model].resBound * this->normalization_max;
 }
 
 double ILPAdapter::getGap() {
-  return this->gap;
+  return this->getGap(this->mtype);
+}
+
+double ILPAdapter::getGap(Heuristic::ModelType model) {
+  return this->solutions[model].gap;
+}
+
+int ILPAdapter::getRemovedEvents() {
+  return this->removedEvents;
+}
+
+double ILPAdapter::getTime(Heuristic::ModelType model) {
+  return this->solutions[model].time;
+}
+
+double ILPAdapter::solveTimeLeft() const {
+  double left = std::chrono::duration<double>(this->solveDeadline - std::chrono::steady_clock::now()).count();
+  return std::max(0.0, left);
+}
+
+void ILPAdapter::reportComponent(int component, double score, double bound) {
+  std::lock_guard<std::mutex> lock(this->componentMutex);
+  this->componentScores[component] = std::max(this->componentScores[component], score);
+  this->componentBounds[component] = std::min(this->componentBounds[component], bound);
+
+  double totalScore = this->solvedScore;
+  double totalBound = this->solvedScore;
+  for (size_t i = 0; i < this->componentScores.size(); ++i) {
+    totalScore += this->componentScores[i];
+    totalBound += this->componentBounds[i];
+  }
+  double progress = totalBound > 0 ? std::min(totalScore / totalBound, 1.0) : 0.0;
+  this->reportProgress(progress, totalScore * this->normalization_max);
+}
+
+bool ILPAdapter::stopComponents() const {
+  return this->failed || this->isCancelled();
 }
 
 void ILPAdapter::run()
 {
+  this->startRun();
+  Clock stageClock;
+  stageClock.start();
   this->determineMax();
   this->makeVisibilityIntervals();
   this->makeConflicts();
   this->instance.originalMax = this->normalization_max;
 
-  std::vector<ILP::Intervals> result;
-  Clock clock;
-  bool timeLimitExeeded;
-
-  if (this->labelIntervals != nullptr) {
-    delete this->labelIntervals;
-  }
-
-  try {
-    ILP::ILP ilp = ILP::ILP();
-    switch (this->mtype) {
-      case Heuristic::AM1:
-        timeLimitExeeded = ! ilp.execute(&(this->instance), ILP::AM1, result, this->resBound, this->gap, clock, this->k, this, this->dbg_filename);
-        break;
-      case Heuristic::AM2:
-        timeLimitExeeded = ! ilp.execute(&(this->instance), ILP::AM2, result, this->resBound, this->gap, clock, this->k, this, this->dbg_filename);
-        break;
-      case Heuristic::AM3:
-        timeLimitExeeded = ! ilp.execute(&(this->instance), ILP::AM3, result, this->resBound, this->gap, clock, this->k, this, this->dbg_filename);
-        break;
-    }
-  } catch (GRBException e) {
-    std::cout << "!!!! EXCEPTION IN ILP !!!!!\n";
-    std::cout << e.getMessage() << "\n";
-    std::cout << "Code: " << e.getErrorCode() << "\n";
-    switch (e.getErrorCode()) {
-      case 10001:
-        this->res = MEMORY;
-        break;
+  this->removedEvents = 0;
+  if (ILP_COARSENING > 0) {
+    this->removedEvents = ILP::coarsenInstance(&(this->instance), ILP_COARSENING / this->normalization_max);
+    std::cout << "Coarsening removed " << this->removedEvents << " events\n";
+  }
+
+  for (Solution &solution : this->solutions) {
+    if (solution.labelIntervals != nullptr) {
+      delete solution.labelIntervals;
     }
-    std::cout << "\n";
-    return;
-  } catch (char const *e) {
-    std::cout << "!!!! EXECPTION IN ILP !!!!!\n";
-    std::cout << e;
-    std::cout << "\n";
-    return;
+    solution = Solution();
+  }
+  for (auto &solution : this->sweepSolutions) {
+    if (solution.second.labelIntervals != nullptr) {
+      delete solution.second.labelIntervals;
+    }
+  }
+  this->sweepSolutions.clear();
+
+  ILP::ModelType modelType = ILP::AM1;
+  switch (this->mtype) {
+    case Heuristic::AM1:
+      modelType = ILP::AM1;
+      break;
+    case Heuristic::AM2:
+      modelType = ILP::AM2;
+      break;
+    case Heuristic::AM3:
+      modelType = ILP::AM3;
+      break;
   }
 
-  if (timeLimitExeeded) {
-    cerr << "Time Limit exeeded!\n";
-    this->res = TIME;
-  } else {
-    cerr << "Finished within time limit\n";
-    this->res = OK;
+  // the start solution, normalized like the instance, by label id
+  std::map<int, ILP::Intervals> startIntervals;
+  if (this->start != nullptr) {
+    for (auto intervalPOIpair : this->start->queryFullSorted(bgi::satisfies([](Interval const&){ return true; }))) {
+      auto id = this->poiToID.find(intervalPOIpair.second);
+      if (id == this->poiToID.end()) {
+        continue;
+      }
+      Interval interval = intervalPOIpair.first;
+      auto entry = startIntervals.insert(make_pair(id->second, ILP::Intervals(id->second))).first;
+      entry->second.add(bg::get<0>(interval.first) / this->normalization_max, bg::get<0>(interval.second) / this->normalization_max);
+    }
+  }
 
-    this->labelIntervals = new SelectionIntervals();
+  // A sweep builds its models for the smallest k, the others only change their right-hand side
+  bool sweeping = !this->kSweep.empty();
+  int buildK = sweeping ? this->kSweep.back() : this->k;
+
+  // The debug output always shows the model of the whole instance
+  std::vector<ILP::Instance *> components;
+  bool split = ILP_SPLIT_COMPONENTS && (buildK < 0) && (this->dbg_filename == nullptr);
+  if (split) {
+    ILP::findComponents(&(this->instance), components);
+  } else {
+    components.push_back(&(this->instance));
+  }
 
-    for (ILP::Intervals inIntervals : result) {
-      POI *poi = this->idToPOI[inIntervals.getId()];
-      auto posIt = inIntervals.begin();
-      while (posIt != inIntervals.end()) {
-        double start = *posIt++;
-        double end = *posIt++;
+  std::vector<ILP::Intervals> result;
+  std::vector<ILP::Instance *> pending;
+  this->solvedScore = 0;
+  for (ILP::Instance *component : components) {
+    if (split && (component->intervalsOfLabels->size() == 1)) {
+      ILP::solveSingleLabel(component, result);
+      this->solvedScore += totalLength(result.back());
+    } else {
+      pending.push_back(component);
+    }
+  }
+  std::stable_sort(pending.begin(), pending.end(), [](ILP::Instance *a, ILP::Instance *b) {
+    return a->intervalsOfLabels->size() > b->intervalsOfLabels->size();
+  });
+
+  // without chaining or a sweep, only the model of the adapter for its k
+  struct Stage {
+    ILP::ModelType model;
+    int k;
+  };
+  std::vector<Stage> stages;
+  if (sweeping) {
+    for (int k : this->kSweep) {
+      stages.push_back({modelType, k});
+    }
+  } else {
+    for (int model = this->chained ? ILP::AM1 : modelType; model <= modelType; ++model) {
+      stages.push_back({(ILP::ModelType)model, this->k});
+    }
+  }
 
-        #ifdef ENABLE_DEBUG
-        if (poi->getId() == DBG_POI_1) {
-          std::cout << "Selected Visibility for POI " << poi->getLabel() << ": " << start << " -> " << end << "\n";
+  // the models of a chain or a sweep are kept from one stage to the next
+  std::vector<std::unique_ptr<ILP::ILP>> ilps(pending.size());
+  std::vector<std::vector<ILP::Intervals>> results(pending.size());
+  std::vector<double> bounds(pending.size(), 0);
+  std::vector<double> gaps(pending.size(), 0);
+  std::vector<char> started(pending.size(), 0);
+  std::vector<char> finished(pending.size(), 0);
+
+  int total = this->threads > 0 ? this->threads : std::max(num_threads, 1);
+  int workers = std::max(1, std::min(total, (int)pending.size()));
+  // only components longer than the horizon are solved window by window, and the debug output
+  // always shows the model of the whole instance
+  std::vector<char> rolling(pending.size(), 0);
+  if ((ILP_HORIZON > 0) && (this->dbg_filename == nullptr)) {
+    for (size_t c = 0; c < pending.size(); ++c) {
+      rolling[c] = span(pending[c]) > ILP_HORIZON / this->normalization_max;
+    }
+  }
+  this->failed = false;
+
+  for (size_t stage = 0; stage < stages.size(); ++stage) {
+    ILP::ModelType stageType = stages[stage].model;
+    int stageK = stages[stage].k;
+    bool last = (stage + 1 == stages.size());
+    Solution &solution = sweeping ? this->sweepSolutions[stageK] : this->solutions[stageType];
+
+    // until a component is solved, all its presence intervals are its bound
+    for (size_t c = 0; c < pending.size(); ++c) {
+      results[c].clear();
+      bounds[c] = 0;
+      gaps[c] = 0;
+      started[c] = 0;
+      finished[c] = 0;
+      for (ILP::Intervals *presences : *(pending[c]->intervalsOfLabels)) {
+        bounds[c] += totalLength(*presences);
+      }
+    }
+    this->componentScores.assign(pending.size(), 0);
+    this->componentBounds = bounds;
+    this->solveDeadline = this->deadlineAfter(TIME_LIMIT);
+
+    std::atomic<size_t> next(0);
+    auto work = [&]() {
+      size_t c;
+      while (((c = next++) < pending.size()) && !this->stopComponents() && (this->solveTimeLeft() > 0)) {
+        // an even share of the threads among the components left, more if others are done
+        int share = std::max(1, total / std::min(workers, (int)(pending.size() - c)));
+        MIP::Scheduler::Lease lease = MIP::Scheduler::global().acquire(share, [this]() {
+          return this->stopComponents() || (this->solveTimeLeft() <= 0);
+        });
+        if (lease.getThreads() == 0) {
+          break;
+        }
+        started[c] = 1;
+        try {
+          Clock clock;
+          clock.start();
+          if (rolling[c]) {
+            // without a model that could be kept for the next stage
+            ILP::RollingHorizon horizon(ILP_HORIZON / this->normalization_max, lease.getThreads());
+            finished[c] = horizon.solve(pending[c], stageType, stageK, results[c], this, c);
+            double score = 0;
+            for (ILP::Intervals &intervals : results[c]) {
+              score += totalLength(intervals);
+            }
+            gaps[c] = score > 0 ? (bounds[c] - score) / score : (bounds[c] > 0 ? MIP::INFINITE : 0);
+          } else {
+            if (ilps[c]) {
+              ilps[c]->setThreads(lease.getThreads());
+              if (stageType != stages[stage - 1].model) {
+                ilps[c]->changeModel(stageType);
+              }
+              if (stageK != stages[stage - 1].k) {
+                ilps[c]->changeK(stageK);
+              }
+            } else {
+              ilps[c].reset(new ILP::ILP());
+              ilps[c]->setThreads(lease.getThreads());
+              if (!startIntervals.empty()) {
+                std::vector<ILP::Intervals> start;
+                for (ILP::Intervals *presences : *(pending[c]->intervalsOfLabels)) {
+                  auto entry = startIntervals.find(presences->getId());
+                  start.push_back(entry != startIntervals.end() ? entry->second : ILP::Intervals(presences->getId()));
+                }
+                ilps[c]->setStart(start);
+              }
+              ilps[c]->build(pending[c], stageType, buildK, this->dbg_filename);
+              if (stageK != buildK) {
+                ilps[c]->changeK(stageK);
+              }
+            }
+            finished[c] = ilps[c]->solve(results[c], bounds[c], gaps[c], clock, this, c);
+            if (last) {
+              ilps[c].reset();
+            }
+          }
+        } catch (MIP::Error &e) {
+          std::lock_guard<std::mutex> lock(this->componentMutex);
+          std::cout << "!!!! EXCEPTION IN ILP !!!!!\n";
+          std::cout << e.what() << "\n";
+          std::cout << "Code: " << e.getCode() << "\n";
+          if (e.isOutOfMemory()) {
+            solution.res = MEMORY;
+          }
+          std::cout << "\n";
+          this->failed = true;
+        } catch (char const *e) {
+          std::lock_guard<std::mutex> lock(this->componentMutex);
+          std::cout << "!!!! EXECPTION IN ILP !!!!!\n";
+          std::cout << e;
+          std::cout << "\n";
+          this->failed = true;
         }
-        #endif
-        
-        start *= this->normalization_max;
-        end *= this->normalization_max;
+      }
+    };
+
+    std::vector<std::thread> pool;
+    for (int i = 1; i < workers; ++i) {
+      pool.push_back(std::thread(work));
+    }
+    work();
+    for (std::thread &thread : pool) {
+      thread.join();
+    }
 
-        this->labelIntervals->insert(make_interval(start, end), poi);
+    if (this->failed) {
+      break;
+    }
+
+    // components that were not started count as stopped by the time limit
+    bool timeLimitExeeded = false;
+    std::vector<ILP::Intervals> stageResult = result;
+    double score = this->solvedScore;
+    solution.resBound = this->solvedScore;
+    for (size_t c = 0; c < pending.size(); ++c) {
+      timeLimitExeeded = timeLimitExeeded || !finished[c];
+      for (ILP::Intervals &intervals : results[c]) {
+        score += totalLength(intervals);
+        stageResult.push_back(intervals);
       }
+      solution.resBound += bounds[c];
+    }
+    if ((components.size() == 1) && (pending.size() == 1) && started[0]) {
+      solution.gap = gaps[0];
+    } else if (score > 0) {
+      solution.gap = (solution.resBound - score) / score;
+    } else {
+      solution.gap = solution.resBound > 0 ? MIP::INFINITE : 0;
+    }
+
+    if (timeLimitExeeded) {
+      cerr << "Time Limit exeeded!\n";
+      solution.res = TIME;
+    } else {
+      cerr << "Finished within time limit\n";
+      solution.res = OK;
+    }
+
+    // the best solution found so far, also if the time limit was reached
+    if (!stageResult.empty()) {
+      solution.labelIntervals = new SelectionIntervals();
+
+      for (ILP::Intervals inIntervals : stageResult) {
+        POI *poi = this->idToPOI[inIntervals.getId()];
+        auto posIt = inIntervals.begin();
+        while (posIt != inIntervals.end()) {
+          double start = *posIt++;
+          double end = *posIt++;
+
+          #ifdef ENABLE_DEBUG
+          if (poi->getId() == DBG_POI_1) {
+            std::cout << "Selected Visibility for POI " << poi->getLabel() << ": " << start << " -> " << end << "\n";
+          }
+          #endif
+
+          start *= this->normalization_max;
+          end *= this->normalization_max;
+
+          solution.labelIntervals->insert(make_interval(start, end), poi);
+        }
+      }
+    }
+
+    solution.time = stageClock.stop();
+    stageClock.start();
+  }
+
+  if (split) {
+    for (ILP::Instance *component : components) {
+      delete component;
     }
   }
+
+  MIP::Scheduler::Statistics statistics = MIP::Scheduler::global().getStatistics();
+  std::cout << "MIP threads: " << statistics.peakInUse << " of " << statistics.budget << " at most, "
+    << statistics.leases << " leases (" << statistics.waited << " waited, " << statistics.maxWaitTime << "s at most, "
+    << statistics.peakWaiting << " in line at most), " << (int)(100 * statistics.utilisation) << "% in use\n";
+
+  // records whether the deadline passed or the run was cancelled
+  this->shouldStop();
 }
@@ -3,31 +3,102 @@
 
 #include "ILP.h"
 
+#include <atomic>
 #include <map>
+#include <mutex>
 #include <set>
+#include <vector>
 
 #include "../util/setrtree.h"
 #include "../conflicts/camera.h"
 #include "../heuristics/heuristic.h"
 
 
-class ILPAdapter {
+namespace ILP {
+class ILP;
+class RollingHorizon;
+}
+
+/**
+ * Runs the ILP for the given model. A deadline (see Heuristic) shortens the time limit of
+ * the MIP solver (ILP_SOLVER), and a cancellation stops the optimization. In both cases, as well as when the
+ * time limit is reached, the best solution found so far is returned.
+ *
+ * Without a k-restriction, every connected component of the conflict graph is solved on its
+ * own (see ILP_SPLIT_COMPONENTS): single labels directly, the others by a pool of workers
+ * that run one ILP each, largest components first. Each ILP leases its threads from the
+ * global MIP::Scheduler, so the ones that start later get the threads of those that finished
+ * early, and all of them share the time limit. The bound and the gap are the ones of the
+ * combined solution.
+ *
+ * A chained adapter (see setChained()) solves AM1 up to its model one after the other. The
+ * instance and the models are only built once, the next model just changes the witness
+ * constraints (see ILP::ILP::changeModel()) and starts from the last solution. Each model gets
+ * the full time limit.
+ *
+ * A k sweep (see setKSweep()) likewise solves the model of the adapter for several k, with a
+ * model that is built once for the smallest one. It starts with the largest k and then
+ * tightens the k-restriction (see ILP::ILP::changeK()), starting each time from the last
+ * solution, repaired to fit the new k. Each k gets the full time limit.
+ *
+ * With ILP_COARSENING, the instance is coarsened (see ILP::coarsenInstance()) before it is
+ * split and solved. With ILP_HORIZON, components whose presence intervals span more than it are
+ * solved window by window (see ILP::RollingHorizon), which is not exact, so their bound is the
+ * trivial one. Shorter components are solved as a whole.
+ */
+class ILPAdapter : public Heuristic {
 public:
   enum Result { OK, MEMORY, TIME };
 
   ILPAdapter(Map *map, VisibilityIntervals &visibilityIntervals, ConflictIntervals &conflicts, Heuristic::ModelType mtype, int k = -1, const char *dbg_filename = nullptr);
   void run();
-  SelectionIntervals *getLabelIntervals();
+  virtual SelectionIntervals *getLabelIntervals();
+  /* Number of threads the MIP solver may use, num_threads if not positive. The ILPs of all
+   * adapters share the num_threads of MIP::Scheduler::global(). */
+  void setThreads(int threads);
+  /* A solution (e.g. of a heuristic) for the MIP solver to start from. It is not owned, and must stay
+   * valid until run() is done. */
+  void setStart(SelectionIntervals *selection);
+  /* Solve AM1 up to the model of the adapter in a chain, which run() does not do by default */
+  void setChained(bool chained);
+  /* Solve the model of the adapter for every k of ks (negative for none) instead of only
+   * for the k of the adapter. Not together with a chain. */
+  void setKSweep(const std::vector<int> &ks);
   POI *poiForId(int id);
   Result getResult();
   double getBound();
   double getGap();
 
+  // after a chained run(): the results of each model solved, and the seconds it took (for
+  // AM1, this includes building the instance)
+  SelectionIntervals *getLabelIntervals(Heuristic::ModelType model);
+  double getBound(Heuristic::ModelType model);
+  double getGap(Heuristic::ModelType model);
+  double getTime(Heuristic::ModelType model);
+
+  // after a run() with a k sweep: the results for each k, like the ones of a chain (the
+  // result is nullptr and the bound -1 for any other k)
+  SelectionIntervals *getLabelIntervalsForK(int k);
+  double getBoundForK(int k);
+  double getGapForK(int k);
+  double getTimeForK(int k);
+
+  // after run(): the number of events ILP_COARSENING removed
+  int getRemovedEvents();
+
 private:
+  friend class ILP::ILP;
+  friend class ILP::RollingHorizon;
+
   void determineMax();
   void makeVisibilityIntervals();
   void makeConflicts();
 
+  // for the ILP runs of the components, may be called from several threads
+  double solveTimeLeft() const;
+  void reportComponent(int component, double score, double bound);
+  bool stopComponents() const;
+
   double normalization_max;
 
   std::map<std::set<POI *>, int> conflictIDs;
@@ -40,17 +111,40 @@ private:
   VisibilityIntervals &vi;
   ConflictIntervals &ci;
 
-  SelectionIntervals *labelIntervals;
+  SelectionIntervals *start;
 
   Heuristic::ModelType mtype;
-
-  Result res;
-  double resBound;
-  double gap;
+  bool chained;
+
+  // the result of every model, by its type
+  struct Solution {
+    Solution() : labelIntervals(nullptr), res(OK), resBound(0), gap(0), time(0) {}
+
+    SelectionIntervals *labelIntervals;
+    Result res;
+    double resBound;
+    double gap;
+    double time;
+  };
+  Solution solutions[3];
+  // the k of a sweep, largest first, with the result of each
+  std::vector<int> kSweep;
+  std::map<int, Solution> sweepSolutions;
+  int removedEvents;
 
   const char *dbg_filename;
 
   int k;
+  int threads;
+
+  // Set up by run() for the ILP runs of the components: their common deadline, and the best
+  // (normalized) score and bound of each so far
+  Deadline solveDeadline;
+  std::mutex componentMutex;
+  double solvedScore;
+  std::vector<double> componentScores;
+  std::vector<double> componentBounds;
+  std::atomic<bool> failed;
 };
 
 #endif
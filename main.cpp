@@ -4,8 +4,13 @@
 #include "app.h"
 #include "cli/clirunner.h"
 #include "config.h"
+#include "heuristics/utils.h"
 
+#include <algorithm>
 #include <time.h>
+#include <sstream>
+#include <string>
+#include <vector>
 #include <QTimer>
 #include <QDebug>
 
@@ -19,7 +24,7 @@ option::ArgStatus ArgMandatory( const option::Option & option, bool) {
     return option::ARG_ILLEGAL;
 }
 
-enum  optionIndex { MAP, PYCGR, SEED, GUI, ITERATIONS, THREADS, GRAPH, OUTPUT, ILPOUT, INTERVALS, FIXSEED, KRESTRICT, SCREENSHOT, SCREENSHOTPOS, SCREENSHOTHEU, SCREENSHOTMODEL, SCREENSHOTK, HELP};
+enum  optionIndex { MAP, PYCGR, SEED, GUI, ITERATIONS, THREADS, GRAPH, OUTPUT, ILPOUT, INTERVALS, FIXSEED, KRESTRICT, KSWEEP, PLSTIME, LSTIME, EXACT, GREEDYBUDGET, IGBUDGET, ILPBUDGET, ILPDENSE, ILPCOLD, ILPCHAIN, ILPKSWEEP, ILPCOARSEN, ILPLAZY, ILPHORIZON, MIPSOLVER, PORTFOLIO, SCREENSHOT, SCREENSHOTPOS, SCREENSHOTHEU, SCREENSHOTMODEL, SCREENSHOTK, BENCHMARKMWIS, HELP};
 const option::Descriptor usage[] =
 {
  {MAP, 0,"m" , "map"    ,ArgMandatory, "Set the OSM map file\n" },
@@ -27,6 +32,7 @@ const option::Descriptor usage[] =
  {OUTPUT, 0,"o" , "out"    ,ArgMandatory, "Output file\n" },
  {SEED,    0,"s" , "seed",ArgMandatory, "Set the seed. YOU SHOULD ALWAYS DO THIS!\n" },
  {KRESTRICT,    0,"k" , "k-restriction",ArgMandatory, "Set the k restriction value\n" },
+ {KSWEEP,    0,"w" , "k-sweep",ArgMandatory, "Report the interval graph heuristic for several k values (comma separated, or 'all') from a single run\n" },
  {GRAPH, 0,"g" , "graph"    ,ArgMandatory, "Set the graph output file\n" },
  {ILPOUT, 0,"d" , "ilpout"    ,ArgMandatory, "Set the ILP output file\n" },
  {INTERVALS, 0,"v" , "intervals"    ,ArgMandatory, "Set the intervals output file prefix\n" },
@@ -35,6 +41,21 @@ const option::Descriptor usage[] =
  {FIXSEED,    0,"f" , "fixseed",option::Arg::None, "Fix to only one seed\n" },
 
  {THREADS,    0,"t" , "threads",ArgMandatory, "Set the number of threads\n" },
+ {PLSTIME,    0,"" , "pls",ArgMandatory, "Run the phased local search with this time limit (in seconds) per model\n" },
+ {LSTIME,    0,"" , "ls",ArgMandatory, "Improve the greedy and interval graph results by local search, with this time limit (in seconds) per result\n" },
+ {EXACT,    0,"" , "exact",option::Arg::None, "Also solve the AM1, AM2 and AM3 conflict graphs with the built-in branch and reduce solver\n" },
+ {GREEDYBUDGET,    0,"" , "greedy-budget",ArgMandatory, "Stop every greedy heuristic run after this many seconds, keeping its solution so far\n" },
+ {IGBUDGET,    0,"" , "ig-budget",ArgMandatory, "Stop every interval graph heuristic run after this many seconds, keeping the rounds done so far\n" },
+ {ILPBUDGET,    0,"" , "ilp-budget",ArgMandatory, "Stop every ILP run after this many seconds (at most the configured time limit), keeping its incumbent\n" },
+ {ILPDENSE,    0,"" , "ilp-dense",option::Arg::None, "Use the dense ILP formulation with variables for every label and atomic segment (same optimum, for cross-checking)\n" },
+ {ILPCOLD,    0,"" , "ilp-cold",option::Arg::None, "Do not start the ILP from the best heuristic result\n" },
+ {ILPCHAIN,    0,"" , "ilp-chain",option::Arg::None, "Solve the ILPs of AM1, AM2 and AM3 on one model, each starting from the previous optimum\n" },
+ {ILPKSWEEP,    0,"" , "ilp-k-sweep",option::Arg::None, "With --k-sweep, also solve the ILPs for every k value, on one model per AM that only changes its k restriction\n" },
+ {ILPCOARSEN,    0,"" , "ilp-coarsen",ArgMandatory, "Snap ILP interval endpoints closer than this onto common events, shrinking labels and growing conflicts\n" },
+ {ILPLAZY,    0,"" , "ilp-lazy",ArgMandatory, "Leave the ILP conflict constraints out until a solution violates them (1: one at a time, 2: all violated, 3: also at the root relaxation; Gurobi only)\n" },
+ {ILPHORIZON,    0,"" , "ilp-horizon",ArgMandatory, "Solve the ILP in overlapping windows of this length one after the other, for routes too long for a single model\n" },
+ {MIPSOLVER,    0,"" , "mip-solver",ArgMandatory, "Solve the ILPs with this MIP solver (gurobi or highs, depending on the build)\n" },
+ {PORTFOLIO,    0,"" , "portfolio",ArgMandatory, "Also run all solvers at the same time with this time limit (in seconds) per model, stopping early once the best solution is proven optimal\n" },
  {ITERATIONS,    0,"i" , "iterations",ArgMandatory, "Set the number of iterations\n" },
 
  {SCREENSHOT, 0, "", "screenshot"    ,ArgMandatory, "Go into screenshot mode, set screenshot output file\n" },
@@ -43,6 +64,7 @@ const option::Descriptor usage[] =
  {SCREENSHOTPOS, 0, "", "screenshot-position"    ,ArgMandatory, "set screenshot position\n" },
  {SCREENSHOTK, 0, "", "screenshot-k"    ,ArgMandatory, "set screenshot k\n" },
 
+ {BENCHMARKMWIS,    0,"" , "benchmark-mwis",option::Arg::None, "Compare the running times of the interval graph MWIS kernels and exit, no map needed\n" },
  {HELP,    0,"h" , "help",option::Arg::None, "print this help\n" },
 
  {0,0,0,0,0,0}
@@ -69,6 +91,11 @@ int main(int argc, char *argv[])
     return 0;
   }
 
+  if (options[BENCHMARKMWIS].count() > 0) {
+    benchmarkMWIS();
+    return 0;
+  }
+
 
   if (options[MAP].count() != 1) {
     std::cout << "You must specify a map.\n";
@@ -81,6 +108,31 @@ int main(int argc, char *argv[])
     num_threads = std::atoi(options[THREADS].arg);
   }
 
+  if (options[ILPDENSE].count() > 0) {
+    ILP_SPARSE = false;
+  }
+  if (options[ILPCOLD].count() > 0) {
+    ILP_WARM_START = false;
+  }
+  if (options[ILPCHAIN].count() > 0) {
+    ILP_CHAIN = true;
+  }
+  if (options[ILPKSWEEP].count() > 0) {
+    ILP_K_SWEEP = true;
+  }
+  if (options[ILPCOARSEN].count() > 0) {
+    ILP_COARSENING = std::atof(options[ILPCOARSEN].arg);
+  }
+  if (options[ILPLAZY].count() > 0) {
+    ILP_LAZY_CONFLICTS = std::max(0, std::min(3, std::atoi(options[ILPLAZY].arg)));
+  }
+  if (options[ILPHORIZON].count() > 0) {
+    ILP_HORIZON = std::atof(options[ILPHORIZON].arg);
+  }
+  if (options[MIPSOLVER].count() > 0) {
+    ILP_SOLVER = options[MIPSOLVER].arg;
+  }
+
 
   MapReader mapreader(options[MAP].arg, options[PYCGR].arg);
   mapreader.run();
@@ -98,6 +150,23 @@ int main(int argc, char *argv[])
     k = std::atoi(options[KRESTRICT].arg);
   }
 
+  std::vector<int> kSweep;
+  bool kSweepAll = false;
+  if (options[KSWEEP].count() > 0) {
+    std::string sweep(options[KSWEEP].arg);
+    if (sweep == "all") {
+      kSweepAll = true;
+    } else {
+      std::istringstream sweepStream(sweep);
+      std::string value;
+      while (std::getline(sweepStream, value, ',')) {
+        if (!value.empty()) {
+          kSweep.push_back(std::atoi(value.c_str()));
+        }
+      }
+    }
+  }
+
   std::map<std::string, std::set<std::string>> filter = POI_DEFAULT;
   map->set_poi_filter(filter);
 
@@ -197,7 +266,38 @@ int main(int argc, char *argv[])
         fixseed = true;
       }
 
-      CLIRunner *cli = new CLIRunner(map, seed, iterations, graphOutFile, outputFile, ilpOutputFile, intervalsOutputFile, fixseed, k);
+      double plsTimeLimit = 0;
+      if (options[PLSTIME].count() > 0) {
+        plsTimeLimit = std::atof(options[PLSTIME].arg);
+      }
+
+      double lsTimeLimit = 0;
+      if (options[LSTIME].count() > 0) {
+        lsTimeLimit = std::atof(options[LSTIME].arg);
+      }
+
+      bool exact = false;
+      if (options[EXACT].count() > 0) {
+        exact = true;
+      }
+
+      SolverBudgets budgets;
+      if (options[GREEDYBUDGET].count() > 0) {
+        budgets.greedy = std::atof(options[GREEDYBUDGET].arg);
+      }
+      if (options[IGBUDGET].count() > 0) {
+        budgets.ig = std::atof(options[IGBUDGET].arg);
+      }
+      if (options[ILPBUDGET].count() > 0) {
+        budgets.ilp = std::atof(options[ILPBUDGET].arg);
+      }
+
+      double portfolioTimeLimit = 0;
+      if (options[PORTFOLIO].count() > 0) {
+        portfolioTimeLimit = std::atof(options[PORTFOLIO].arg);
+      }
+
+      CLIRunner *cli = new CLIRunner(map, seed, iterations, graphOutFile, outputFile, ilpOutputFile, intervalsOutputFile, fixseed, k, kSweep, kSweepAll, plsTimeLimit, lsTimeLimit, exact, budgets, portfolioTimeLimit);
       cli->run();
       /*
       QObject::connect(cli, SIGNAL(finished()), &a, SLOT(quit()));
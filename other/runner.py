@@ -20,6 +20,10 @@ ERROR_OUT_DIR="/tmp/out/errors"
 ILP_THREADS=1
 PARALLELISM=2
 
+# Run every seed once for all K (--k-sweep with --ilp-k-sweep, see <out>-ksweep.csv) instead of
+# once per K. The main results file is then computed for the first K.
+SWEEP_K=False
+
 PREFIX="instance"
 
 q = Queue()
@@ -27,7 +31,10 @@ q = Queue()
 timings = []
 
 def generate_filename(cfg):
-    return PREFIX + "-" + os.path.basename(cfg['map'])[:-4] + "-seed_" + str(cfg['seed']) + "-k" + str(cfg["K"])
+    name = PREFIX + "-" + os.path.basename(cfg['map'])[:-4] + "-seed_" + str(cfg['seed']) + "-k" + str(cfg["K"])
+    if 'sweep' in cfg:
+        name += "-ksweep"
+    return name
 
 def worker(thread_id):
     global q
@@ -46,10 +53,14 @@ def worker(thread_id):
         graph_path = os.path.join(GRAPH_OUT_DIR, fname) + ".graphml"
         interval_path = os.path.join(INTERVAL_OUT_DIR, fname) + ".csv"
 
+        args = [BINARY, "--cli", "-f", "-s", str(cfg['seed']), "-m", str(cfg['map']), "-p", str(cfg['pmap']), "-t", str(ILP_THREADS), "-o", out_path, "-g", graph_path, "-v", interval_path, "-i", "1", "-k", str(cfg['K'])]
+        if 'sweep' in cfg:
+            args += ["-w", cfg['sweep'], "--ilp-k-sweep"]
+
         start_time = time.perf_counter()
         success = True
         try:
-            p = subprocess.check_output([BINARY, "--cli", "-f", "-s", str(cfg['seed']), "-m", str(cfg['map']), "-p", str(cfg['pmap']), "-t", str(ILP_THREADS), "-o", out_path, "-g", graph_path, "-v", interval_path, "-i", "1", "-k", str(cfg['K'])], stderr=subprocess.STDOUT, universal_newlines=True)
+            p = subprocess.check_output(args, stderr=subprocess.STDOUT, universal_newlines=True)
         except subprocess.CalledProcessError as e:
             p = e.output
             success = False
@@ -79,6 +90,10 @@ with open(sys.argv[1], 'r') as seedfile:
         seeds = seeds[7:]
 
         for (mapfile, pmapfile) in CONFIG['MAP']:
+            if SWEEP_K:
+                for seed in subseeds:
+                    q.put({'K': CONFIG['K'][0], 'sweep': ",".join(str(k) for k in CONFIG['K']), 'map': mapfile, 'pmap': pmapfile, 'seed': seed})
+                continue
             for k in CONFIG['K']:
                 for seed in subseeds:
                     q.put({'K': k, 'map': mapfile, 'pmap': pmapfile, 'seed': seed})
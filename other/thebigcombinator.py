@@ -3,9 +3,15 @@ import csv
 
 DESC = {
     5: ["FILE-VERSION","K","SEED","ILP AM1 SCORE","ILP AM2 SCORE","ILP AM3 SCORE","ILP AM1 TIME","ILP AM2 TIME","ILP AM3 TIME","GREEDY AM1 SCORE","GREEDY AM2 SCORE","GREEDY AM3 SCORE","GREEDY AM1 TIME","GREEDY AM2 TIME","GREEDY AM3 TIME","INTGRAPH AM1 SCORE","INTGRAPH AM2 SCORE","INTGRAPH AM3 SCORE","INTGRAPH AM1 TIME","INTGRAPH AM2 TIME","INTGRAPH AM3 TIME","ROTATIONAL CONFLICT TIME","ZOOMING CONFLICT TIME","PATH CREATION TIME","INTERPOLATION TIME","GRAPH AM1 TIME","GRAPH AM2 TIME","GRAPH AM3 TIME","NUMBER OF CONFLICTS","NUMBER OF VISIBILITIES","TRAJECTORY LENGTH","TRAJECTORY SIZE","VISIBILITIES LENGTH","CONFLICTS LENGTH","AM1 GRAPH NODES","AM1 GRAPH EDGES","AM2 GRAPH NODES","AM2 GRAPH EDGES","AM3 GRAPH NODES","AM3 GRAPH EDGES"],
-    6: ["FILE-VERSION","K","SEED","ILP AM1 SCORE","ILP AM2 SCORE","ILP AM3 SCORE","ILP AM1 BOUND","ILP AM2 BOUND","ILP AM3 BOUND","ILP AM1 GAP","ILP AM2 GAP","ILP AM3 GAP","ILP AM1 TIME","ILP AM2 TIME","ILP AM3 TIME","GREEDY AM1 SCORE","GREEDY AM2 SCORE","GREEDY AM3 SCORE","GREEDY AM1 TIME","GREEDY AM2 TIME","GREEDY AM3 TIME","INTGRAPH AM1 SCORE","INTGRAPH AM2 SCORE","INTGRAPH AM3 SCORE","INTGRAPH AM1 TIME","INTGRAPH AM2 TIME","INTGRAPH AM3 TIME","ROTATIONAL CONFLICT TIME","ZOOMING CONFLICT TIME","PATH CREATION TIME","INTERPOLATION TIME","GRAPH AM1 TIME","GRAPH AM2 TIME","GRAPH AM3 TIME","NUMBER OF CONFLICTS","NUMBER OF VISIBILITIES","TRAJECTORY LENGTH","TRAJECTORY SIZE","VISIBILITIES LENGTH","CONFLICTS LENGTH","AM1 GRAPH NODES","AM1 GRAPH EDGES","AM2 GRAPH NODES","AM2 GRAPH EDGES","AM3 GRAPH NODES","AM3 GRAPH EDGES"]
+    6: ["FILE-VERSION","K","SEED","ILP AM1 SCORE","ILP AM2 SCORE","ILP AM3 SCORE","ILP AM1 BOUND","ILP AM2 BOUND","ILP AM3 BOUND","ILP AM1 GAP","ILP AM2 GAP","ILP AM3 GAP","ILP AM1 TIME","ILP AM2 TIME","ILP AM3 TIME","GREEDY AM1 SCORE","GREEDY AM2 SCORE","GREEDY AM3 SCORE","GREEDY AM1 TIME","GREEDY AM2 TIME","GREEDY AM3 TIME","INTGRAPH AM1 SCORE","INTGRAPH AM2 SCORE","INTGRAPH AM3 SCORE","INTGRAPH AM1 TIME","INTGRAPH AM2 TIME","INTGRAPH AM3 TIME","ROTATIONAL CONFLICT TIME","ZOOMING CONFLICT TIME","PATH CREATION TIME","INTERPOLATION TIME","GRAPH AM1 TIME","GRAPH AM2 TIME","GRAPH AM3 TIME","NUMBER OF CONFLICTS","NUMBER OF VISIBILITIES","TRAJECTORY LENGTH","TRAJECTORY SIZE","VISIBILITIES LENGTH","CONFLICTS LENGTH","AM1 GRAPH NODES","AM1 GRAPH EDGES","AM2 GRAPH NODES","AM2 GRAPH EDGES","AM3 GRAPH NODES","AM3 GRAPH EDGES"],
+    7: ["FILE-VERSION","K","SEED","ILP AM1 SCORE","ILP AM2 SCORE","ILP AM3 SCORE","ILP AM1 BOUND","ILP AM2 BOUND","ILP AM3 BOUND","ILP AM1 GAP","ILP AM2 GAP","ILP AM3 GAP","ILP AM1 TIME","ILP AM2 TIME","ILP AM3 TIME","GREEDY AM1 SCORE","GREEDY AM1 COMPOUND SCORE","GREEDY AM2 SCORE","GREEDY AM3 SCORE","GREEDY AM1 TIME","GREEDY AM1 COMPOUND TIME","GREEDY AM2 TIME","GREEDY AM3 TIME","INTGRAPH AM1 SCORE","INTGRAPH AM2 SCORE","INTGRAPH AM3 SCORE","INTGRAPH AM1 TIME","INTGRAPH AM2 TIME","INTGRAPH AM3 TIME","CLIQUE AM1 BOUND","CLIQUE AM2 BOUND","CLIQUE AM3 BOUND","CLIQUE AM1 TIME","CLIQUE AM2 TIME","CLIQUE AM3 TIME","LAGRANGIAN AM1 BOUND","LAGRANGIAN AM2 BOUND","LAGRANGIAN AM3 BOUND","LAGRANGIAN AM1 TIME","LAGRANGIAN AM2 TIME","LAGRANGIAN AM3 TIME","ROTATIONAL CONFLICT TIME","ZOOMING CONFLICT TIME","PATH CREATION TIME","INTERPOLATION TIME","GRAPH AM1 TIME","GRAPH AM2 TIME","GRAPH AM3 TIME","NUMBER OF CONFLICTS","NUMBER OF VISIBILITIES","TRAJECTORY LENGTH","TRAJECTORY SIZE","VISIBILITIES LENGTH","CONFLICTS LENGTH","AM1 GRAPH NODES","AM1 GRAPH EDGES","AM2 GRAPH NODES","AM2 GRAPH EDGES","AM3 GRAPH NODES","AM3 GRAPH EDGES"],
+    8: ["FILE-VERSION","K","SEED","ILP AM1 SCORE","ILP AM2 SCORE","ILP AM3 SCORE","ILP AM1 BOUND","ILP AM2 BOUND","ILP AM3 BOUND","ILP AM1 GAP","ILP AM2 GAP","ILP AM3 GAP","ILP AM1 TIME","ILP AM2 TIME","ILP AM3 TIME","GREEDY AM1 SCORE","GREEDY AM1 COMPOUND SCORE","GREEDY AM2 SCORE","GREEDY AM3 SCORE","GREEDY AM1 TIME","GREEDY AM1 COMPOUND TIME","GREEDY AM2 TIME","GREEDY AM3 TIME","INTGRAPH AM1 SCORE","INTGRAPH AM2 SCORE","INTGRAPH AM3 SCORE","INTGRAPH AM1 TIME","INTGRAPH AM2 TIME","INTGRAPH AM3 TIME","PLS AM1 SCORE","PLS AM2 SCORE","PLS AM3 SCORE","PLS AM1 TIME","PLS AM2 TIME","PLS AM3 TIME","CLIQUE AM1 BOUND","CLIQUE AM2 BOUND","CLIQUE AM3 BOUND","CLIQUE AM1 TIME","CLIQUE AM2 TIME","CLIQUE AM3 TIME","LAGRANGIAN AM1 BOUND","LAGRANGIAN AM2 BOUND","LAGRANGIAN AM3 BOUND","LAGRANGIAN AM1 TIME","LAGRANGIAN AM2 TIME","LAGRANGIAN AM3 TIME","ROTATIONAL CONFLICT TIME","ZOOMING CONFLICT TIME","PATH CREATION TIME","INTERPOLATION TIME","GRAPH AM1 TIME","GRAPH AM2 TIME","GRAPH AM3 TIME","NUMBER OF CONFLICTS","NUMBER OF VISIBILITIES","TRAJECTORY LENGTH","TRAJECTORY SIZE","VISIBILITIES LENGTH","CONFLICTS LENGTH","AM1 GRAPH NODES","AM1 GRAPH EDGES","AM2 GRAPH NODES","AM2 GRAPH EDGES","AM3 GRAPH NODES","AM3 GRAPH EDGES"],
+    9: ["FILE-VERSION","K","SEED","ILP AM1 SCORE","ILP AM2 SCORE","ILP AM3 SCORE","ILP AM1 BOUND","ILP AM2 BOUND","ILP AM3 BOUND","ILP AM1 GAP","ILP AM2 GAP","ILP AM3 GAP","ILP AM1 TIME","ILP AM2 TIME","ILP AM3 TIME","GREEDY AM1 SCORE","GREEDY AM1 COMPOUND SCORE","GREEDY AM2 SCORE","GREEDY AM3 SCORE","GREEDY AM1 TIME","GREEDY AM1 COMPOUND TIME","GREEDY AM2 TIME","GREEDY AM3 TIME","INTGRAPH AM1 SCORE","INTGRAPH AM2 SCORE","INTGRAPH AM3 SCORE","INTGRAPH AM1 TIME","INTGRAPH AM2 TIME","INTGRAPH AM3 TIME","LS GREEDY AM1 SCORE","LS GREEDY AM2 SCORE","LS GREEDY AM3 SCORE","LS INTGRAPH AM1 SCORE","LS INTGRAPH AM2 SCORE","LS INTGRAPH AM3 SCORE","LS GREEDY AM1 TIME","LS GREEDY AM2 TIME","LS GREEDY AM3 TIME","LS INTGRAPH AM1 TIME","LS INTGRAPH AM2 TIME","LS INTGRAPH AM3 TIME","PLS AM1 SCORE","PLS AM2 SCORE","PLS AM3 SCORE","PLS AM1 TIME","PLS AM2 TIME","PLS AM3 TIME","CLIQUE AM1 BOUND","CLIQUE AM2 BOUND","CLIQUE AM3 BOUND","CLIQUE AM1 TIME","CLIQUE AM2 TIME","CLIQUE AM3 TIME","LAGRANGIAN AM1 BOUND","LAGRANGIAN AM2 BOUND","LAGRANGIAN AM3 BOUND","LAGRANGIAN AM1 TIME","LAGRANGIAN AM2 TIME","LAGRANGIAN AM3 TIME","ROTATIONAL CONFLICT TIME","ZOOMING CONFLICT TIME","PATH CREATION TIME","INTERPOLATION TIME","GRAPH AM1 TIME","GRAPH AM2 TIME","GRAPH AM3 TIME","NUMBER OF CONFLICTS","NUMBER OF VISIBILITIES","TRAJECTORY LENGTH","TRAJECTORY SIZE","VISIBILITIES LENGTH","CONFLICTS LENGTH","AM1 GRAPH NODES","AM1 GRAPH EDGES","AM2 GRAPH NODES","AM2 GRAPH EDGES","AM3 GRAPH NODES","AM3 GRAPH EDGES"],
+    10: ["FILE-VERSION","K","SEED","ILP AM1 SCORE","ILP AM2 SCORE","ILP AM3 SCORE","ILP AM1 BOUND","ILP AM2 BOUND","ILP AM3 BOUND","ILP AM1 GAP","ILP AM2 GAP","ILP AM3 GAP","ILP AM1 TIME","ILP AM2 TIME","ILP AM3 TIME","EXACT AM1 SCORE","EXACT AM2 SCORE","EXACT AM3 SCORE","EXACT AM1 BOUND","EXACT AM2 BOUND","EXACT AM3 BOUND","EXACT AM1 TIME","EXACT AM2 TIME","EXACT AM3 TIME","GREEDY AM1 SCORE","GREEDY AM1 COMPOUND SCORE","GREEDY AM2 SCORE","GREEDY AM3 SCORE","GREEDY AM1 TIME","GREEDY AM1 COMPOUND TIME","GREEDY AM2 TIME","GREEDY AM3 TIME","INTGRAPH AM1 SCORE","INTGRAPH AM2 SCORE","INTGRAPH AM3 SCORE","INTGRAPH AM1 TIME","INTGRAPH AM2 TIME","INTGRAPH AM3 TIME","LS GREEDY AM1 SCORE","LS GREEDY AM2 SCORE","LS GREEDY AM3 SCORE","LS INTGRAPH AM1 SCORE","LS INTGRAPH AM2 SCORE","LS INTGRAPH AM3 SCORE","LS GREEDY AM1 TIME","LS GREEDY AM2 TIME","LS GREEDY AM3 TIME","LS INTGRAPH AM1 TIME","LS INTGRAPH AM2 TIME","LS INTGRAPH AM3 TIME","PLS AM1 SCORE","PLS AM2 SCORE","PLS AM3 SCORE","PLS AM1 TIME","PLS AM2 TIME","PLS AM3 TIME","CLIQUE AM1 BOUND","CLIQUE AM2 BOUND","CLIQUE AM3 BOUND","CLIQUE AM1 TIME","CLIQUE AM2 TIME","CLIQUE AM3 TIME","LAGRANGIAN AM1 BOUND","LAGRANGIAN AM2 BOUND","LAGRANGIAN AM3 BOUND","LAGRANGIAN AM1 TIME","LAGRANGIAN AM2 TIME","LAGRANGIAN AM3 TIME","ROTATIONAL CONFLICT TIME","ZOOMING CONFLICT TIME","PATH CREATION TIME","INTERPOLATION TIME","GRAPH AM1 TIME","GRAPH AM2 TIME","GRAPH AM3 TIME","NUMBER OF CONFLICTS","NUMBER OF VISIBILITIES","TRAJECTORY LENGTH","TRAJECTORY SIZE","VISIBILITIES LENGTH","CONFLICTS LENGTH","AM1 GRAPH NODES","AM1 GRAPH EDGES","AM2 GRAPH NODES","AM2 GRAPH EDGES","AM3 GRAPH NODES","AM3 GRAPH EDGES"],
+    11: ["FILE-VERSION","K","SEED","ILP AM1 SCORE","ILP AM2 SCORE","ILP AM3 SCORE","ILP AM1 BOUND","ILP AM2 BOUND","ILP AM3 BOUND","ILP AM1 GAP","ILP AM2 GAP","ILP AM3 GAP","ILP AM1 TIME","ILP AM2 TIME","ILP AM3 TIME","EXACT AM1 SCORE","EXACT AM2 SCORE","EXACT AM3 SCORE","EXACT AM1 BOUND","EXACT AM2 BOUND","EXACT AM3 BOUND","EXACT AM1 TIME","EXACT AM2 TIME","EXACT AM3 TIME","GREEDY AM1 SCORE","GREEDY AM1 COMPOUND SCORE","GREEDY AM2 SCORE","GREEDY AM3 SCORE","GREEDY AM1 TIME","GREEDY AM1 COMPOUND TIME","GREEDY AM2 TIME","GREEDY AM3 TIME","INTGRAPH AM1 SCORE","INTGRAPH AM2 SCORE","INTGRAPH AM3 SCORE","INTGRAPH AM1 TIME","INTGRAPH AM2 TIME","INTGRAPH AM3 TIME","LS GREEDY AM1 SCORE","LS GREEDY AM2 SCORE","LS GREEDY AM3 SCORE","LS INTGRAPH AM1 SCORE","LS INTGRAPH AM2 SCORE","LS INTGRAPH AM3 SCORE","LS GREEDY AM1 TIME","LS GREEDY AM2 TIME","LS GREEDY AM3 TIME","LS INTGRAPH AM1 TIME","LS INTGRAPH AM2 TIME","LS INTGRAPH AM3 TIME","PLS AM1 SCORE","PLS AM2 SCORE","PLS AM3 SCORE","PLS AM1 TIME","PLS AM2 TIME","PLS AM3 TIME","CLIQUE AM1 BOUND","CLIQUE AM2 BOUND","CLIQUE AM3 BOUND","CLIQUE AM1 TIME","CLIQUE AM2 TIME","CLIQUE AM3 TIME","LAGRANGIAN AM1 BOUND","LAGRANGIAN AM2 BOUND","LAGRANGIAN AM3 BOUND","LAGRANGIAN AM1 TIME","LAGRANGIAN AM2 TIME","LAGRANGIAN AM3 TIME","PORTFOLIO AM1 SCORE","PORTFOLIO AM2 SCORE","PORTFOLIO AM3 SCORE","PORTFOLIO AM1 BOUND","PORTFOLIO AM2 BOUND","PORTFOLIO AM3 BOUND","PORTFOLIO AM1 WINNER","PORTFOLIO AM2 WINNER","PORTFOLIO AM3 WINNER","PORTFOLIO AM1 WIN TIME","PORTFOLIO AM2 WIN TIME","PORTFOLIO AM3 WIN TIME","PORTFOLIO AM1 TIME","PORTFOLIO AM2 TIME","PORTFOLIO AM3 TIME","ROTATIONAL CONFLICT TIME","ZOOMING CONFLICT TIME","PATH CREATION TIME","INTERPOLATION TIME","GRAPH AM1 TIME","GRAPH AM2 TIME","GRAPH AM3 TIME","NUMBER OF CONFLICTS","NUMBER OF VISIBILITIES","TRAJECTORY LENGTH","TRAJECTORY SIZE","VISIBILITIES LENGTH","CONFLICTS LENGTH","AM1 GRAPH NODES","AM1 GRAPH EDGES","AM2 GRAPH NODES","AM2 GRAPH EDGES","AM3 GRAPH NODES","AM3 GRAPH EDGES"],
+    12: ["FILE-VERSION","K","SEED","ILP AM1 SCORE","ILP AM2 SCORE","ILP AM3 SCORE","ILP AM1 BOUND","ILP AM2 BOUND","ILP AM3 BOUND","ILP AM1 GAP","ILP AM2 GAP","ILP AM3 GAP","ILP AM1 TIME","ILP AM2 TIME","ILP AM3 TIME","EXACT AM1 SCORE","EXACT AM2 SCORE","EXACT AM3 SCORE","EXACT AM1 BOUND","EXACT AM2 BOUND","EXACT AM3 BOUND","EXACT AM1 TIME","EXACT AM2 TIME","EXACT AM3 TIME","GREEDY AM1 SCORE","GREEDY AM1 COMPOUND SCORE","GREEDY AM2 SCORE","GREEDY AM3 SCORE","GREEDY AM1 TIME","GREEDY AM1 COMPOUND TIME","GREEDY AM2 TIME","GREEDY AM3 TIME","PARALLEL GREEDY AM1 SCORE","PARALLEL GREEDY AM1 COMPOUND SCORE","PARALLEL GREEDY AM2 SCORE","PARALLEL GREEDY AM3 SCORE","PARALLEL GREEDY AM1 TIME","PARALLEL GREEDY AM1 COMPOUND TIME","PARALLEL GREEDY AM2 TIME","PARALLEL GREEDY AM3 TIME","INTGRAPH AM1 SCORE","INTGRAPH AM2 SCORE","INTGRAPH AM3 SCORE","INTGRAPH AM1 TIME","INTGRAPH AM2 TIME","INTGRAPH AM3 TIME","LS GREEDY AM1 SCORE","LS GREEDY AM2 SCORE","LS GREEDY AM3 SCORE","LS INTGRAPH AM1 SCORE","LS INTGRAPH AM2 SCORE","LS INTGRAPH AM3 SCORE","LS GREEDY AM1 TIME","LS GREEDY AM2 TIME","LS GREEDY AM3 TIME","LS INTGRAPH AM1 TIME","LS INTGRAPH AM2 TIME","LS INTGRAPH AM3 TIME","PLS AM1 SCORE","PLS AM2 SCORE","PLS AM3 SCORE","PLS AM1 TIME","PLS AM2 TIME","PLS AM3 TIME","CLIQUE AM1 BOUND","CLIQUE AM2 BOUND","CLIQUE AM3 BOUND","CLIQUE AM1 TIME","CLIQUE AM2 TIME","CLIQUE AM3 TIME","LAGRANGIAN AM1 BOUND","LAGRANGIAN AM2 BOUND","LAGRANGIAN AM3 BOUND","LAGRANGIAN AM1 TIME","LAGRANGIAN AM2 TIME","LAGRANGIAN AM3 TIME","PORTFOLIO AM1 SCORE","PORTFOLIO AM2 SCORE","PORTFOLIO AM3 SCORE","PORTFOLIO AM1 BOUND","PORTFOLIO AM2 BOUND","PORTFOLIO AM3 BOUND","PORTFOLIO AM1 WINNER","PORTFOLIO AM2 WINNER","PORTFOLIO AM3 WINNER","PORTFOLIO AM1 WIN TIME","PORTFOLIO AM2 WIN TIME","PORTFOLIO AM3 WIN TIME","PORTFOLIO AM1 TIME","PORTFOLIO AM2 TIME","PORTFOLIO AM3 TIME","ROTATIONAL CONFLICT TIME","ZOOMING CONFLICT TIME","PATH CREATION TIME","INTERPOLATION TIME","GRAPH AM1 TIME","GRAPH AM2 TIME","GRAPH AM3 TIME","NUMBER OF CONFLICTS","NUMBER OF VISIBILITIES","TRAJECTORY LENGTH","TRAJECTORY SIZE","VISIBILITIES LENGTH","CONFLICTS LENGTH","AM1 GRAPH NODES","AM1 GRAPH EDGES","AM2 GRAPH NODES","AM2 GRAPH EDGES","AM3 GRAPH NODES","AM3 GRAPH EDGES"]
 }
-LATEST = 6
+LATEST = 12
 UNAVAILABLE = -3
 
 def read_in_version(version_id, row):
@@ -36,11 +36,17 @@ SOURCES += main.cpp\
     cli/clirunner.cpp \
     tests/conflicttest.cpp \
     heuristics/greedyheuristic.cpp \
+    heuristics/parallelgreedyheuristic.cpp \
     ilp/adapter.cpp \
+    ilp/Coarsening.cpp \
+    ilp/Components.cpp \
     ilp/Conflict.cpp \
     ilp/ILP.cpp \
     ilp/Instance.cpp \
     ilp/Intervals.cpp \
+    ilp/MIP.cpp \
+    ilp/RollingHorizon.cpp \
+    ilp/Scheduler.cpp \
     cli/evaluator.cpp \
     map/sizecomputer.cpp \
     conflicts/conflictgraph.cpp \
@@ -50,9 +56,15 @@ SOURCES += main.cpp\
     util/setrtree.cpp \
     heuristics/intervalgraphheuristic.cpp \
     heuristics/utils.cpp \
+    heuristics/plsheuristic.cpp \
+    heuristics/localsearch.cpp \
+    heuristics/branchandreduce.cpp \
+    heuristics/portfolio.cpp \
     checks/resultconsistencychecker.cpp \
     checks/nooverlapschecker.cpp \
     util/debugging.cpp \
+    bounds/cliquecoverbound.cpp \
+    bounds/lagrangianbound.cpp \
     clipper.cpp
 
 HEADERS  += ui/labelrotation.h \
@@ -81,12 +93,18 @@ HEADERS  += ui/labelrotation.h \
     heuristics/heuristic.h \
     util/setrtree.h \
     heuristics/greedyheuristic.h \
+    heuristics/parallelgreedyheuristic.h \
     ilp/adapter.h \
+    ilp/Coarsening.h \
+    ilp/Components.h \
     util/clock.h \
     ilp/Conflict.h \
     ilp/ILP.h \
     ilp/Instance.h \
     ilp/Intervals.h \
+    ilp/MIP.h \
+    ilp/RollingHorizon.h \
+    ilp/Scheduler.h \
     cli/evaluator.h \
     map/sizecomputer.h \
     conflicts/conflictgraph.h \
@@ -94,15 +112,24 @@ HEADERS  += ui/labelrotation.h \
     map/trajectoryfactory.h \
     heuristics/intervalgraphheuristic.h \
     heuristics/utils.h \
+    heuristics/plsheuristic.h \
+    heuristics/localsearch.h \
+    heuristics/branchandreduce.h \
+    heuristics/portfolio.h \
     checks/resultconsistencychecker.h \
     checks/nooverlapschecker.h \
     util/debugging.h \
+    util/indexedheap.h \
+    util/segmenttree.h \
+    bounds/upperbound.h \
+    bounds/cliquecoverbound.h \
+    bounds/lagrangianbound.h \
     clipper.h
 
 FORMS    += ui/labelrotation.ui \
     ui/poifilterchooser.ui
 
-INCLUDEPATH += "contrib/osmium/include" "/home/benjamin/programs/gurobi605/linux64/include/" $$(GUROBI_HOME)/include
+INCLUDEPATH += "contrib/osmium/include"
 
 
 !exists( "/usr/include/boost/geometry/algorithms/dispatch/disjoint.hpp" ) {
@@ -111,7 +138,30 @@ INCLUDEPATH += "contrib/osmium/include" "/home/benjamin/programs/gurobi605/linux
 
 QMAKE_CXXFLAGS += -std=c++11 -fext-numeric-literals
 
-LIBS += -lexpat -lCGAL -lgmp -lmpfr -lboost_thread -lboost_system -lboost_program_options -L$$(GUROBI_HOME)/lib -lgurobi_c++ -lgurobi75
+LIBS += -lexpat -lCGAL -lgmp -lmpfr -lboost_thread -lboost_system -lboost_program_options
+
+# The MIP solvers to build the ILP with. With both, Gurobi is the default (see --mip-solver).
+# Override with e.g. "qmake MIP_BACKENDS=highs" on machines without a Gurobi licence.
+isEmpty(MIP_BACKENDS) {
+  MIP_BACKENDS = gurobi
+}
+
+contains(MIP_BACKENDS, gurobi) {
+  SOURCES += ilp/GurobiSolver.cpp
+  HEADERS += ilp/GurobiSolver.h
+  DEFINES += WITH_GUROBI
+  INCLUDEPATH += "/home/benjamin/programs/gurobi605/linux64/include/" $$(GUROBI_HOME)/include
+  LIBS += -L$$(GUROBI_HOME)/lib -lgurobi_c++ -lgurobi75
+}
+
+# HiGHS (https://highs.dev) is built from source and installed to HIGHS_HOME
+contains(MIP_BACKENDS, highs) {
+  SOURCES += ilp/HighsSolver.cpp
+  HEADERS += ilp/HighsSolver.h
+  DEFINES += WITH_HIGHS
+  INCLUDEPATH += $$(HIGHS_HOME)/include/highs
+  LIBS += -L$$(HIGHS_HOME)/lib -lhighs
+}
 
 
 #QMAKE_CFLAGS += -pg
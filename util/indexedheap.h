@@ -0,0 +1,167 @@
+#ifndef INDEXEDHEAP_H
+#define INDEXEDHEAP_H
+
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <cassert>
+#include <functional>
+
+/**
+ * An addressable d-ary max-heap over the dense item ids 0 .. n-1 (e.g. the vertex
+ * descriptors of a vecS boost graph). Every item can be in the heap at most once.
+ * Besides push / pop, the key of an item that is still in the heap can be changed
+ * in O(d log_d n), and items can be removed from the middle of the heap.
+ *
+ * Ties between equal keys are broken in favor of the smaller id, which keeps the
+ * order in which items are popped deterministic.
+ */
+template<class Key, unsigned int Arity = 4, class Compare = std::less<Key>>
+class IndexedHeap {
+public:
+  IndexedHeap(size_t n = 0) {
+    this->reset(n);
+  }
+
+  /* Empties the heap and makes room for the ids 0 .. n-1 */
+  void reset(size_t n) {
+    this->heap.clear();
+    this->heap.reserve(n);
+    this->keys.assign(n, Key());
+    this->position.assign(n, NOT_IN_HEAP);
+  }
+
+  bool empty() const {
+    return this->heap.empty();
+  }
+
+  size_t size() const {
+    return this->heap.size();
+  }
+
+  bool contains(size_t id) const {
+    return this->position[id] != NOT_IN_HEAP;
+  }
+
+  const Key &key(size_t id) const {
+    return this->keys[id];
+  }
+
+  size_t top() const {
+    assert(!this->empty());
+    return this->heap.front();
+  }
+
+  const Key &topKey() const {
+    return this->keys[this->top()];
+  }
+
+  void push(size_t id, Key key) {
+    assert(!this->contains(id));
+    this->keys[id] = key;
+    this->position[id] = this->heap.size();
+    this->heap.push_back(id);
+    this->siftUp(this->heap.size() - 1);
+  }
+
+  size_t pop() {
+    size_t id = this->top();
+    this->remove(id);
+    return id;
+  }
+
+  void remove(size_t id) {
+    assert(this->contains(id));
+    size_t pos = this->position[id];
+    size_t last = this->heap.back();
+    this->heap.pop_back();
+    this->position[id] = NOT_IN_HEAP;
+
+    if (last != id) {
+      this->heap[pos] = last;
+      this->position[last] = pos;
+      this->restore(pos);
+    }
+  }
+
+  /* Changes the key of an item in the heap. Works in both directions. */
+  void update(size_t id, Key key) {
+    assert(this->contains(id));
+    this->keys[id] = key;
+    this->restore(this->position[id]);
+  }
+
+private:
+  static const size_t NOT_IN_HEAP = static_cast<size_t>(-1);
+
+  /* true if item a should be closer to the top than item b */
+  bool before(size_t a, size_t b) const {
+    if (this->compare(this->keys[b], this->keys[a])) {
+      return true;
+    }
+    if (this->compare(this->keys[a], this->keys[b])) {
+      return false;
+    }
+    return a < b;
+  }
+
+  void place(size_t pos, size_t id) {
+    this->heap[pos] = id;
+    this->position[id] = pos;
+  }
+
+  void restore(size_t pos) {
+    if ((pos > 0) && this->before(this->heap[pos], this->heap[(pos - 1) / Arity])) {
+      this->siftUp(pos);
+    } else {
+      this->siftDown(pos);
+    }
+  }
+
+  void siftUp(size_t pos) {
+    size_t id = this->heap[pos];
+    while (pos > 0) {
+      size_t parent = (pos - 1) / Arity;
+      if (!this->before(id, this->heap[parent])) {
+        break;
+      }
+      this->place(pos, this->heap[parent]);
+      pos = parent;
+    }
+    this->place(pos, id);
+  }
+
+  void siftDown(size_t pos) {
+    size_t id = this->heap[pos];
+    size_t n = this->heap.size();
+    while (true) {
+      size_t first = pos * Arity + 1;
+      if (first >= n) {
+        break;
+      }
+      size_t best = first;
+      size_t end = std::min(first + Arity, n);
+      for (size_t child = first + 1; child < end; ++child) {
+        if (this->before(this->heap[child], this->heap[best])) {
+          best = child;
+        }
+      }
+      if (!this->before(this->heap[best], id)) {
+        break;
+      }
+      this->place(pos, this->heap[best]);
+      pos = best;
+    }
+    this->place(pos, id);
+  }
+
+  std::vector<size_t> heap;
+  std::vector<size_t> position;
+  std::vector<Key> keys;
+  Compare compare;
+};
+
+template<class Key, unsigned int Arity, class Compare>
+const size_t IndexedHeap<Key, Arity, Compare>::NOT_IN_HEAP;
+
+#endif // INDEXEDHEAP_H
@@ -0,0 +1,238 @@
+#ifndef SEGMENTTREE_H
+#define SEGMENTTREE_H
+
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <cassert>
+#include <limits>
+
+/**
+ * Counts how many closed intervals overlap at every point of the real line, restricted
+ * to a fixed set of coordinates given up front (usually all candidate interval endpoints).
+ *
+ * The coordinates c_0 < c_1 < ... < c_{m-1} are compressed into 2m - 1 elementary slots:
+ * slot 2i is the point c_i, slot 2i + 1 is the open gap (c_i, c_{i+1}). A closed interval
+ * [c_i, c_j] thus covers the slots 2i .. 2j, which makes touching intervals overlap in
+ * their common endpoint, just like boost::icl does for closed intervals.
+ *
+ * With open intervals, (c_i, c_j) covers the slots 2i + 1 .. 2j - 1 instead, and touching
+ * intervals do not overlap.
+ *
+ * Both adding an interval and querying the maximum overlap within an interval take
+ * O(log m) and do not allocate. So does finding the first (or last) point from which on
+ * (or up to which) the count reaches a given value.
+ */
+class OverlapSegmentTree {
+public:
+  OverlapSegmentTree() : slots(0), open(false) {}
+
+  OverlapSegmentTree(std::vector<double> coordinates, bool open = false) {
+    this->reset(std::move(coordinates), open);
+  }
+
+  /* Clears all counts and replaces the coordinates. */
+  void reset(std::vector<double> coordinates, bool open = false) {
+    this->open = open;
+    std::sort(coordinates.begin(), coordinates.end());
+    coordinates.erase(std::unique(coordinates.begin(), coordinates.end()), coordinates.end());
+    this->coords = std::move(coordinates);
+
+    this->slots = this->coords.empty() ? 0 : 2 * this->coords.size() - 1;
+    size_t size = 1;
+    while (size < this->slots) {
+      size *= 2;
+    }
+    this->maxima.assign(2 * size, 0);
+    this->pending.assign(2 * size, 0);
+  }
+
+  /* Adds delta to the count of every point in [from, to] */
+  void add(double from, double to, int delta) {
+    if (this->slots == 0) {
+      return;
+    }
+    size_t first, last;
+    if (this->toSlots(from, to, first, last)) {
+      this->add(1, 0, this->slots - 1, first, last, delta);
+    }
+  }
+
+  /* Returns the maximum count of any point in [from, to] */
+  int max(double from, double to) const {
+    if (this->slots == 0) {
+      return 0;
+    }
+    size_t first, last;
+    if (!this->toSlots(from, to, first, last)) {
+      return 0;
+    }
+    return this->max(1, 0, this->slots - 1, first, last);
+  }
+
+  /* Returns the maximum count of any point */
+  int max() const {
+    return this->slots == 0 ? 0 : this->maxima[1];
+  }
+
+  /* Returns the smallest x in [from, to] such that the count of the points just right of x
+   * is at least value, or to if there is none */
+  double firstReaching(double from, double to, int value) const {
+    size_t first, last;
+    if ((this->slots == 0) || !this->slotsBetween(from, to, first, last)) {
+      return to;
+    }
+    size_t slot = this->findFirst(1, 0, this->slots - 1, first, last, value);
+    if (slot == this->slots) {
+      return to;
+    }
+    // the left end of the slot
+    return std::min(std::max(from, this->coords[slot / 2]), to);
+  }
+
+  /* Returns the largest x in [to, from] such that the count of the points just left of x
+   * is at least value, or to if there is none */
+  double lastReaching(double from, double to, int value) const {
+    size_t first, last;
+    if ((this->slots == 0) || !this->slotsBetween(to, from, first, last)) {
+      return to;
+    }
+    size_t slot = this->findLast(1, 0, this->slots - 1, first, last, value);
+    if (slot == this->slots) {
+      return to;
+    }
+    // the right end of the slot
+    return std::max(std::min(from, this->coords[(slot + 1) / 2]), to);
+  }
+
+private:
+  /* Maps [from, to] to the smallest range of slots covering it. Points between two
+   * coordinates fall into the gap slot between them. */
+  bool toSlots(double from, double to, size_t &first, size_t &last) const {
+    assert(from <= to);
+    auto fit = std::lower_bound(this->coords.begin(), this->coords.end(), from);
+    if (fit == this->coords.end()) {
+      return false;
+    }
+    size_t i = fit - this->coords.begin();
+    if (*fit == from) {
+      first = this->open ? 2 * i + 1 : 2 * i;
+    } else if (i == 0) {
+      first = 0;
+    } else {
+      first = 2 * i - 1;
+    }
+
+    auto lit = std::upper_bound(this->coords.begin(), this->coords.end(), to);
+    if (lit == this->coords.begin()) {
+      return false;
+    }
+    size_t j = (lit - this->coords.begin()) - 1;
+    if (this->open && (this->coords[j] == to)) {
+      if (j == 0) {
+        return false;
+      }
+      last = 2 * j - 1;
+    } else if ((this->coords[j] == to) || (j + 1 == this->coords.size())) {
+      last = 2 * j;
+    } else {
+      last = 2 * j + 1;
+    }
+
+    return first <= last;
+  }
+
+  /* Maps the points strictly between from and to, and those just beyond them, to the slots
+   * containing them: from the one just right of from to the one just left of to. */
+  bool slotsBetween(double from, double to, size_t &first, size_t &last) const {
+    assert(from <= to);
+    size_t i = std::upper_bound(this->coords.begin(), this->coords.end(), from) - this->coords.begin();
+    if (i == this->coords.size()) {
+      return false;
+    }
+    first = (i == 0) ? 0 : 2 * i - 1;
+
+    size_t j = std::lower_bound(this->coords.begin(), this->coords.end(), to) - this->coords.begin();
+    if (j == 0) {
+      return false;
+    }
+    last = (j == this->coords.size()) ? this->slots - 1 : 2 * j - 1;
+
+    return first <= last;
+  }
+
+  /* The first slot in [first, last] whose count is at least value, or slots if there is none.
+   * value does not include the additions made at the ancestors of the node. */
+  size_t findFirst(size_t node, size_t lo, size_t hi, size_t first, size_t last, int value) const {
+    if ((last < lo) || (hi < first) || (this->maxima[node] < value)) {
+      return this->slots;
+    }
+    if (lo == hi) {
+      return lo;
+    }
+    size_t mid = (lo + hi) / 2;
+    size_t slot = this->findFirst(2 * node, lo, mid, first, last, value - this->pending[node]);
+    if (slot == this->slots) {
+      slot = this->findFirst(2 * node + 1, mid + 1, hi, first, last, value - this->pending[node]);
+    }
+    return slot;
+  }
+
+  /* The last slot in [first, last] whose count is at least value, or slots if there is none */
+  size_t findLast(size_t node, size_t lo, size_t hi, size_t first, size_t last, int value) const {
+    if ((last < lo) || (hi < first) || (this->maxima[node] < value)) {
+      return this->slots;
+    }
+    if (lo == hi) {
+      return lo;
+    }
+    size_t mid = (lo + hi) / 2;
+    size_t slot = this->findLast(2 * node + 1, mid + 1, hi, first, last, value - this->pending[node]);
+    if (slot == this->slots) {
+      slot = this->findLast(2 * node, lo, mid, first, last, value - this->pending[node]);
+    }
+    return slot;
+  }
+
+  void add(size_t node, size_t lo, size_t hi, size_t first, size_t last, int delta) {
+    if ((first <= lo) && (hi <= last)) {
+      this->maxima[node] += delta;
+      this->pending[node] += delta;
+      return;
+    }
+    size_t mid = (lo + hi) / 2;
+    if (first <= mid) {
+      this->add(2 * node, lo, mid, first, last, delta);
+    }
+    if (last > mid) {
+      this->add(2 * node + 1, mid + 1, hi, first, last, delta);
+    }
+    this->maxima[node] = std::max(this->maxima[2 * node], this->maxima[2 * node + 1]) + this->pending[node];
+  }
+
+  int max(size_t node, size_t lo, size_t hi, size_t first, size_t last) const {
+    if ((first <= lo) && (hi <= last)) {
+      return this->maxima[node];
+    }
+    size_t mid = (lo + hi) / 2;
+    int result = std::numeric_limits<int>::min();
+    if (first <= mid) {
+      result = std::max(result, this->max(2 * node, lo, mid, first, last));
+    }
+    if (last > mid) {
+      result = std::max(result, this->max(2 * node + 1, mid + 1, hi, first, last));
+    }
+    return result + this->pending[node];
+  }
+
+  std::vector<double> coords;
+  size_t slots;
+  bool open;
+
+  /* maxima[node] is the maximum within the node's range, including all additions
+   * made at the node itself (pending[node]) but none made at its ancestors. */
+  std::vector<int> maxima;
+  std::vector<int> pending;
+};
+
+#endif // SEGMENTTREE_H